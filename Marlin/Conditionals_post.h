@@ -891,6 +891,8 @@
 
 #define HAS_AUTO_REPORTING (ENABLED(AUTO_REPORT_TEMPERATURES) || ENABLED(AUTO_REPORT_SD_STATUS))
 
+#define HAS_SD_WRITE_BUFFER (ENABLED(BINARY_FILE_UPLOAD) || ENABLED(SD_LOG_BUFFER))
+
 /**
  * This setting is also used by M109 when trying to calculate
  * a ballpark safe margin to prevent wait-forever situation.
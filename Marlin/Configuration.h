@@ -572,6 +572,12 @@
 // This will remove the need to poll the interrupt pins, saving many CPU cycles.
 //#define ENDSTOP_INTERRUPTS_FEATURE
 
+// Read only the endstops that can stop the current move: those in the direction
+// of travel while endstops or the probe are enabled, and none otherwise. Endstop
+// pins that can raise an interrupt get one and are not polled at all. M119
+// reports how many of the 1kHz endstop polls were skipped.
+//#define ENDSTOP_SCAN_MASK
+
 /**
  * Endstop Noise Filter
  *
@@ -814,6 +820,19 @@
 //   Set to 3 or more for slow probes, averaging the results.
 //#define MULTIPLE_PROBING 2
 
+/**
+ * Scan the G29 mesh without stopping between points. After the first
+ * point the lift, the travel to the next point and the dive are queued
+ * back to back, each later point is a single slow touch, and the lift
+ * is only as high as the last change in bed height needs, plus the
+ * clearance below (up to Z_CLEARANCE_BETWEEN_PROBES).
+ * The scan time per point is reported when G29 finishes.
+ */
+//#define PROBE_SCAN
+#if ENABLED(PROBE_SCAN)
+  #define PROBE_SCAN_CLEARANCE 1.0  // (mm) Minimum lift between scanned points
+#endif
+
 /**
  * Z probes require clearance when deploying, stowing, and moving between
  * probe points to avoid hitting the bed and other hardware.
@@ -1088,6 +1107,10 @@
   //#define UBL_Z_RAISE_WHEN_OFF_MESH 2.5 // When the nozzle is off the mesh, this value is used
                                           // as the Z-Height correction value.
 
+  // Cache the bilinear coefficients of each mesh cell so leveled moves are split and
+  // corrected with multiply-adds only. Uses (GRID_MAX_POINTS_X-1)*(GRID_MAX_POINTS_Y-1)*16 bytes of RAM.
+  //#define UBL_CELL_GRADIENTS
+
 #elif ENABLED(MESH_BED_LEVELING)
 
   //===========================================================================
@@ -1100,6 +1123,11 @@
 
   //#define MESH_G28_REST_ORIGIN // After homing all axes ('G28' or 'G28 XYZ') rest Z at Z_MIN_POS
 
+  // Scale the mesh by the fade factor once per layer (Z height) instead of for every
+  // segment. Leveled moves then interpolate without any fade math. Uses 4 bytes of RAM
+  // per mesh point.
+  //#define MESH_FADE_PER_LAYER
+
 #endif // BED_LEVELING
 
 /**
@@ -1248,6 +1276,23 @@
 //#define DISABLE_M503    // Saves ~2700 bytes of PROGMEM. Disable for release!
 #define EEPROM_CHITCHAT   // Give feedback on EEPROM commands. Disable to save PROGMEM.
 
+//
+// Settings Profiles
+//
+// Store per-material overrides (jerk, accelerations, max accelerations,
+// Linear Advance K, PID and firmware retraction) in EEPROM slots after
+// the base settings. Each slot only holds the values that differ from
+// the base settings saved with M500.
+//
+// M506 P<slot> - Store the current values as a profile. Add C to clear it.
+// M507 P<slot> - Load a profile. Omit P to go back to the base settings.
+//
+//#define SETTINGS_PROFILES
+#if ENABLED(SETTINGS_PROFILES)
+  #define SETTINGS_PROFILE_SLOTS      4 // Number of profile slots
+  #define SETTINGS_PROFILE_MAX_DELTAS 16 // Overrides per slot (5 bytes each)
+#endif
+
 //
 // Host Keepalive
 //
@@ -1466,6 +1511,17 @@
  */
 //#define SD_CHECK_AND_RETRY
 
+/**
+ * SD CARD: STREAMING READS
+ *
+ * Read the print file with a multiple block read (CMD18) that stays open
+ * between blocks, instead of one command per 512 byte block. Files stored in
+ * contiguous clusters also skip the FAT lookup at each cluster boundary.
+ * Any other card access ends the stream, and a failed read falls back to a
+ * single block read.
+ */
+//#define SD_STREAMING_READS
+
 /**
  * LCD Menu Items
  *
@@ -446,6 +446,51 @@
 // if unwanted behavior is observed on a user's machine when running at very slow speeds.
 #define MINIMUM_PLANNER_SPEED 0.05 // (mm/sec)
 
+// Apply feedrate percentage changes (M220, LCD, TFT) to moves already in the
+// planner buffer instead of only to new moves. Queued G0-G3/G5 moves are
+// rescaled and replanned in place, so a speed change takes effect right away.
+// Junctions never exceed their originally planned speed. Uses 14 bytes of SRAM
+// per BLOCK_BUFFER_SIZE entry.
+//#define LIVE_FEEDRATE_OVERRIDE
+
+// Run the housekeeping in idle() (TFT, LCD, host keepalive, SD logging, auto
+// reports) by period and time budget instead of all of it on every call. Heater
+// and inactivity management still run on every call. While a print is running
+// low on planner blocks the tasks are put off until their deadline, so new moves
+// get queued first. M102 reports the run counts and times of each task.
+//#define IDLE_TASK_SCHEDULER
+#if ENABLED(IDLE_TASK_SCHEDULER)
+  #define IDLE_TIME_BUDGET_US 2000  // (µs) Start no more tasks once idle() has taken this long
+  #define IDLE_PLANNER_LOW       4  // Put tasks off while fewer blocks than this are queued
+#endif
+
+// Count the times the planner runs out of moves during a print job, which
+// stops the machine between segments. M103 reports how often and for how long,
+// and the command that came next.
+//#define PLANNER_STARVATION_REPORT
+
+// Merge runs of short, nearly collinear G0/G1 moves into one move before they
+// are leveled and buffered. Longer moves give the planner more lookahead, so
+// finely tessellated curves don't slow down to a stop and blob.
+//#define SEGMENT_COALESCING
+#if ENABLED(SEGMENT_COALESCING)
+  #define COALESCE_SEGMENT_MM   0.5   // (mm) Merge XY moves shorter than this
+  #define COALESCE_DEVIATION_MM 0.01  // (mm) Furthest a dropped point may be from the merged move
+  #define COALESCE_MAX_POINTS   8     // Most points one merged move may drop
+#endif
+
+// Treat a run of short XY moves that follows a curve as that curve. Where the arc
+// through a junction and its neighbouring points stays within the blending tolerance
+// of both moves, the junction may be taken at the speed of that arc instead of the
+// slower corner speed. G64 P<mm> sets the tolerance, G61 turns blending off.
+// With SEGMENT_COALESCING, G64 Q<mm> also sets the merge deviation.
+// Requires JUNCTION_DEVIATION. Classic jerk limits each axis at a junction, not the curve.
+//#define PATH_BLENDING
+#if ENABLED(PATH_BLENDING)
+  #define BLEND_TOLERANCE_MM  0.02  // (mm) Default G64 P - Furthest the path may be from the arc
+  #define BLEND_SEGMENT_MM    1.0   // (mm) Only blend the junctions of XY moves shorter than this
+#endif
+
 //
 // Use Junction Deviation instead of traditional Jerk Limiting
 //
@@ -462,6 +507,41 @@
  */
 //#define ADAPTIVE_STEP_SMOOTHING
 
+/**
+ * Fractional Multistepping picks the steps per Stepper ISR from a finer ladder
+ * than powers of 2 (1, 1.25, 1.5, 1.75, 2, 2.5, 3...) and alternates whole counts
+ * to make up the fraction. At each speed threshold the ISR rate changes by at most
+ * 1/2^MULTISTEP_FRACTION_BITS instead of halving, so the pulse spacing stays even.
+ * buildroot/share/scripts/multistepBench.py compares pulse interval variance.
+ */
+//#define FRACTIONAL_MULTISTEPPING
+#if ENABLED(FRACTIONAL_MULTISTEPPING)
+  #define MULTISTEP_FRACTION_BITS 2  // 1, 2 or 3. More bits give smaller jumps.
+#endif
+
+/**
+ * Input Shaping cancels the ringing of the X and Y axes at their resonant
+ * frequency so higher accelerations can be used without ghosting. Each step
+ * is split into two or three weighted impulses, spaced so their vibrations
+ * cancel out. Print a ringing tower and divide the speed by the ripple
+ * spacing to find each frequency, then set it with M593.
+ *
+ * Shapers: 0 = ZV (shortest), 1 = MZV, 2 = EI (most robust to a wrong frequency)
+ *
+ * Moves made with endstops enabled (homing) are not shaped.
+ * buildroot/share/scripts/inputShapingSim.py plots the residual vibration.
+ */
+//#define INPUT_SHAPING
+#if ENABLED(INPUT_SHAPING)
+  #define SHAPING_TYPE        1     // Shaper to use, as above
+  #define SHAPING_FREQ_X      40.0  // (Hz) Resonant frequency of X. Set 0 to leave X unshaped.
+  #define SHAPING_FREQ_Y      40.0  // (Hz) Resonant frequency of Y. Set 0 to leave Y unshaped.
+  #define SHAPING_ZETA_X      0.1   // Damping ratio of X (0.0 - 0.5)
+  #define SHAPING_ZETA_Y      0.1   // Damping ratio of Y (0.0 - 0.5)
+  #define SHAPING_BUFFER_SIZE 128   // Step history per axis, 2 bytes each. Power of 2, max 256.
+                                    // 128 allows frequencies down to about 16Hz.
+#endif
+
 // Microstep setting (Only functional when stepper driver microstep pins are connected to MCU.
 #define MICROSTEP_MODES { 16, 16, 16, 16, 16 } // [1,2,4,8,16]
 
@@ -529,6 +609,11 @@
 // Scroll a longer status message into view
 //#define STATUS_MESSAGE_SCROLLING
 
+// Redraw only the Status Screen fields that changed (temperatures, position,
+// progress, message) and skip the refresh when nothing did. Graphical displays
+// only send the pages holding the changed fields. M251 reports the drawing time.
+//#define LCD_DIRTY_REGIONS
+
 // On the Info Screen, display XY with one decimal place when possible
 //#define LCD_DECIMAL_SMALL_XY
 
@@ -585,6 +670,48 @@
   // Add an option in the menu to run all auto#.g files
   //#define MENU_ADDAUTOSTART
 
+  /**
+   * Map the print file's clusters when it is opened, so that reading and
+   * seeking (M26, power-loss resume) never have to walk the FAT. Files
+   * split into more pieces than the map holds fall back to the FAT.
+   */
+  //#define SD_EXTENT_MAP
+  #if ENABLED(SD_EXTENT_MAP)
+    #define SD_EXTENT_MAP_SIZE 16   // Maximum runs of contiguous clusters (2-255). Costs 8 bytes each.
+  #endif
+
+  /**
+   * Binary File Upload
+   *
+   * Send 'M28 B1 [S<bytes>] <filename>' to receive a file as CRC-checked
+   * binary packets instead of one G-code line at a time. Packets are
+   * acknowledged as they arrive, so the host can keep several in flight,
+   * and the data is written to the card in whole 512 byte sectors.
+   * With S the file is pre-allocated as one contiguous run of clusters.
+   *
+   * See get_binary_upload_packets() in Marlin_main.cpp for the protocol.
+   * Costs 512 bytes of SRAM plus the chunk size.
+   */
+  //#define BINARY_FILE_UPLOAD
+  #if ENABLED(BINARY_FILE_UPLOAD)
+    #define BINARY_UPLOAD_CHUNK_SIZE  64    // Maximum data bytes per packet. Must leave room for 7 framing bytes in RX_BUFFER_SIZE.
+    #define BINARY_UPLOAD_TIMEOUT  10000    // (ms) Abandon the upload after this long without data
+  #endif
+
+  /**
+   * Buffer M928 logging in SRAM and write it to the card in whole sectors,
+   * instead of writing every logged command through the block cache.
+   * The partial last sector is written and the file synced once logging
+   * has been quiet for SD_LOG_FLUSH_DELAY, or at most SD_LOG_SYNC_INTERVAL
+   * after the first unsynced line while logging continues.
+   * Costs 512 bytes of SRAM, shared with BINARY_FILE_UPLOAD.
+   */
+  //#define SD_LOG_BUFFER
+  #if ENABLED(SD_LOG_BUFFER)
+    #define SD_LOG_FLUSH_DELAY    1000   // (ms) Quiet time before the log is written out
+    #define SD_LOG_SYNC_INTERVAL 30000   // (ms) Longest time logged lines wait to be synced
+  #endif
+
   /**
    * Continue after Power-Loss (Creality3D)
    *
@@ -778,6 +905,29 @@
 #if ENABLED(LIN_ADVANCE)
   #define LIN_ADVANCE_K 0  // Unit: mm compression per 1mm/s extruder speed
   //#define LA_DEBUG          // If enabled, this will generate debug information output over USB.
+  //#define LA_SINGLE_ISR     // Output the advance steps with the other E steps in the Stepper ISR, following
+                              // a per-block profile from the planner, instead of in a separate E ISR.
+
+  /**
+   * G25 Linear Advance calibration pattern
+   *
+   * Print one slow-fast-slow line per K value, echoing the K and duration of each line.
+   * Use buildroot/share/scripts/laCalibration.py to pick K from the printed lines.
+   */
+  //#define LA_CALIBRATION_PATTERN
+  #if ENABLED(LA_CALIBRATION_PATTERN)
+    #define LA_CAL_K_START          0.0   // Default K of the first line
+    #define LA_CAL_K_END            1.0   // Default K of the last line
+    #define LA_CAL_K_STEP           0.1   // Default K increment between lines
+    #define LA_CAL_MAX_LINES         40   // Limit the pattern size
+    #define LA_CAL_SLOW_FEEDRATE     20   // (mm/s) Default speed of the slow parts of a line
+    #define LA_CAL_FAST_FEEDRATE     80   // (mm/s) Default speed of the fast part of a line
+    #define LA_CAL_SLOW_LENGTH       20   // (mm) Length of each slow part
+    #define LA_CAL_FAST_LENGTH       40   // (mm) Length of the fast part
+    #define LA_CAL_LINE_SPACING       5   // (mm) Distance between two lines
+    #define LA_CAL_HOTEND_TEMP      200   // (°C) Default nozzle temperature
+    #define LA_CAL_BED_TEMP          60   // (°C) Default bed temperature
+  #endif
 #endif
 
 // @section leveling
@@ -882,6 +1032,16 @@
 #define MAX_CMD_SIZE 128
 #define BUFSIZE 8
 
+// Queue commands already decoded (letter, code, parameter flags and fixed-point
+// values) in records sized to fit, instead of BUFSIZE strings of MAX_CMD_SIZE.
+// Commands are parsed once when queued, so no strtod is done when they run,
+// and a typical G1 takes about 30 bytes. Raise BUFSIZE (up to 255) to fill the pool.
+// Requires FASTER_GCODE_PARSER.
+//#define BINARY_COMMAND_QUEUE
+#if ENABLED(BINARY_COMMAND_QUEUE)
+  #define BINARY_QUEUE_BYTES 1024 // SRAM for queued commands. 600 or more.
+#endif
+
 // Transmission to Host Buffer Size
 // To save 386 bytes of PROGMEM (and TX_BUFFER_SIZE+3 bytes of RAM) set to 0.
 // To buffer a simple "ok" you need 4 bytes.
@@ -1161,6 +1321,8 @@
    * M911 - Report stepper driver overtemperature pre-warn condition.
    * M912 - Clear stepper driver overtemperature pre-warn condition flag.
    * M122 S0/1 - Report driver parameters (Requires TMC_DEBUG)
+   * M122 C - Report the last driver readings (Requires TMC_ASYNC_MONITOR)
+   * M122 L - Report the stallGuard load log, R to clear it (Requires STALLGUARD_LOAD_LOG)
    */
   //#define MONITOR_DRIVER_STATUS
 
@@ -1168,6 +1330,35 @@
     #define CURRENT_STEP_DOWN     50  // [mA]
     #define REPORT_CURRENT_CHANGE
     #define STOP_ON_ERROR
+
+    /**
+     * Read one driver per idle loop instead of all of them at once, so a
+     * slow UART read never holds up the planner for more than one driver.
+     * SPI drivers are quick to read and are read together in one step.
+     * The last readings are cached and shown by M122 C.
+     */
+    //#define TMC_ASYNC_MONITOR
+    #if ENABLED(TMC_ASYNC_MONITOR)
+      #define MONITOR_DRIVER_STATUS_INTERVAL_MS 500 // (ms) Time between the starts of two sweeps
+
+      /**
+       * Log the stallGuard2 load of the TMC2130 axes during a print, from the
+       * monitor readings. Keeps a histogram of SG_RESULT per axis and the last
+       * stall flags, which hint at skipped steps, with their layer and position.
+       * The log is cleared when a print starts. stallGuard2 only works in
+       * spreadCycle, so use it without STEALTHCHOP or above HYBRID_THRESHOLD.
+       *
+       * The stall flag (DRV_STATUS bit 24) isn't latched. It's only seen if
+       * the motor is still stalled when the sweep reads it, so brief stalls
+       * between sweeps are missed. The stall counts are a sample, not a
+       * total. A shorter MONITOR_DRIVER_STATUS_INTERVAL_MS catches more.
+       */
+      //#define STALLGUARD_LOAD_LOG
+      #if ENABLED(STALLGUARD_LOAD_LOG)
+        #define LOAD_LOG_BINS    8  // Histogram bins over SG_RESULT 0-1023 (2, 4, 8, 16 or 32)
+        #define LOAD_LOG_EVENTS  8  // Stall events kept
+      #endif
+    #endif
   #endif
 
   /**
@@ -1337,6 +1528,23 @@
 //#define EXPERIMENTAL_I2CBUS
 #define I2C_SLAVE_ADDRESS  0 // Set a value from 8 to 127 to act as a slave
 
+/**
+ * Interrupt driven TWI (I2C) master
+ *
+ * Run I2C transfers from a queue in the TWI interrupt instead of with the
+ * blocking Wire library, so the bus never holds up the main loop. I2C position
+ * encoders are then read and corrected at a fixed rate from interrupts, while
+ * EXPERIMENTAL_I2CBUS, DAC_STEPPER_CURRENT, DIGIPOT_I2C, PCA9632 and BLINKM
+ * queue their writes. Writes queued together share one bus transaction.
+ * I2C LCDs still need Wire and can't be used with it. Master only.
+ */
+//#define TWI_TRANSACTION_QUEUE
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+  #define TWI_CLOCK_HZ   400000 // (Hz) Bus clock
+  #define TWI_QUEUE_SIZE      8 // Transfers waiting for the bus
+  #define TWI_TIMEOUT_MS     10 // (ms) Reset the bus when a transfer takes longer
+#endif
+
 // @section extras
 
 /**
@@ -1456,6 +1664,18 @@
    * M200 D0 to disable, M200 Dn to set a new diameter.
    */
   //#define VOLUMETRIC_DEFAULT_ON
+
+  /**
+   * Volumetric extrusion limit
+   * Slow down the printing moves that would extrude faster than the hotend
+   * can melt. Other moves keep their speed. E-only moves are not limited.
+   *
+   * M200 L<mm³/s> to set the limit of an extruder, M200 L0 to disable.
+   */
+  //#define VOLUMETRIC_EXTRUDER_LIMIT
+  #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+    #define DEFAULT_VOLUMETRIC_EXTRUDER_LIMIT 12.00 // (mm³/s) Maximum volumetric flow of each extruder. 0 = No limit.
+  #endif
 #endif
 
 /**
@@ -1481,6 +1701,14 @@
  */
 #define FASTER_GCODE_PARSER
 
+/**
+ * Tokenize serial commands one character at a time as they arrive.
+ * The line number, checksum and parameter offsets are ready when the
+ * line ends, so the parser doesn't scan the line again.
+ * Uses 35 bytes of SRAM per BUFSIZE entry. Requires FASTER_GCODE_PARSER.
+ */
+//#define SERIAL_LINE_TOKENIZER
+
 /**
  * User-defined menu items that execute custom GCode
  */
@@ -1597,12 +1825,23 @@
    * Position is checked every time a new command is executed from the buffer but during long moves,
    * this setting determines the minimum update time between checks. A value of 100 works well with
    * error rolling average when attempting to correct only for skips and not for vibration.
+   * With TWI_TRANSACTION_QUEUE the encoders are read from interrupts at exactly this interval.
    */
   #define I2CPE_MIN_UPD_TIME_MS     4                       // (ms) Minimum time between encoder checks.
 
   // Use a rolling average to identify persistant errors that indicate skips, as opposed to vibration and noise.
   #define I2CPE_ERR_ROLLING_AVERAGE
 
+  /**
+   * Error correction with TWI_TRANSACTION_QUEUE. Each reading updates a filtered
+   * error; above the threshold a part of it is corrected with babysteps, up to a
+   * limit per reading so that a bad reading can't throw the axis off. These
+   * replace I2CPE_ERR_ROLLING_AVERAGE, which needs the foreground checks.
+   */
+  #define I2CPE_EC_GAIN             0.5                     // Part of the filtered error corrected per reading (0-1)
+  #define I2CPE_EC_MAX_STEPS        4                       // Most babysteps per axis per reading
+  #define I2CPE_EC_FILTER           2                       // Error smoothing, 0 (none) to 4 (1/16 weight per reading)
+
 #endif // I2C_POSITION_ENCODERS
 
 /**
@@ -0,0 +1,330 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (C) 2016 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Marlin Firmware -- G25 - Linear Advance Calibration Tool
+ */
+
+#include "MarlinConfig.h"
+
+#if ENABLED(LA_CALIBRATION_PATTERN)
+
+  #include "Marlin.h"
+  #include "planner.h"
+  #include "temperature.h"
+  #include "ultralcd.h"
+  #include "parser.h"
+  #include "serial.h"
+
+  #define RETRACTION_LENGTH 1
+  #define PRIME_LENGTH 5
+  #define Z_HOP 0.5
+
+  #define G25_OK false
+  #define G25_ERR true
+
+  /**
+   *   G25 Linear Advance Calibration Tool
+   *
+   *   G25 prints one line per K value, stepping K from the start to the end value. Each line
+   *   is printed slow, then fast, then slow again, so the extrusion must follow two sudden
+   *   speed changes. With K too low the line bulges where it speeds up and thins out where it
+   *   slows down. With K too high it's the other way around. The best K gives a line of even
+   *   width across both speed changes.
+   *
+   *   The K and duration of each line are echoed as they are printed. Keep this log, measure
+   *   or photograph the printed lines and let buildroot/share/scripts/laCalibration.py pick K.
+   *
+   *   A #  Start K     K of the first (front) line. Default LA_CAL_K_START.
+   *
+   *   B #  Bed         Set the Bed Temperature. If not specified, LA_CAL_BED_TEMP will be used.
+   *
+   *   E #  End K       K of the last (back) line. Default LA_CAL_K_END.
+   *
+   *   F #  Filament    Filament diameter. If not specified 1.75mm filament is assumed.
+   *
+   *   H #  Hotend      Set the Nozzle Temperature. If not specified, LA_CAL_HOTEND_TEMP will be used.
+   *
+   *   I #  Increment   K step between two lines. Default LA_CAL_K_STEP.
+   *
+   *   K    Keep-On     Keep the heaters turned on at the end of the command.
+   *
+   *   L #  Layer       Layer height. If not specified .20mm will be used.
+   *
+   *   S #  Nozzle      Nozzle diameter. If not specified, a .4mm nozzle is assumed.
+   *
+   *   U #  Slow        Speed of the slow parts of each line, in mm/s. Default LA_CAL_SLOW_FEEDRATE.
+   *
+   *   V #  Fast        Speed of the fast part of each line, in mm/s. Default LA_CAL_FAST_FEEDRATE.
+   *
+   *   X #  X Coord.    Front-left corner of the pattern. Default is a pattern centered on the bed.
+   *
+   *   Y #  Y Coord.    Front-left corner of the pattern.
+   */
+
+  static float g25_e_per_mm,
+               g25_layer_height,
+               g25_x_pos, g25_y_pos;
+
+  static int16_t g25_bed_temp,
+                 g25_hotend_temp;
+
+  static bool g25_retracted = false; // Track the retracted state of the nozzle so mismatched
+                                     // retracts/recovers won't result in a bad state.
+
+  void G25_move_to(const float &rx, const float &ry, const float &z, const float &e_delta, const float &fr_mm_s) {
+    const float save_feedrate = feedrate_mm_s;
+    feedrate_mm_s = fr_mm_s;
+    destination[X_AXIS] = rx;
+    destination[Y_AXIS] = ry;
+    destination[Z_AXIS] = z;
+    destination[E_CART] = current_position[E_CART] + e_delta;
+    prepare_move_to_destination();
+    feedrate_mm_s = save_feedrate;
+  }
+
+  void G25_retract(const bool retract) {
+    if (retract == g25_retracted) return;
+    g25_retracted = retract;
+    G25_move_to(current_position[X_AXIS], current_position[Y_AXIS], current_position[Z_AXIS],
+                retract ? -(RETRACTION_LENGTH) : RETRACTION_LENGTH, planner.max_feedrate_mm_s[E_AXIS] / 1.5);
+  }
+
+  /**
+   * Travel to a point with the nozzle retracted and raised,
+   * then lower it to the layer height.
+   */
+  void G25_travel_to(const float &rx, const float &ry) {
+    const float travel_feedrate = PLANNER_XY_FEEDRATE() / 2.0;
+    G25_retract(true);
+    G25_move_to(current_position[X_AXIS], current_position[Y_AXIS], g25_layer_height + (Z_HOP), 0, travel_feedrate);
+    G25_move_to(rx, ry, g25_layer_height + (Z_HOP), 0, travel_feedrate);
+    G25_move_to(rx, ry, g25_layer_height, 0, travel_feedrate);
+  }
+
+  void G25_print_to(const float &rx, const float &ry, const float &fr_mm_s) {
+    G25_retract(false);
+    G25_move_to(rx, ry, g25_layer_height, HYPOT(rx - current_position[X_AXIS], ry - current_position[Y_AXIS]) * g25_e_per_mm, fr_mm_s);
+  }
+
+  /**
+   * Turn on the bed and nozzle heat and
+   * wait for them to get up to temperature.
+   */
+  inline bool G25_turn_on_heaters() {
+    millis_t next = millis() + 5000UL;
+
+    #if HAS_HEATED_BED
+      thermalManager.setTargetBed(g25_bed_temp);
+    #endif
+    thermalManager.setTargetHotend(g25_hotend_temp, 0);
+
+    while (ABS(thermalManager.degHotend(0) - g25_hotend_temp) > 3
+      #if HAS_HEATED_BED
+        || (g25_bed_temp && ABS(thermalManager.degBed() - g25_bed_temp) > 3)
+      #endif
+    ) {
+      #if ENABLED(ULTIPANEL)
+        if (is_lcd_clicked()) {
+          lcd_setstatusPGM(PSTR("Leaving G25"), -1);
+          wait_for_release();
+          return G25_ERR;
+        }
+      #endif
+
+      if (ELAPSED(millis(), next)) {
+        next = millis() + 5000UL;
+        thermalManager.print_heaterstates();
+        SERIAL_EOL();
+      }
+      idle();
+      SERIAL_FLUSH(); // Prevent host M105 buffer overrun.
+    }
+
+    return G25_OK;
+  }
+
+  /**
+   * G25: Linear Advance Calibration Pattern generation.
+   *
+   * Parameters:
+   *
+   *  A  Start K
+   *  B  Bed Temperature
+   *  E  End K
+   *  F  Filament diameter
+   *  H  Hotend Temperature
+   *  I  K Increment
+   *  K  Keep heaters on when completed
+   *  L  Layer Height
+   *  S  Nozzle Size (diameter) in mm
+   *  U  Slow speed (mm/s)
+   *  V  Fast speed (mm/s)
+   *  X  X position
+   *  Y  Y position
+   */
+  void gcode_G25() {
+    #if HAS_AXIS_UNHOMED_ERR
+      if (axis_unhomed_error()) return;
+    #endif
+
+    const float k_start = parser.floatval('A', LA_CAL_K_START),
+                k_end = parser.floatval('E', LA_CAL_K_END),
+                k_step = parser.floatval('I', LA_CAL_K_STEP),
+                slow_feedrate = parser.floatval('U', LA_CAL_SLOW_FEEDRATE),
+                fast_feedrate = parser.floatval('V', LA_CAL_FAST_FEEDRATE);
+
+    if (!WITHIN(k_start, 0, 10) || !WITHIN(k_end, k_start, 10) || k_step <= 0) {
+      SERIAL_PROTOCOLLNPGM("?K range not plausible (0-10, A <= E, I > 0).");
+      return;
+    }
+    if (!WITHIN(slow_feedrate, 1, fast_feedrate) || fast_feedrate > planner.max_feedrate_mm_s[X_AXIS]) {
+      SERIAL_PROTOCOLLNPGM("?Specified speeds not plausible (U <= V <= X max feedrate).");
+      return;
+    }
+
+    // Check the count before narrowing it, so a tiny step can't wrap around
+    const float line_count = (k_end - k_start) / k_step + 1.001f;
+    if (line_count >= LA_CAL_MAX_LINES + 1) {
+      SERIAL_PROTOCOLLNPAIR("?Too many lines. Max: ", LA_CAL_MAX_LINES);
+      return;
+    }
+    const uint8_t lines = uint8_t(line_count);
+
+    g25_bed_temp    = LA_CAL_BED_TEMP;
+    g25_hotend_temp = LA_CAL_HOTEND_TEMP;
+    g25_layer_height = parser.linearval('L', 0.2);
+
+    if (parser.seenval('B')) {
+      g25_bed_temp = parser.value_celsius();
+      if (g25_bed_temp && !WITHIN(g25_bed_temp, 40, 140)) {
+        SERIAL_PROTOCOLLNPGM("?Specified bed temperature not plausible (40-140C).");
+        return;
+      }
+    }
+
+    if (parser.seenval('H')) {
+      g25_hotend_temp = parser.value_celsius();
+      if (!WITHIN(g25_hotend_temp, 165, 280)) {
+        SERIAL_PROTOCOLLNPGM("?Specified nozzle temperature not plausible.");
+        return;
+      }
+    }
+
+    if (!WITHIN(g25_layer_height, 0.05, 1.0)) {
+      SERIAL_PROTOCOLLNPGM("?Specified layer height not plausible.");
+      return;
+    }
+
+    const float nozzle = parser.linearval('S', 0.4),
+                filament_diameter = parser.linearval('F', DEFAULT_NOMINAL_FILAMENT_DIA);
+    if (!WITHIN(nozzle, 0.1, 1.0) || !WITHIN(filament_diameter, 1.0, 4.0)) {
+      SERIAL_PROTOCOLLNPGM("?Specified nozzle or filament size not plausible.");
+      return;
+    }
+
+    // Filament length for a line 1.2 nozzles wide and one layer high
+    g25_e_per_mm = (nozzle * 1.2) * g25_layer_height / (M_PI * 0.25 * sq(filament_diameter));
+
+    // The pattern: a row of slow/fast/slow lines, one line per K, from front to back
+    constexpr float pattern_width = 2 * (LA_CAL_SLOW_LENGTH) + (LA_CAL_FAST_LENGTH);
+    const float pattern_depth = (lines - 1) * (LA_CAL_LINE_SPACING);
+    g25_x_pos = parser.seenval('X') ? RAW_X_POSITION(parser.value_linear_units()) : 0.5 * (X_MIN_POS + X_MAX_POS - pattern_width);
+    g25_y_pos = parser.seenval('Y') ? RAW_Y_POSITION(parser.value_linear_units()) : 0.5 * (Y_MIN_POS + Y_MAX_POS - pattern_depth);
+    if (!position_is_reachable(g25_x_pos, g25_y_pos) || !position_is_reachable(g25_x_pos + pattern_width, g25_y_pos + pattern_depth)) {
+      SERIAL_PROTOCOLLNPGM("?Pattern out of bounds.");
+      return;
+    }
+
+    /**
+     * Wait until all parameters are verified before altering the state!
+     */
+    SERIAL_ECHOLNPGM("G25 command started. Waiting for heater(s).");
+
+    const float saved_k = planner.extruder_advance_K;
+    const bool keep_heaters_on = parser.boolval('K');
+
+    if (current_position[Z_AXIS] < Z_CLEARANCE_BETWEEN_PROBES) {
+      do_blocking_move_to_z(Z_CLEARANCE_BETWEEN_PROBES);
+      set_current_from_destination();
+    }
+
+    if (G25_turn_on_heaters() == G25_OK) {
+
+      current_position[E_CART] = 0.0;
+      sync_plan_position_e();
+      g25_retracted = false;
+
+      // Prime along the left side of the pattern
+      set_destination_from_current();
+      G25_travel_to(g25_x_pos - 5, g25_y_pos);
+      G25_retract(false);
+      G25_move_to(g25_x_pos - 5, g25_y_pos + pattern_depth, g25_layer_height, PRIME_LENGTH, slow_feedrate);
+
+      for (uint8_t i = 0; i < lines; i++) {
+        const float k = k_start + i * k_step,
+                    y = g25_y_pos + i * (LA_CAL_LINE_SPACING);
+
+        G25_travel_to(g25_x_pos, y);
+
+        // Start each line with the new K and time it from a standstill
+        planner.synchronize();
+        planner.extruder_advance_K = k;
+        const millis_t line_start = millis();
+
+        G25_print_to(g25_x_pos + (LA_CAL_SLOW_LENGTH), y, slow_feedrate);
+        G25_print_to(g25_x_pos + (LA_CAL_SLOW_LENGTH) + (LA_CAL_FAST_LENGTH), y, fast_feedrate);
+        G25_print_to(g25_x_pos + pattern_width, y, slow_feedrate);
+        planner.synchronize();
+
+        SERIAL_ECHOPAIR("G25 line:", i);
+        SERIAL_ECHOPAIR(" K:", k);
+        SERIAL_ECHOLNPAIR(" ms:", millis() - line_start);
+
+        #if ENABLED(ULTIPANEL)
+          if (is_lcd_clicked()) {
+            wait_for_release();
+            break;
+          }
+        #endif
+      }
+    }
+
+    lcd_setstatusPGM(PSTR("Leaving G25"), -1);
+
+    planner.synchronize();
+    planner.extruder_advance_K = saved_k;
+
+    G25_retract(true);
+    set_destination_from_current();
+    destination[Z_AXIS] = MAX(current_position[Z_AXIS], Z_CLEARANCE_BETWEEN_PROBES);
+    G25_move_to(current_position[X_AXIS], current_position[Y_AXIS], destination[Z_AXIS], 0, planner.max_feedrate_mm_s[Z_AXIS] / 3.0);
+
+    if (!keep_heaters_on) {
+      #if HAS_HEATED_BED
+        thermalManager.setTargetBed(0);
+      #endif
+      thermalManager.setTargetHotend(0, 0);
+    }
+  }
+
+#endif // LA_CALIBRATION_PATTERN
@@ -38,7 +38,41 @@
   #include "I2CPositionEncoder.h"
   #include "parser.h"
 
-  #include <Wire.h>
+  #if DISABLED(TWI_TRANSACTION_QUEUE)
+    #include <Wire.h>
+  #endif
+
+  // Blocking bus access, through Wire or the TWI transaction queue
+
+  static bool i2cpe_probe(const uint8_t addr) {
+    #if ENABLED(TWI_TRANSACTION_QUEUE)
+      return MarlinTWI::probe(addr);
+    #else
+      Wire.beginTransmission(addr);
+      return !Wire.endTransmission();
+    #endif
+  }
+
+  static void i2cpe_send(const uint8_t addr, const uint8_t *src, const uint8_t len) {
+    #if ENABLED(TWI_TRANSACTION_QUEUE)
+      MarlinTWI::write(addr, src, len);
+    #else
+      Wire.beginTransmission(addr);
+      Wire.write(src, len);
+      Wire.endTransmission();
+    #endif
+  }
+
+  static uint8_t i2cpe_read(const uint8_t addr, uint8_t *dst, const uint8_t len) {
+    #if ENABLED(TWI_TRANSACTION_QUEUE)
+      return MarlinTWI::read(addr, dst, len);
+    #else
+      const uint8_t got = Wire.requestFrom((int)addr, (int)len);
+      uint8_t count = 0;
+      while (count < got && Wire.available()) dst[count++] = (uint8_t)Wire.read();
+      return count;
+    #endif
+  }
 
 
   void I2CPositionEncoder::init(const uint8_t address, const AxisEnum axis) {
@@ -53,6 +87,112 @@
     position = get_position();
   }
 
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+
+    /**
+     * The encoders are read from interrupts every I2CPE_MIN_UPD_TIME_MS while
+     * there are moves, and each reading runs the correction in the next
+     * temperature interrupt.
+     * Here the controller settings are kept up to date, in steps so that the
+     * interrupt needs no planner math, and large errors are reported.
+     */
+    void I2CPositionEncoder::update() {
+      if (!initialised || !active) return;
+
+      const float steps_mm = planner.axis_steps_per_mm[encoderAxis];
+      CRITICAL_SECTION_START;
+      stepsPerTick = (type == I2CPE_ENC_TYPE_ROTARY ? stepperTicks : steps_mm) / encoderTicksPerUnit;
+      thresholdSteps = ecThreshold * steps_mm;
+      errorCountSteps = I2CPE_ERR_CNT_THRESH * steps_mm;
+      const int32_t error = largeError;
+      largeError = 0;
+      CRITICAL_SECTION_END;
+
+      if (error) {
+        SERIAL_ECHOPAIR("Large error on ", axis_codes[encoderAxis]);
+        SERIAL_ECHOLNPAIR(" axis. error: ", error);
+        #ifdef I2CPE_ERR_THRESH_ABORT
+          if (ABS(error) > I2CPE_ERR_THRESH_ABORT * steps_mm)
+            SERIAL_ECHOLNPGM("Axis error greater than set threshold!");
+        #endif
+      }
+    }
+
+    void I2CPositionEncoder::start_read() {
+      if (!initialised || !homed || !active || MarlinTWI::pending(xfer)) return;
+      xfer.addr = i2cAddress;
+      xfer.rx = xferData;
+      xfer.rx_len = 3;
+      xfer.done = read_done;
+      xfer.context = this;
+      MarlinTWI::queue(xfer);
+    }
+
+    // Only flag the reading. The TWI interrupt can cut into the stepper and
+    // temperature interrupts, so it mustn't touch their state.
+    void I2CPositionEncoder::read_done(TWITransfer &t) {
+      ((I2CPositionEncoder*)t.context)->readDone = true;
+    }
+
+    void I2CPositionEncoder::process_read() {
+      if (!readDone) return;
+      readDone = false;
+      if (xfer.status != TWI_OK || xfer.rx_count != 3) {
+        H = I2CPE_MAG_SIG_NF;
+        return;
+      }
+      position = decode_count(xferData) - zeroOffset;
+      correct();
+    }
+
+    /**
+     * Error correction for each reading, in the temperature interrupt. That one
+     * owns babystepsTodo[], and the stepper interrupt can't be running under it,
+     * so stepper.position() reads a whole count.
+     * Filter the error, and when it's over the threshold correct part of it
+     * with babysteps. Setting the babysteps left to do, rather than adding to
+     * them, keeps corrections that are still underway from adding up.
+     */
+    void I2CPositionEncoder::correct() {
+      if (!passes_test(false)) { lastErrorTime = millis(); return; }
+
+      #ifdef I2CPE_EC_THRESH_PROPORTIONAL
+        // Allow for the reading latency at speed
+        const int32_t speed = ABS(position - lastPosition) / (I2CPE_MIN_UPD_TIME_MS);
+        const int32_t threshold = thresholdSteps * constrain(speed / 50, 1, 50);
+      #else
+        const int32_t threshold = thresholdSteps;
+      #endif
+      lastPosition = position;
+
+      if (!trusted || !ec || ecMethod == I2CPE_ECM_NONE || !stepsPerTick) return;
+
+      const int32_t error = LROUND(position * stepsPerTick) - stepper.position(encoderAxis);
+
+      // Ignore discontinuities, likely caused by a bad reading
+      const bool jump = ABS(error - errorPrev) > 100;
+      errorPrev = error;
+      if (jump) return;
+
+      filtError += (error - filtError) / (1 << (I2CPE_EC_FILTER));
+
+      if (ABS(filtError) > threshold && encoderAxis < XYZ) { // Babysteps can't move E
+        const int32_t steps = -filtError * int32_t((I2CPE_EC_GAIN) * 256) / 256;
+        thermalManager.babystepsTodo[encoderAxis] = constrain(steps, -(I2CPE_EC_MAX_STEPS), I2CPE_EC_MAX_STEPS);
+      }
+
+      if (ABS(error) > errorCountSteps) {
+        const millis_t ms = millis();
+        if (ELAPSED(ms, nextErrorCountTime)) {
+          errorCount++;
+          largeError = error;
+          nextErrorCountTime = ms + I2CPE_ERR_CNT_DEBOUNCE_MS;
+        }
+      }
+    }
+
+  #else // !TWI_TRANSACTION_QUEUE
+
   void I2CPositionEncoder::update() {
     if (!initialised || !homed || !active) return; //check encoder is set up and active
 
@@ -215,14 +355,30 @@
     lastPositionTime = positionTime;
   }
 
+  #endif // !TWI_TRANSACTION_QUEUE
+
   void I2CPositionEncoder::set_homed() {
     if (active) {
+      #if ENABLED(TWI_TRANSACTION_QUEUE)
+        homed = trusted = false; // No corrections while the offset changes
+      #endif
+
       reset();  // Reset module's offset to zero (so current position is homed / zero)
       delay(10);
 
-      zeroOffset = get_raw_count();
-      homed++;
-      trusted++;
+      #if ENABLED(TWI_TRANSACTION_QUEUE)
+        const int32_t offset = get_raw_count();
+        CRITICAL_SECTION_START;
+        zeroOffset = offset;
+        filtError = errorPrev = 0;
+        homed = trusted = true;
+        CRITICAL_SECTION_END;
+        update();
+      #else
+        zeroOffset = get_raw_count();
+        homed++;
+        trusted++;
+      #endif
 
       #ifdef I2CPE_DEBUG
         SERIAL_ECHO(axis_codes[encoderAxis]);
@@ -310,19 +466,21 @@
   }
 
   int32_t I2CPositionEncoder::get_raw_count() {
-    uint8_t index = 0;
-    i2cLong encoderCount;
-
-    encoderCount.val = 0x00;
-
-    if (Wire.requestFrom((int)i2cAddress, 3) != 3) {
+    uint8_t data[3];
+    if (i2cpe_read(i2cAddress, data, 3) != 3) {
       //houston, we have a problem...
       H = I2CPE_MAG_SIG_NF;
       return 0;
     }
+    return decode_count(data);
+  }
+
+  int32_t I2CPositionEncoder::decode_count(const uint8_t data[3]) {
+    i2cLong encoderCount;
+
+    encoderCount.val = 0x00;
 
-    while (Wire.available())
-      encoderCount.bval[index++] = (uint8_t)Wire.read();
+    LOOP_L_N(i, 3) encoderCount.bval[i] = data[i];
 
     //extract the magnetic strength
     H = (B00000011 & (encoderCount.bval[2] >> 6));
@@ -474,11 +632,10 @@
   }
 
   void I2CPositionEncoder::reset() {
-    Wire.beginTransmission(i2cAddress);
-    Wire.write(I2CPE_RESET_COUNT);
-    Wire.endTransmission();
+    const uint8_t cmd = I2CPE_RESET_COUNT;
+    i2cpe_send(i2cAddress, &cmd, 1);
 
-    #if ENABLED(I2CPE_ERR_ROLLING_AVERAGE)
+    #if ENABLED(I2CPE_ERR_ROLLING_AVERAGE) && DISABLED(TWI_TRANSACTION_QUEUE)
       ZERO(err);
     #endif
   }
@@ -489,8 +646,30 @@
           I2CPositionEncodersMgr::I2CPE_idx;
   I2CPositionEncoder I2CPositionEncodersMgr::encoders[I2CPE_ENCODER_CNT];
 
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+
+    // Called by the temperature ISR at about 1kHz. Start a reading of every
+    // encoder each I2CPE_MIN_UPD_TIME_MS while there are moves to check.
+    void I2CPositionEncodersMgr::tick() {
+      // With only encoders on the bus nothing else may queue to notice a hang
+      MarlinTWI::check_timeout();
+
+      LOOP_PE(i) encoders[i].process_read();
+
+      static uint8_t ticks;
+      if (++ticks < I2CPE_MIN_UPD_TIME_MS) return;
+      ticks = 0;
+      if (planner.has_blocks_queued()) LOOP_PE(i) encoders[i].start_read();
+    }
+
+  #endif
+
   void I2CPositionEncodersMgr::init() {
-    Wire.begin();
+    #if ENABLED(TWI_TRANSACTION_QUEUE)
+      MarlinTWI::init();
+    #else
+      Wire.begin();
+    #endif
 
     #if I2CPE_ENCODER_CNT > 0
       uint8_t i = 0;
@@ -673,16 +852,14 @@
 
   void I2CPositionEncodersMgr::change_module_address(const uint8_t oldaddr, const uint8_t newaddr) {
     // First check 'new' address is not in use
-    Wire.beginTransmission(newaddr);
-    if (!Wire.endTransmission()) {
+    if (i2cpe_probe(newaddr)) {
       SERIAL_ECHOPAIR("?There is already a device with that address on the I2C bus! (", newaddr);
       SERIAL_ECHOLNPGM(")");
       return;
     }
 
     // Now check that we can find the module on the oldaddr address
-    Wire.beginTransmission(oldaddr);
-    if (Wire.endTransmission()) {
+    if (!i2cpe_probe(oldaddr)) {
       SERIAL_ECHOPAIR("?No module detected at this address! (", oldaddr);
       SERIAL_ECHOLNPGM(")");
       return;
@@ -692,10 +869,8 @@
     SERIAL_ECHOLNPAIR(", changing address to ", newaddr);
 
     // Change the modules address
-    Wire.beginTransmission(oldaddr);
-    Wire.write(I2CPE_SET_ADDR);
-    Wire.write(newaddr);
-    Wire.endTransmission();
+    const uint8_t cmd[] = { I2CPE_SET_ADDR, newaddr };
+    i2cpe_send(oldaddr, cmd, sizeof(cmd));
 
     SERIAL_ECHOLNPGM("Address changed, resetting and waiting for confirmation..");
 
@@ -703,8 +878,7 @@
     safe_delay(I2CPE_REBOOT_TIME);
 
     // Look for the module at the new address.
-    Wire.beginTransmission(newaddr);
-    if (Wire.endTransmission()) {
+    if (!i2cpe_probe(newaddr)) {
       SERIAL_ECHOLNPGM("Address change failed! Check encoder module.");
       return;
     }
@@ -723,8 +897,7 @@
 
   void I2CPositionEncodersMgr::report_module_firmware(const uint8_t address) {
     // First check there is a module
-    Wire.beginTransmission(address);
-    if (Wire.endTransmission()) {
+    if (!i2cpe_probe(address)) {
       SERIAL_ECHOPAIR("?No module detected at this address! (", address);
       SERIAL_ECHOLNPGM(")");
       return;
@@ -733,24 +906,20 @@
     SERIAL_ECHOPAIR("Requesting version info from module at address ", address);
     SERIAL_ECHOLNPGM(":");
 
-    Wire.beginTransmission(address);
-    Wire.write(I2CPE_SET_REPORT_MODE);
-    Wire.write(I2CPE_REPORT_VERSION);
-    Wire.endTransmission();
+    uint8_t cmd[] = { I2CPE_SET_REPORT_MODE, I2CPE_REPORT_VERSION };
+    i2cpe_send(address, cmd, sizeof(cmd));
 
     // Read value
-    if (Wire.requestFrom((int)address, 32)) {
-      char c;
-      while (Wire.available() > 0 && (c = (char)Wire.read()) > 0)
-        SERIAL_ECHO(c);
+    char version[32];
+    if (const uint8_t count = i2cpe_read(address, (uint8_t*)version, sizeof(version))) {
+      for (uint8_t i = 0; i < count && version[i] > 0; i++)
+        SERIAL_ECHO(version[i]);
       SERIAL_EOL();
     }
 
     // Set module back to normal (distance) mode
-    Wire.beginTransmission(address);
-    Wire.write(I2CPE_SET_REPORT_MODE);
-    Wire.write(I2CPE_REPORT_DISTANCE);
-    Wire.endTransmission();
+    cmd[1] = I2CPE_REPORT_DISTANCE;
+    i2cpe_send(address, cmd, sizeof(cmd));
   }
 
   int8_t I2CPositionEncodersMgr::parse() {
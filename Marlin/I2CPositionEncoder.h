@@ -30,7 +30,11 @@
   #include "enum.h"
   #include "macros.h"
   #include "types.h"
-  #include <Wire.h>
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    #include "MarlinTWI.h"
+  #else
+    #include <Wire.h>
+  #endif
 
   //=========== Advanced / Less-Common Encoder Configuration Settings ==========
 
@@ -134,18 +138,37 @@
               nextErrorCountTime  = 0,
               lastErrorTime;
 
-    #if ENABLED(I2CPE_ERR_ROLLING_AVERAGE)
+    #if ENABLED(TWI_TRANSACTION_QUEUE)
+      TWITransfer xfer;                   // Reading taken from interrupts
+      uint8_t xferData[3];
+      float stepsPerTick = 0;             // Stepper steps per encoder count
+      int32_t thresholdSteps = 0,         // Set from the foreground for the controller
+              errorCountSteps = 0,
+              filtError = 0;
+      volatile int32_t largeError = 0;    // Error for the foreground to report, 0 for none
+      volatile bool readDone = false;     // xferData holds a reading to process
+
+      static void read_done(TWITransfer &t);
+      void correct();
+    #elif ENABLED(I2CPE_ERR_ROLLING_AVERAGE)
       uint8_t errIdx = 0, errPrstIdx = 0;
       int err[I2CPE_ERR_ARRAY_SIZE] = { 0 },
           errPrst[I2CPE_ERR_PRST_ARRAY_SIZE] = { 0 };
     #endif
 
+    int32_t decode_count(const uint8_t data[3]);
+
   public:
     void init(const uint8_t address, const AxisEnum axis);
     void reset();
 
     void update();
 
+    #if ENABLED(TWI_TRANSACTION_QUEUE)
+      void start_read();
+      void process_read();
+    #endif
+
     void set_homed();
 
     int32_t get_raw_count();
@@ -226,6 +249,10 @@
     // consider only updating one endoder per call / tick if encoders become too time intensive
     static void update(void) { LOOP_PE(i) encoders[i].update(); }
 
+    #if ENABLED(TWI_TRANSACTION_QUEUE)
+      static void tick();
+    #endif
+
     static void homed(const AxisEnum axis) {
       LOOP_PE(i)
         if (encoders[i].get_axis() == axis) encoders[i].set_homed();
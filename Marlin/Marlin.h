@@ -486,6 +486,10 @@ void report_current_position();
     PROBE_PT_BIG_RAISE  // Raise to big clearance after run_z_probe
   };
   float probe_pt(const float &rx, const float &ry, const ProbePtRaise raise_after=PROBE_PT_NONE, const uint8_t verbose_level=0, const bool probe_relative=true);
+  #if ENABLED(PROBE_SCAN)
+    void probe_scan_start();
+    void probe_scan_end();
+  #endif
   #define DEPLOY_PROBE() set_probe_deployed(true)
   #define STOW_PROBE() set_probe_deployed(false)
 #else
@@ -553,6 +557,10 @@ inline void set_current_from_destination() { COPY(current_position, destination)
 inline void set_destination_from_current() { COPY(destination, current_position); }
 void prepare_move_to_destination();
 
+#if ENABLED(SEGMENT_COALESCING)
+  void flush_coalesced_move();
+#endif
+
 /**
  * Blocking movement and shorthand functions
  */
@@ -574,6 +582,7 @@ void do_blocking_move_to_xy(const float &rx, const float &ry, const float &fr_mm
       || ENABLED(NOZZLE_PARK_FEATURE)                                              \
       || (ENABLED(ADVANCED_PAUSE_FEATURE) && ENABLED(HOME_BEFORE_FILAMENT_CHANGE)) \
       || HAS_M206_COMMAND                                                          \
+      || ENABLED(LA_CALIBRATION_PATTERN)                                           \
     ) || ENABLED(NO_MOTION_BEFORE_HOMING)
 
 #if HAS_AXIS_UNHOMED_ERR
@@ -0,0 +1,224 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (C) 2016 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MarlinConfig.h"
+
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+
+#include "MarlinTWI.h"
+#include "Marlin.h"
+
+#include <util/twi.h>
+
+#define TWCR_NACK  (_BV(TWINT) | _BV(TWEN) | _BV(TWIE))
+#define TWCR_ACK   (TWCR_NACK | _BV(TWEA))
+#define TWCR_START (TWCR_NACK | _BV(TWSTA))
+#define TWCR_STOP  (TWCR_NACK | _BV(TWSTO))   // No interrupt follows a STOP
+
+TWITransfer* volatile MarlinTWI::active; // = NULL
+TWITransfer *MarlinTWI::queued[TWI_QUEUE_SIZE];
+volatile uint8_t MarlinTWI::head, MarlinTWI::count, MarlinTWI::index;
+millis_t MarlinTWI::started_ms;
+
+void MarlinTWI::init() {
+  static bool ready = false;
+  if (ready) return;
+  ready = true;
+
+  // Internal pull-ups on SDA and SCL, as Wire does
+  digitalWrite(SDA, HIGH);
+  digitalWrite(SCL, HIGH);
+
+  TWSR = 0; // Prescaler 1
+  TWBR = ((F_CPU) / (TWI_CLOCK_HZ) - 16) / 2;
+  TWCR = _BV(TWEN) | _BV(TWIE);
+}
+
+// Start the next queued transfer. Call with interrupts off and the bus idle.
+void MarlinTWI::start_next() {
+  if (!count) return;
+  TWITransfer * const t = queued[head];
+  head = (head + 1) % (TWI_QUEUE_SIZE);
+  count--;
+  index = 0;
+  t->status = TWI_ACTIVE;
+  active = t;
+  started_ms = millis();
+  TWCR = TWCR_START;
+}
+
+// End the active transfer and start the next one
+void MarlinTWI::finish(const TWIStatus status) {
+  TWITransfer &t = *active;
+  t.status = status;
+  if (t.done) t.done(t);  // May queue more transfers. They wait, as t is still active.
+  active = NULL;
+
+  // Go straight on to the next transfer with a repeated start, so a batch of
+  // queued transfers holds the bus once. STOP only when idle or after an error.
+  if (count && status != TWI_BUS_ERROR) {
+    start_next();
+    return;
+  }
+  TWCR = TWCR_STOP;
+  for (uint8_t i = 255; i && TEST(TWCR, TWSTO); i--) { /* A few µs */ }
+  start_next();
+}
+
+void MarlinTWI::isr() {
+  TWITransfer * const t = active;
+  if (!t) { TWCR = TWCR_STOP; return; }
+
+  switch (TW_STATUS) {
+    case TW_START:
+    case TW_REP_START:
+      // Write first, unless there's only reading to do
+      TWDR = (t->addr << 1) | (index < t->tx_len || !t->rx_len ? TW_WRITE : TW_READ);
+      TWCR = TWCR_NACK;
+      break;
+
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+      if (index < t->tx_len) {
+        TWDR = t->tx[index++];
+        TWCR = TWCR_NACK;
+      }
+      else if (t->rx_len)
+        TWCR = TWCR_START;    // Repeated start to read
+      else
+        finish(TWI_OK);
+      break;
+
+    case TW_MT_SLA_NACK:
+    case TW_MR_SLA_NACK:
+      finish(TWI_NACK_ADDR);
+      break;
+
+    case TW_MT_DATA_NACK:
+      finish(TWI_NACK_DATA);
+      break;
+
+    case TW_MT_ARB_LOST:      // Another master took the bus. Start over when it's free.
+      index = 0;
+      t->rx_count = 0;
+      TWCR = TWCR_START;
+      break;
+
+    case TW_MR_DATA_ACK:
+      t->rx[t->rx_count++] = TWDR;
+      // no break
+    case TW_MR_SLA_ACK:       // NACK the last byte
+      TWCR = t->rx_count + 1 < t->rx_len ? TWCR_ACK : TWCR_NACK;
+      break;
+
+    case TW_MR_DATA_NACK:
+      t->rx[t->rx_count++] = TWDR;
+      finish(TWI_OK);
+      break;
+
+    default:                  // TW_BUS_ERROR. The STOP releases the bus.
+      finish(TWI_BUS_ERROR);
+      break;
+  }
+}
+
+ISR(TWI_vect) { MarlinTWI::isr(); }
+
+// Give up on a transfer stuck for too long, e.g. by a device holding SCL low
+void MarlinTWI::check_timeout() {
+  CRITICAL_SECTION_START;
+  if (active && ELAPSED(millis(), started_ms + (TWI_TIMEOUT_MS))) {
+    TWCR = 0;                       // Reset the TWI hardware
+    TWCR = _BV(TWEN) | _BV(TWIE);
+    TWITransfer &t = *active;
+    t.status = TWI_TIMEOUT;
+    if (t.done) t.done(t);
+    active = NULL;
+    start_next();
+  }
+  CRITICAL_SECTION_END;
+}
+
+bool MarlinTWI::queue(TWITransfer &t) {
+  check_timeout();
+  bool ok = false;
+  CRITICAL_SECTION_START;
+  if (!pending(t) && count < TWI_QUEUE_SIZE) {
+    t.rx_count = 0;
+    t.status = TWI_QUEUED;
+    queued[(head + count) % (TWI_QUEUE_SIZE)] = &t;
+    count++;
+    if (!active) start_next();
+    ok = true;
+  }
+  CRITICAL_SECTION_END;
+  return ok;
+}
+
+TWIStatus MarlinTWI::wait(TWITransfer &t) {
+  while (pending(t)) check_timeout();
+  return t.status;
+}
+
+void MarlinTWI::submit(TWITransfer &t) {
+  while (!queue(t)) wait(t);  // Still busy from before, or the queue is full
+}
+
+void MarlinTWI::refresh(TWITransfer &t, uint8_t *dst, const uint8_t *src, const uint8_t len) {
+  // Nothing is sent before a transfer leaves the queue, so a waiting
+  // transfer can take the new data. Interrupts stay off so it can't start
+  // while that's being copied.
+  CRITICAL_SECTION_START;
+  const bool queued = t.status == TWI_QUEUED;
+  if (queued) memcpy(dst, src, len);
+  CRITICAL_SECTION_END;
+  if (queued) return;
+
+  // Never change the data of a write that's on the bus
+  wait(t);
+  memcpy(dst, src, len);
+  submit(t);
+}
+
+TWIStatus MarlinTWI::transfer(TWITransfer &t) {
+  submit(t);
+  return wait(t);
+}
+
+bool MarlinTWI::probe(const uint8_t addr) {
+  TWITransfer t = { addr };
+  return transfer(t) == TWI_OK;
+}
+
+TWIStatus MarlinTWI::write(const uint8_t addr, const uint8_t *src, const uint8_t len) {
+  TWITransfer t = { addr, len };
+  t.tx = src;
+  return transfer(t);
+}
+
+uint8_t MarlinTWI::read(const uint8_t addr, uint8_t *dst, const uint8_t len) {
+  TWITransfer t = { addr, 0, len };
+  t.rx = dst;
+  return transfer(t) == TWI_OK ? t.rx_count : 0;
+}
+
+#endif // TWI_TRANSACTION_QUEUE
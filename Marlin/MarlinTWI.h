@@ -0,0 +1,119 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (C) 2016 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * MarlinTWI - Interrupt driven TWI (I2C) master with a transaction queue
+ *
+ * A transfer writes tx_len bytes to a device, then reads rx_len bytes after a
+ * repeated start. Either part may be empty; with both empty it only checks
+ * that the device answers. Transfers are queued and run one after another by
+ * the TWI interrupt, so queue() returns at once and can be called from other
+ * interrupts. The transfer and its buffers belong to the caller and must stay
+ * untouched until it is done.
+ *
+ * The optional callback runs in the TWI interrupt when the transfer ends, with
+ * interrupts off. It may queue more transfers but it must be short.
+ *
+ * Transfers queued back to back are joined by repeated starts, so a batch of
+ * updates to several devices takes the bus once.
+ *
+ * This takes over the TWI interrupt, so it can't be used with the Wire library.
+ */
+
+#ifndef __MARLIN_TWI_H__
+#define __MARLIN_TWI_H__
+
+#include "MarlinConfig.h"
+
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+
+enum TWIStatus : uint8_t {
+  TWI_OK,         // Done. Also the state of a transfer never queued.
+  TWI_QUEUED,     // Waiting for the bus
+  TWI_ACTIVE,     // On the bus
+  TWI_NACK_ADDR,  // No device answered
+  TWI_NACK_DATA,  // The device refused a byte
+  TWI_BUS_ERROR,
+  TWI_TIMEOUT     // Not done within TWI_TIMEOUT_MS, the bus was reset
+};
+
+struct TWITransfer;
+typedef void (*twiDoneFunc_t)(TWITransfer &t);
+
+struct TWITransfer {
+  uint8_t addr;               // 7-bit device address
+  uint8_t tx_len, rx_len;     // Bytes to write, then to read
+  const uint8_t *tx;
+  uint8_t *rx;
+  twiDoneFunc_t done;         // Called from the interrupt at the end, or NULL
+  void *context;              // For the callback's own use
+  volatile uint8_t rx_count;  // Bytes read so far
+  volatile TWIStatus status;
+};
+
+class MarlinTWI {
+  public:
+    static void init();
+
+    // Add a transfer to the queue. False if it's already queued or the queue is full.
+    static bool queue(TWITransfer &t);
+
+    FORCE_INLINE static bool pending(const TWITransfer &t) { return t.status == TWI_QUEUED || t.status == TWI_ACTIVE; }
+
+    // Wait for a queued transfer to end. Not for use in interrupts.
+    static TWIStatus wait(TWITransfer &t);
+
+    // Queue a transfer without waiting for it. Waits only if it's still
+    // pending from before, or for room in the queue. Not for use in interrupts.
+    static void submit(TWITransfer &t);
+
+    // Copy new data into part (dst) of a write's buffer and send it. If the
+    // write is still waiting in the queue it takes the data with it, otherwise
+    // this waits for it to end before changing the buffer and queues it again.
+    static void refresh(TWITransfer &t, uint8_t *dst, const uint8_t *src, const uint8_t len);
+
+    // Queue a transfer and wait for it
+    static TWIStatus transfer(TWITransfer &t);
+
+    // Blocking helpers, in the manner of the Wire calls they replace
+    static bool probe(const uint8_t addr);
+    static TWIStatus write(const uint8_t addr, const uint8_t *src, const uint8_t len);
+    static uint8_t read(const uint8_t addr, uint8_t *dst, const uint8_t len);
+
+    // Drop a transfer that's taking too long. Queuing does this too.
+    static void check_timeout();
+
+    static void isr();
+
+  private:
+    static TWITransfer* volatile active;
+    static TWITransfer *queued[TWI_QUEUE_SIZE];
+    static volatile uint8_t head, count;
+    static volatile uint8_t index;
+    static millis_t started_ms;
+
+    static void start_next();
+    static void finish(const TWIStatus status);
+};
+
+#endif // TWI_TRANSACTION_QUEUE
+#endif // __MARLIN_TWI_H__
@@ -60,6 +60,7 @@
  * G19  - Select Plane YZ (Requires CNC_WORKSPACE_PLANES)
  * G20  - Set input units to inches (Requires INCH_MODE_SUPPORT)
  * G21  - Set input units to millimeters (Requires INCH_MODE_SUPPORT)
+ * G25  - Linear Advance Calibration Pattern (Requires LA_CALIBRATION_PATTERN)
  * G26  - Mesh Validation Pattern (Requires G26_MESH_VALIDATION)
  * G27  - Park Nozzle (Requires NOZZLE_PARK_FEATURE)
  * G28  - Home one or more axes
@@ -70,6 +71,8 @@
  * G33  - Delta Auto-Calibration (Requires DELTA_AUTO_CALIBRATION)
  * G38  - Probe in any direction using the Z_MIN_PROBE (Requires G38_PROBE_TARGET)
  * G42  - Coordinated move to a mesh point (Requires MESH_BED_LEVELING, AUTO_BED_LEVELING_BLINEAR, or AUTO_BED_LEVELING_UBL)
+ * G61  - Exact path mode, no path blending (Requires PATH_BLENDING)
+ * G64  - Path blending mode. P<tolerance> Q<merge deviation> (Requires PATH_BLENDING)
  * G90  - Use Absolute Coordinates
  * G91  - Use Relative Coordinates
  * G92  - Set current position to coordinates given
@@ -120,6 +123,8 @@
  * M85  - Set inactivity shutdown timer with parameter S<seconds>. To disable set zero (default)
  * M92  - Set planner.axis_steps_per_mm for one or more axes.
  * M100 - Watch Free Memory (for debugging) (Requires M100_FREE_MEMORY_WATCHER)
+ * M102 - Report idle task run times. "M102 R" to also reset them. (Requires IDLE_TASK_SCHEDULER)
+ * M103 - Report planner starvation. "M103 R" to also reset it. (Requires PLANNER_STARVATION_REPORT)
  * M104 - Set extruder target temp.
  * M105 - Report current temperatures.
  * M106 - Set print fan speed.
@@ -141,6 +146,8 @@
  * M120 - Enable endstops detection.
  * M121 - Disable endstops detection.
  * M122 - Debug stepper (Requires at least one _DRIVER_TYPE defined as TMC2130/TMC2208/TMC2660)
+ *        C: Report the cached driver readings (Requires TMC_ASYNC_MONITOR)
+ *        L: Report the stallGuard load log, R to clear it (Requires STALLGUARD_LOAD_LOG)
  * M125 - Save current position and move to filament change position. (Requires PARK_HEAD_ON_PAUSE)
  * M126 - Solenoid Air Valve Open. (Requires BARICUDA)
  * M127 - Solenoid Air Valve Closed. (Requires BARICUDA)
@@ -157,6 +164,7 @@
  * M190 - Sxxx Wait for bed current temp to reach target temp. ** Waits only when heating! **
  *        Rxxx Wait for bed current temp to reach target temp. ** Waits for heating or cooling. **
  * M200 - Set filament diameter, D<diameter>, setting E axis units to cubic. (Use S0 to revert to linear units.)
+ *        L<mm³/s> sets the maximum volumetric flow. (Requires VOLUMETRIC_EXTRUDER_LIMIT)
  * M201 - Set max acceleration in units/s^2 for print moves: "M201 X<accel> Y<accel> Z<accel> E<accel>"
  * M202 - Set max acceleration in units/s^2 for travel moves: "M202 X<accel> Y<accel> Z<accel> E<accel>" ** UNUSED IN MARLIN! **
  * M203 - Set maximum feedrate: "M203 X<fr> Y<fr> Z<fr> E<fr>" in units/sec.
@@ -177,6 +185,7 @@
  * M226 - Wait until a pin is in a given state: "M226 P<pin> S<state>"
  * M240 - Trigger a camera to take a photograph. (Requires CHDK or PHOTOGRAPH_PIN)
  * M250 - Set LCD contrast: "M250 C<contrast>" (0-63). (Requires LCD support)
+ * M251 - Report LCD drawing time. "M251 R" to also reset it. (Requires LCD_DIRTY_REGIONS)
  * M260 - i2c Send Data (Requires EXPERIMENTAL_I2CBUS)
  * M261 - i2c Request Data (Requires EXPERIMENTAL_I2CBUS)
  * M280 - Set servo position absolute: "M280 P<index> S<angle|µs>". (Requires servos)
@@ -206,8 +215,11 @@
  * M501 - Restore parameters from EEPROM. (Requires EEPROM_SETTINGS)
  * M502 - Revert to the default "factory settings". ** Does not write them to EEPROM! **
  * M503 - Print the current settings (in memory): "M503 S<verbose>". S0 specifies compact output.
+ * M506 - Store, clear or report settings profiles: "M506 P<slot> [C]". (Requires SETTINGS_PROFILES)
+ * M507 - Load a settings profile: "M507 P<slot>". Omit P for the base settings. (Requires SETTINGS_PROFILES)
  * M524 - Abort SD card print job started with M24 (Requires SDSUPPORT)
  * M540 - Enable/disable SD card abort on endstop hit: "M540 S<state>". (Requires ABORT_ON_ENDSTOP_HIT_FEATURE_ENABLED)
+ * M593 - Set or report the X/Y input shaper: "M593 [X] [Y] F<hz> D<damping> T<type>". (Requires INPUT_SHAPING)
  * M600 - Pause for filament change: "M600 X<pos> Y<pos> Z<raise> E<first_retract> L<later_retract>". (Requires ADVANCED_PAUSE_FEATURE)
  * M603 - Configure filament change: "M603 T<tool> U<unload_length> L<load_length>". (Requires ADVANCED_PAUSE_FEATURE)
  * M605 - Set Dual X-Carriage movement mode: "M605 S<mode> [X<x_offset>] [R<temp_offset>]". (Requires DUAL_X_CARRIAGE)
@@ -295,6 +307,10 @@
   #include "fwretract.h"
 #endif
 
+#if ENABLED(INPUT_SHAPING)
+  #include "input_shaping.h"
+#endif
+
 #if ENABLED(POWER_LOSS_RECOVERY)
   #include "power_loss_recovery.h"
 #endif
@@ -348,6 +364,10 @@
   void M100_dump_routine(const char * const title, const char *start, const char *end);
 #endif
 
+#if ENABLED(LA_CALIBRATION_PATTERN)
+  void gcode_G25();
+#endif
+
 #if ENABLED(G26_MESH_VALIDATION)
   bool g26_debug_flag; // =false
   void gcode_G26();
@@ -425,12 +445,38 @@ static long gcode_N, gcode_LastN, Stopped_gcode_LastN = 0;
  * (immediate, serial, sd card) and they are processed sequentially by
  * the main loop. The process_next_command function parses the next
  * command and hands off execution to individual handler functions.
+ *
+ * With BINARY_COMMAND_QUEUE the commands are decoded as they're added
+ * and kept in records of varying size, so the pool holds more of them.
+ * Up to BUFSIZE commands fit, as long as there's room in the pool.
  */
-uint8_t commands_in_queue = 0, // Count of commands in the queue
-        cmd_queue_index_r = 0, // Ring buffer read (out) position
-        cmd_queue_index_w = 0; // Ring buffer write (in) position
+#if ENABLED(BINARY_COMMAND_QUEUE)
+
+  uint8_t commands_in_queue = 0;          // Count of commands in the queue
+  static uint16_t cmd_queue_index_r = 0,  // Ring buffer read (out) position, in bytes
+                  cmd_queue_index_w = 0;  // Ring buffer write (in) position, in bytes
+
+  static uint8_t command_pool[BINARY_QUEUE_BYTES];
+
+  static_assert(BINARY_QUEUE_BYTES >= 2 * RECORD_SIZE_MAX, "BINARY_QUEUE_BYTES is too small for two commands.");
+
+  #if ENABLED(SDSUPPORT)
+    static bool queue_keeps_text = false; // Keep the text of commands queued behind M28 / M928 until it runs
+  #endif
+
+#else
+
+  uint8_t commands_in_queue = 0, // Count of commands in the queue
+          cmd_queue_index_r = 0, // Ring buffer read (out) position
+          cmd_queue_index_w = 0; // Ring buffer write (in) position
+
+  char command_queue[BUFSIZE][MAX_CMD_SIZE];
+
+#endif
 
-char command_queue[BUFSIZE][MAX_CMD_SIZE];
+#if ENABLED(SERIAL_LINE_TOKENIZER)
+  static gcode_tokens_t command_tokens[BUFSIZE]; // Tokens from the serial line reader
+#endif
 
 /**
  * Next Injected Command pointer. NULL if no commands are being injected.
@@ -707,7 +753,9 @@ float cartes[XYZ] = { 0 };
   #endif
 #endif
 
-static bool send_ok[BUFSIZE];
+#if DISABLED(BINARY_COMMAND_QUEUE)
+  static bool send_ok[BUFSIZE];
+#endif
 
 #if HAS_SERVOS
   Servo servo[NUM_SERVOS];
@@ -777,6 +825,16 @@ void set_current_from_steppers_for_axis(const AxisEnum axis);
   void plan_cubic_move(const float (&cart)[XYZE], const float (&offset)[4]);
 #endif
 
+#if ENABLED(SEGMENT_COALESCING)
+  static void coalesce_move_to_destination();
+  inline void discard_coalesced_move();
+  #if ENABLED(PATH_BLENDING)
+    static float coalesce_deviation_mm = COALESCE_DEVIATION_MM; // (mm) G64 Q
+  #else
+    constexpr float coalesce_deviation_mm = COALESCE_DEVIATION_MM;
+  #endif
+#endif
+
 void report_current_position();
 void report_current_position_detail();
 
@@ -886,26 +944,93 @@ void clear_command_queue() {
   cmd_queue_index_r = cmd_queue_index_w = commands_in_queue = 0;
 }
 
-/**
- * Once a new command is in the ring buffer, call this to commit it
- */
-inline void _commit_command(bool say_ok) {
-  send_ok[cmd_queue_index_w] = say_ok;
-  if (++cmd_queue_index_w >= BUFSIZE) cmd_queue_index_w = 0;
-  commands_in_queue++;
-}
+#if ENABLED(BINARY_COMMAND_QUEUE)
 
-/**
- * Copy a command from RAM into the main command buffer.
- * Return true if the command was successfully added.
- * Return false for a full buffer, or if the 'command' is a comment.
- */
-inline bool _enqueuecommand(const char* cmd, bool say_ok=false) {
-  if (*cmd == ';' || commands_in_queue >= BUFSIZE) return false;
-  strcpy(command_queue[cmd_queue_index_w], cmd);
-  _commit_command(say_ok);
-  return true;
-}
+  /**
+   * Is there room for another command? A record of the largest
+   * size must fit after the last one or at the start of the pool.
+   */
+  inline bool command_queue_has_room() {
+    if (commands_in_queue >= BUFSIZE) return false;
+    if (!commands_in_queue) return true;
+    if (cmd_queue_index_w >= cmd_queue_index_r)
+      return BINARY_QUEUE_BYTES - cmd_queue_index_w >= RECORD_SIZE_MAX || cmd_queue_index_r > RECORD_SIZE_MAX;
+    return cmd_queue_index_r - cmd_queue_index_w > RECORD_SIZE_MAX;
+  }
+
+  /**
+   * The record at the read position, wrapping at the end of the pool
+   */
+  inline gcode_record_t* current_record() {
+    if (BINARY_QUEUE_BYTES - cmd_queue_index_r < sizeof(uint16_t) || !((gcode_record_t*)&command_pool[cmd_queue_index_r])->size)
+      cmd_queue_index_r = 0;
+    return (gcode_record_t*)&command_pool[cmd_queue_index_r];
+  }
+
+  /**
+   * Decode a command from RAM into the next record.
+   * Return true if the command was successfully added.
+   * Return false for a full buffer, or if the 'command' is a comment.
+   */
+  inline bool _enqueuecommand(const char* cmd, bool say_ok=false) {
+    if (*cmd == ';' || !command_queue_has_room()) return false;
+
+    if (!commands_in_queue)
+      cmd_queue_index_r = cmd_queue_index_w = 0;
+    else if (cmd_queue_index_w >= cmd_queue_index_r && BINARY_QUEUE_BYTES - cmd_queue_index_w < RECORD_SIZE_MAX) {
+      if (BINARY_QUEUE_BYTES - cmd_queue_index_w >= sizeof(uint16_t))
+        ((gcode_record_t*)&command_pool[cmd_queue_index_w])->size = 0; // Mark the end
+      cmd_queue_index_w = 0;
+    }
+
+    gcode_record_t * const rec = (gcode_record_t*)&command_pool[cmd_queue_index_w];
+    cmd_queue_index_w += parser.encode(cmd, rec, DEBUGGING(ECHO)
+      #if ENABLED(SDSUPPORT)
+        || queue_keeps_text || card.saving
+      #endif
+    );
+    if (say_ok) rec->flags |= RECORD_SAY_OK;
+
+    #if ENABLED(SDSUPPORT)
+      if (rec->letter == 'M') switch (rec->codenum) {
+        case 28: case 928: queue_keeps_text = true; break;
+        case 29: queue_keeps_text = false; break;
+      }
+    #endif
+
+    commands_in_queue++;
+    return true;
+  }
+
+#else // !BINARY_COMMAND_QUEUE
+
+  inline bool command_queue_has_room() { return commands_in_queue < BUFSIZE; }
+
+  /**
+   * Once a new command is in the ring buffer, call this to commit it
+   */
+  inline void _commit_command(bool say_ok) {
+    send_ok[cmd_queue_index_w] = say_ok;
+    #if ENABLED(SERIAL_LINE_TOKENIZER)
+      command_tokens[cmd_queue_index_w].cmd = 0xFF; // No tokens unless added by get_serial_commands
+    #endif
+    if (++cmd_queue_index_w >= BUFSIZE) cmd_queue_index_w = 0;
+    commands_in_queue++;
+  }
+
+  /**
+   * Copy a command from RAM into the main command buffer.
+   * Return true if the command was successfully added.
+   * Return false for a full buffer, or if the 'command' is a comment.
+   */
+  inline bool _enqueuecommand(const char* cmd, bool say_ok=false) {
+    if (*cmd == ';' || commands_in_queue >= BUFSIZE) return false;
+    strcpy(command_queue[cmd_queue_index_w], cmd);
+    _commit_command(say_ok);
+    return true;
+  }
+
+#endif // !BINARY_COMMAND_QUEUE
 
 /**
  * Enqueue with Serial Echo
@@ -1021,6 +1146,135 @@ void gcode_line_error(const char* err, bool doFlush = true) {
   serial_count = 0;
 }
 
+#if ENABLED(BINARY_FILE_UPLOAD)
+
+  // Packets the host may send ahead of the acknowledgements, all fitting in the RX buffer
+  #if defined(RX_BUFFER_SIZE) && RX_BUFFER_SIZE >= 2 * (BINARY_UPLOAD_CHUNK_SIZE + 7) + 1
+    #define BINARY_UPLOAD_WINDOW ((RX_BUFFER_SIZE - 1) / (BINARY_UPLOAD_CHUNK_SIZE + 7))
+  #else
+    #define BINARY_UPLOAD_WINDOW 1
+  #endif
+
+  enum BinaryUploadState : char { BU_SYNC1, BU_SYNC2, BU_SEQ, BU_LEN1, BU_LEN2, BU_DATA, BU_CRC1, BU_CRC2 };
+
+  static struct {
+    BinaryUploadState state;
+    uint8_t seq, next_seq;
+    uint16_t len, count, crc, packet_crc;
+    millis_t last_ms;
+    uint8_t data[BINARY_UPLOAD_CHUNK_SIZE];
+  } upload;
+
+  static void binary_upload_reply(const char type, const uint8_t seq) {
+    SERIAL_PROTOCOLCHAR('b');
+    SERIAL_PROTOCOLCHAR(type);
+    SERIAL_PROTOCOLLN((int)seq);
+  }
+
+  /**
+   * Receive the packets of an upload started with M28 B1.
+   *
+   * Each packet is:
+   *
+   *   0xB5 0xAD <seq> <len:2> <data:len> <crc:2>
+   *
+   * Multi-byte fields are little-endian. seq counts up from 0 and wraps.
+   * crc is the CRC-16/XMODEM of seq, len and data. A packet with no data
+   * ends the upload.
+   *
+   * Each packet in sequence is answered with "bk<seq>" once it is stored.
+   * The host may have BINARY_UPLOAD_WINDOW packets waiting for an answer.
+   * A damaged or incomplete packet is answered with "bn<seq>", giving the
+   * packet to resend from. Packets after it are dropped until it arrives,
+   * and repeats of stored packets are only answered again.
+   *
+   * An error or timeout abandons the upload, deletes the file and returns
+   * to G-code with an error message.
+   */
+  inline void get_binary_upload_packets() {
+    const millis_t ms = millis();
+    if (!MYSERIAL0.available()) {
+      if (ELAPSED(ms, upload.last_ms + BINARY_UPLOAD_TIMEOUT)) {
+        card.closeBinaryUpload(false);
+        SERIAL_ERROR_START();
+        SERIAL_ERRORLNPGM(MSG_SD_UPLOAD_TIMEOUT);
+      }
+      else if (upload.state != BU_SYNC1 && ELAPSED(ms, upload.last_ms + 500)) {
+        upload.state = BU_SYNC1;  // Incomplete packet
+        binary_upload_reply('n', upload.next_seq);
+      }
+      return;
+    }
+    upload.last_ms = ms;
+
+    int c;
+    while ((c = MYSERIAL0.read()) >= 0) {
+      const uint8_t b = c;
+      if (WITHIN(upload.state, BU_SEQ, BU_DATA)) crc16(&upload.crc, &b, 1);
+      switch (upload.state) {
+        case BU_SYNC1: if (b == 0xB5) upload.state = BU_SYNC2; break;
+        case BU_SYNC2:
+          upload.crc = 0;
+          upload.state = b == 0xAD ? BU_SEQ : b == 0xB5 ? BU_SYNC2 : BU_SYNC1;
+          break;
+        case BU_SEQ: upload.seq = b; upload.state = BU_LEN1; break;
+        case BU_LEN1: upload.len = b; upload.state = BU_LEN2; break;
+        case BU_LEN2:
+          upload.len |= (uint16_t)b << 8;
+          upload.count = 0;
+          if (upload.len > BINARY_UPLOAD_CHUNK_SIZE) {
+            upload.state = BU_SYNC1;
+            binary_upload_reply('n', upload.next_seq);
+          }
+          else
+            upload.state = upload.len ? BU_DATA : BU_CRC1;
+          break;
+        case BU_DATA:
+          upload.data[upload.count++] = b;
+          if (upload.count == upload.len) upload.state = BU_CRC1;
+          break;
+        case BU_CRC1: upload.packet_crc = b; upload.state = BU_CRC2; break;
+        case BU_CRC2:
+          upload.packet_crc |= (uint16_t)b << 8;
+          upload.state = BU_SYNC1;
+
+          if (upload.packet_crc != upload.crc) {
+            binary_upload_reply('n', upload.next_seq);
+            break;
+          }
+
+          if (upload.seq != upload.next_seq) {
+            if ((int8_t)(upload.seq - upload.next_seq) < 0) binary_upload_reply('k', upload.seq);
+            break;
+          }
+
+          if (!upload.len) {
+            if (card.closeBinaryUpload(true)) {
+              binary_upload_reply('k', upload.seq);
+              SERIAL_PROTOCOLLNPGM(MSG_FILE_SAVED);
+            }
+            else {
+              SERIAL_ERROR_START();
+              SERIAL_ERRORLNPGM(MSG_SD_ERR_WRITE_TO_FILE);
+            }
+            return;
+          }
+
+          if (!card.writeBinaryUpload(upload.data, upload.len)) {
+            card.closeBinaryUpload(false);
+            SERIAL_ERROR_START();
+            SERIAL_ERRORLNPGM(MSG_SD_ERR_WRITE_TO_FILE);
+            return;
+          }
+          binary_upload_reply('k', upload.seq);
+          upload.next_seq++;
+          break;
+      }
+    }
+  }
+
+#endif // BINARY_FILE_UPLOAD
+
 /**
  * Get all commands waiting on the serial port and queue them.
  * Exit when the buffer is full or when no more characters are
@@ -1045,7 +1299,7 @@ inline void get_serial_commands() {
    * Loop while serial characters are incoming and the queue is not full
    */
   int c;
-  while (commands_in_queue < BUFSIZE && (c = MYSERIAL0.read()) >= 0) {
+  while (command_queue_has_room() && (c = MYSERIAL0.read()) >= 0) {
 
     char serial_char = c;
 
@@ -1060,6 +1314,9 @@ inline void get_serial_commands() {
       if (!serial_count) { thermalManager.manage_heater(); continue; }
 
       serial_line_buffer[serial_count] = 0;             // Terminate string
+      #if ENABLED(SERIAL_LINE_TOKENIZER)
+        GCodeLineReader::finish(serial_line_buffer, serial_count);
+      #endif
       serial_count = 0;                                 // Reset buffer
 
       char* command = serial_line_buffer;
@@ -1067,6 +1324,23 @@ inline void get_serial_commands() {
       while (*command == ' ') command++;                // Skip leading spaces
       char *npos = (*command == 'N') ? command : NULL;  // Require the N parameter to start the line
 
+      #if ENABLED(SERIAL_LINE_TOKENIZER)
+        if (npos && GCodeLineReader::tokenized()) {     // Line number and checksum were read with the line
+          gcode_N = GCodeLineReader::N;
+
+          if (gcode_N != gcode_LastN + 1)
+            return gcode_line_error(PSTR(MSG_ERR_LINE_NO));
+
+          if (!GCodeLineReader::has_checksum)
+            return gcode_line_error(PSTR(MSG_ERR_NO_CHECKSUM));
+
+          if (GCodeLineReader::sent_checksum != GCodeLineReader::checksum)
+            return gcode_line_error(PSTR(MSG_ERR_CHECKSUM_MISMATCH));
+
+          gcode_LastN = gcode_N;
+        }
+        else
+      #endif
       if (npos) {
 
         bool M110 = strstr_P(command, PSTR("M110")) != NULL;
@@ -1136,20 +1410,35 @@ inline void get_serial_commands() {
       #endif
 
       // Add the command to the queue
+      #if ENABLED(SERIAL_LINE_TOKENIZER)
+        const uint8_t slot = cmd_queue_index_w;
+      #endif
       _enqueuecommand(serial_line_buffer, true);
+      #if ENABLED(SERIAL_LINE_TOKENIZER)
+        command_tokens[slot] = GCodeLineReader::tokens;
+      #endif
     }
     else if (serial_count >= MAX_CMD_SIZE - 1) {
       // Keep fetching, but ignore normal characters beyond the max length
       // The command will be injected when EOL is reached
     }
     else if (serial_char == '\\') {   // Handle escapes
-      if ((c = MYSERIAL0.read()) >= 0 && !serial_comment_mode) // if we have one more character, copy it over
+      if ((c = MYSERIAL0.read()) >= 0 && !serial_comment_mode) { // if we have one more character, copy it over
+        #if ENABLED(SERIAL_LINE_TOKENIZER)
+          GCodeLineReader::feed((char)c, serial_count);
+        #endif
         serial_line_buffer[serial_count++] = (char)c;
+      }
       // otherwise do nothing
     }
     else { // it's not a newline, carriage return or escape char
       if (serial_char == ';') serial_comment_mode = true;
-      if (!serial_comment_mode) serial_line_buffer[serial_count++] = serial_char;
+      if (!serial_comment_mode) {
+        #if ENABLED(SERIAL_LINE_TOKENIZER)
+          GCodeLineReader::feed(serial_char, serial_count);
+        #endif
+        serial_line_buffer[serial_count++] = serial_char;
+      }
     }
 
   } // queue has space, serial has data
@@ -1181,9 +1470,13 @@ inline void get_serial_commands() {
 
     if (commands_in_queue == 0) stop_buffering = false;
 
+    #if ENABLED(BINARY_COMMAND_QUEUE)
+      static char sd_line_buffer[MAX_CMD_SIZE];
+    #endif
+
     uint16_t sd_count = 0;
     bool card_eof = card.eof();
-    while (commands_in_queue < BUFSIZE && !card_eof && !stop_buffering) {
+    while (command_queue_has_room() && !card_eof && !stop_buffering) {
       const int16_t n = card.get();
       char sd_char = (char)n;
       card_eof = card.eof();
@@ -1229,10 +1522,16 @@ inline void get_serial_commands() {
         // Skip empty lines and comments
         if (!sd_count) { thermalManager.manage_heater(); continue; }
 
-        command_queue[cmd_queue_index_w][sd_count] = '\0'; // terminate string
-        sd_count = 0; // clear sd line buffer
+        #if ENABLED(BINARY_COMMAND_QUEUE)
+          sd_line_buffer[sd_count] = '\0';
+          sd_count = 0;
+          _enqueuecommand(sd_line_buffer);
+        #else
+          command_queue[cmd_queue_index_w][sd_count] = '\0'; // terminate string
+          sd_count = 0; // clear sd line buffer
 
-        _commit_command(false);
+          _commit_command(false);
+        #endif
       }
       else if (sd_count >= MAX_CMD_SIZE - 1) {
         /**
@@ -1242,7 +1541,13 @@ inline void get_serial_commands() {
       }
       else {
         if (sd_char == ';') sd_comment_mode = true;
-        if (!sd_comment_mode) command_queue[cmd_queue_index_w][sd_count++] = sd_char;
+        if (!sd_comment_mode) {
+          #if ENABLED(BINARY_COMMAND_QUEUE)
+            sd_line_buffer[sd_count++] = sd_char;
+          #else
+            command_queue[cmd_queue_index_w][sd_count++] = sd_char;
+          #endif
+        }
       }
     }
   }
@@ -1277,6 +1582,11 @@ void get_available_commands() {
   // Immediate commands block the other queues
   if (drain_injected_commands_P()) return;
 
+  #if ENABLED(BINARY_FILE_UPLOAD)
+    // The serial port carries file data during an upload
+    if (card.uploading) return get_binary_upload_packets();
+  #endif
+
   get_serial_commands();
 
   #if ENABLED(POWER_LOSS_RECOVERY)
@@ -1646,6 +1956,10 @@ inline void buffer_line_to_destination(const float &fr_mm_s) {
  * Caution: 'destination' is modified by this function.
  */
 void do_blocking_move_to(const float rx, const float ry, const float rz, const float &fr_mm_s/*=0.0*/) {
+  #if ENABLED(SEGMENT_COALESCING)
+    flush_coalesced_move();
+  #endif
+
   const float old_feedrate_mm_s = feedrate_mm_s;
 
   #if ENABLED(DEBUG_LEVELING_FEATURE)
@@ -2314,6 +2628,67 @@ void clean_up_after_endstop_or_probe_move() {
     return !probe_triggered;
   }
 
+  /**
+   * Stop the probe before it goes too low to prevent damage.
+   * If Z isn't known then probe to -10mm.
+   */
+  static float probe_low_point() {
+    return TEST(axis_known_position, Z_AXIS) ? -zprobe_zoffset + Z_PROBE_LOW_POINT : -10.0;
+  }
+
+  #if ENABLED(PROBE_SCAN)
+
+    static struct {
+      bool active,            // probe_pt() is scanning
+           lifted;            // The lift after the last point is queued
+      uint8_t count;          // Points scanned
+      float last_z;           // Raw Z of the last touch
+      millis_t start_ms;
+    } probe_scan;
+
+    /**
+     * Start a mesh scan. Until probe_scan_end() each probe_pt() that
+     * raises afterward leaves its lift queued for the next point.
+     */
+    void probe_scan_start() {
+      probe_scan.active = true;
+      probe_scan.lifted = false;
+      probe_scan.count = 0;
+      probe_scan.start_ms = millis();
+    }
+
+    /**
+     * Finish the scan, wait for the last lift and report the time taken.
+     */
+    void probe_scan_end() {
+      if (!probe_scan.active) return;
+      probe_scan.active = probe_scan.lifted = false;
+      planner.synchronize();
+      if (probe_scan.count) {
+        const millis_t ms = millis() - probe_scan.start_ms;
+        SERIAL_ECHO_START();
+        SERIAL_ECHOPAIR("Scanned ", probe_scan.count);
+        SERIAL_ECHOPAIR(" points in ", ms);
+        SERIAL_ECHOLNPAIR("ms, per point ", ms / probe_scan.count);
+      }
+    }
+
+    /**
+     * Queue the lift from a scanned point. Expect the next point to
+     * differ from this one as much as this one did from the last.
+     */
+    static void probe_scan_lift() {
+      const float z = current_position[Z_AXIS];
+      float lift = PROBE_SCAN_CLEARANCE;
+      if (probe_scan.count) lift += ABS(z - probe_scan.last_z);
+      NOMORE(lift, Z_CLEARANCE_BETWEEN_PROBES);
+      probe_scan.last_z = z;
+      current_position[Z_AXIS] += lift;
+      planner.buffer_line_kinematic(current_position, MMM_TO_MMS(Z_PROBE_SPEED_FAST), active_extruder);
+    }
+
+  #endif // PROBE_SCAN
+
   /**
    * @details Used by probe_pt to do a single Z probe at the current position.
    *          Leaves current_position[Z_AXIS] at the height where the probe triggered.
@@ -2326,9 +2701,7 @@ void clean_up_after_endstop_or_probe_move() {
       if (DEBUGGING(LEVELING)) DEBUG_POS(">>> run_z_probe", current_position);
     #endif
 
-    // Stop the probe before it goes too low to prevent damage.
-    // If Z isn't known then probe to -10mm.
-    const float z_probe_low_point = TEST(axis_known_position, Z_AXIS) ? -zprobe_zoffset + Z_PROBE_LOW_POINT : -10.0;
+    const float z_probe_low_point = probe_low_point();
 
     // Double-probing does a fast probe followed by a slow probe
     #if MULTIPLE_PROBING == 2
@@ -2465,14 +2838,42 @@ void clean_up_after_endstop_or_probe_move() {
     const float old_feedrate_mm_s = feedrate_mm_s;
     feedrate_mm_s = XY_PROBE_FEEDRATE_MM_S;
 
-    // Move the probe to the starting XYZ
-    do_blocking_move_to(nx, ny, nz);
+    #if ENABLED(PROBE_SCAN)
+      const millis_t point_ms = millis();
+      const bool scan_touch = probe_scan.active && probe_scan.lifted;
+      if (scan_touch) {
+        // Travel right behind the queued lift
+        current_position[X_AXIS] = nx;
+        current_position[Y_AXIS] = ny;
+        current_position[Z_AXIS] = nz;
+        planner.buffer_line_kinematic(current_position, feedrate_mm_s, active_extruder);
+      }
+      else
+    #endif
+        // Move the probe to the starting XYZ
+        do_blocking_move_to(nx, ny, nz);
 
     float measured_z = NAN;
     if (!DEPLOY_PROBE()) {
-      measured_z = run_z_probe() + zprobe_zoffset;
+      #if ENABLED(PROBE_SCAN)
+        // A single slow touch from just above the bed. The dive is queued right
+        // behind the lift and travel, but it still blocks until the probe
+        // triggers, since the next point depends on where it did.
+        if (scan_touch)
+          measured_z = (do_probe_move(probe_low_point(), MMM_TO_MMS(Z_PROBE_SPEED_SLOW)) ? NAN : current_position[Z_AXIS]) + zprobe_zoffset;
+        else
+      #endif
+          measured_z = run_z_probe() + zprobe_zoffset;
 
       const bool big_raise = raise_after == PROBE_PT_BIG_RAISE;
+      #if ENABLED(PROBE_SCAN)
+        probe_scan.lifted = probe_scan.active && raise_after == PROBE_PT_RAISE && !isnan(measured_z);
+        if (probe_scan.lifted) {
+          probe_scan_lift();
+          probe_scan.count++;
+        }
+        else
+      #endif
       if (big_raise || raise_after == PROBE_PT_RAISE)
         do_blocking_move_to_z(current_position[Z_AXIS] + (big_raise ? 25 : Z_CLEARANCE_BETWEEN_PROBES), MMM_TO_MMS(Z_PROBE_SPEED_FAST));
       else if (raise_after == PROBE_PT_STOW)
@@ -2487,6 +2888,12 @@ void clean_up_after_endstop_or_probe_move() {
       SERIAL_PROTOCOLPGM(" Z: ");
       SERIAL_PROTOCOL_F(measured_z, 3);
       SERIAL_EOL();
+      #if ENABLED(PROBE_SCAN)
+        if (probe_scan.active) {
+          SERIAL_ECHO_START();
+          SERIAL_ECHOLNPAIR("Point time (ms): ", millis() - point_ms);
+        }
+      #endif
     }
 
     feedrate_mm_s = old_feedrate_mm_s;
@@ -3413,6 +3820,199 @@ void gcode_get_destination() {
 
 #endif // HOST_KEEPALIVE_FEATURE
 
+#if ENABLED(IDLE_TASK_SCHEDULER)
+
+  /**
+   * Housekeeping tasks run from idle() by period and time budget.
+   *
+   * A task runs at most once per period. While the planner is running low
+   * a task waits for its deadline, so loop() gets back to queueing moves.
+   * Once idle() has used IDLE_TIME_BUDGET_US the remaining tasks wait for
+   * the next call, which starts with the first task that had to wait.
+   * A task past its deadline always runs.
+   */
+  enum IdleTask : char {
+    #ifdef ANYCUBIC_TFT_MODEL
+      IDLE_TASK_TFT,
+    #endif
+    #if ENABLED(ULTRA_LCD) || ENABLED(MALYAN_LCD)
+      IDLE_TASK_LCD,
+    #endif
+    #if ENABLED(HOST_KEEPALIVE_FEATURE)
+      IDLE_TASK_KEEPALIVE,
+    #endif
+    #if ENABLED(SD_LOG_BUFFER)
+      IDLE_TASK_SD_LOG,
+    #endif
+    #if ENABLED(I2C_POSITION_ENCODERS)
+      IDLE_TASK_I2CPEM,
+    #endif
+    #if HAS_AUTO_REPORTING
+      IDLE_TASK_AUTO_REPORT,
+    #endif
+    IDLE_TASKS
+  };
+
+  // Period and deadline of each task, in ms
+  static const uint16_t idle_task_timing[][2] PROGMEM = {
+    #ifdef ANYCUBIC_TFT_MODEL
+      { 0, 20 },                      // Serial TFT commands
+    #endif
+    #if ENABLED(ULTRA_LCD) || ENABLED(MALYAN_LCD)
+      { 0, 250 },                     // Throttled by LCD_UPDATE_INTERVAL
+    #endif
+    #if ENABLED(HOST_KEEPALIVE_FEATURE)
+      { 0, 1000 },                    // Throttled by M113
+    #endif
+    #if ENABLED(SD_LOG_BUFFER)
+      { 0, 500 },
+    #endif
+    #if ENABLED(I2C_POSITION_ENCODERS)
+      { I2CPE_MIN_UPD_TIME_MS, 50 },
+    #endif
+    #if HAS_AUTO_REPORTING
+      { 0, 1000 }                     // Throttled by M155 / M27 S
+    #endif
+  };
+
+  static struct {
+    millis_t next_ms;
+    uint32_t runs, deferred, total_us;
+    uint16_t max_us;
+  } idle_task_stats[IDLE_TASKS];
+
+  static void idle_task_call(const uint8_t t) {
+    switch (t) {
+      #ifdef ANYCUBIC_TFT_MODEL
+        case IDLE_TASK_TFT: AnycubicTFT.CommandScan(); break;
+      #endif
+      #if ENABLED(ULTRA_LCD) || ENABLED(MALYAN_LCD)
+        case IDLE_TASK_LCD: lcd_update(); break;
+      #endif
+      #if ENABLED(HOST_KEEPALIVE_FEATURE)
+        case IDLE_TASK_KEEPALIVE: host_keepalive(); break;
+      #endif
+      #if ENABLED(SD_LOG_BUFFER)
+        case IDLE_TASK_SD_LOG: card.manageLog(); break;
+      #endif
+      #if ENABLED(I2C_POSITION_ENCODERS)
+        case IDLE_TASK_I2CPEM: if (planner.has_blocks_queued()) I2CPEM.update(); break;
+      #endif
+      #if HAS_AUTO_REPORTING
+        case IDLE_TASK_AUTO_REPORT:
+          if (!suspend_auto_report) {
+            #if ENABLED(AUTO_REPORT_TEMPERATURES)
+              thermalManager.auto_report_temperatures();
+            #endif
+            #if ENABLED(AUTO_REPORT_SD_STATUS)
+              card.auto_report_sd_status();
+            #endif
+          }
+          break;
+      #endif
+    }
+  }
+
+  static const char* idle_task_name(const uint8_t t) {
+    switch (t) {
+      #ifdef ANYCUBIC_TFT_MODEL
+        case IDLE_TASK_TFT: return PSTR("TFT");
+      #endif
+      #if ENABLED(ULTRA_LCD) || ENABLED(MALYAN_LCD)
+        case IDLE_TASK_LCD: return PSTR("LCD");
+      #endif
+      #if ENABLED(HOST_KEEPALIVE_FEATURE)
+        case IDLE_TASK_KEEPALIVE: return PSTR("Keepalive");
+      #endif
+      #if ENABLED(SD_LOG_BUFFER)
+        case IDLE_TASK_SD_LOG: return PSTR("SD log");
+      #endif
+      #if ENABLED(I2C_POSITION_ENCODERS)
+        case IDLE_TASK_I2CPEM: return PSTR("I2C encoders");
+      #endif
+      #if HAS_AUTO_REPORTING
+        case IDLE_TASK_AUTO_REPORT: return PSTR("Auto report");
+      #endif
+    }
+    return PSTR("?");
+  }
+
+  /**
+   * Run the idle tasks that are due, starting with the one that waited longest.
+   * start_us is when idle() was entered, so the budget covers the whole call.
+   */
+  static void run_idle_tasks(const uint32_t start_us) {
+    static uint8_t first_task; // The first task to wait on the budget last time
+    const bool planner_low = planner.has_blocks_queued() && planner.movesplanned() < IDLE_PLANNER_LOW;
+    bool over_budget = false;
+    uint8_t t = first_task;
+    for (uint8_t n = IDLE_TASKS; n--; t = (t + 1) % (IDLE_TASKS)) {
+      const millis_t now = millis();
+      if (PENDING(now, idle_task_stats[t].next_ms)) continue;
+
+      if (planner_low || over_budget) {
+        const uint16_t deadline = pgm_read_word(&idle_task_timing[t][1]);
+        if (PENDING(now, idle_task_stats[t].next_ms + deadline)) {
+          if (!over_budget) idle_task_stats[t].deferred++;
+          continue;
+        }
+      }
+
+      const uint32_t task_us = micros();
+      idle_task_call(t);
+      const uint32_t end_us = micros(), used_us = end_us - task_us;
+      idle_task_stats[t].next_ms = now + pgm_read_word(&idle_task_timing[t][0]);
+      idle_task_stats[t].runs++;
+      idle_task_stats[t].total_us += used_us;
+      NOLESS(idle_task_stats[t].max_us, MIN(used_us, 0xFFFFUL));
+
+      if (!over_budget && end_us - start_us >= IDLE_TIME_BUDGET_US) {
+        over_budget = true;
+        first_task = (t + 1) % (IDLE_TASKS);
+      }
+    }
+  }
+
+#endif // IDLE_TASK_SCHEDULER
+
+#if ENABLED(PLANNER_STARVATION_REPORT)
+
+  #define STARVED_COMMAND_SIZE 24
+
+  // Times the planner ran dry during a print job, with the command that came next
+  static struct {
+    uint16_t events, longest_ms;
+    uint32_t total_ms;
+    char command[STARVED_COMMAND_SIZE];
+    #if ENABLED(SDSUPPORT)
+      uint32_t sdpos;
+    #endif
+  } starvation;
+
+  /**
+   * Called before each command. If the Stepper ran out of blocks since the
+   * last command, and that wasn't a synchronize() or an M109/M190 wait,
+   * count it against the job.
+   */
+  static void note_planner_starvation(const char * const command) {
+    CRITICAL_SECTION_START;
+    const millis_t starved_ms = planner.starved_ms;
+    planner.starved_ms = 0;
+    CRITICAL_SECTION_END;
+    if (!starved_ms || !print_job_timer.isRunning()) return;
+
+    const millis_t ms = millis() - starved_ms;
+    starvation.events++;
+    starvation.total_ms += ms;
+    NOLESS(starvation.longest_ms, MIN(ms, 0xFFFFUL));
+    strncpy(starvation.command, command, STARVED_COMMAND_SIZE - 1);
+    #if ENABLED(SDSUPPORT)
+      starvation.sdpos = IS_SD_PRINTING() ? card.getIndex() : 0;
+    #endif
+  }
+
+#endif // PLANNER_STARVATION_REPORT
+
 
 /**************************************************
  ***************** GCode Handlers *****************
@@ -3442,6 +4042,9 @@ inline void gcode_G0_G1(
           const float echange = destination[E_CART] - current_position[E_CART];
           // Is this a retract or prime move?
           if (WITHIN(ABS(echange), MIN_AUTORETRACT, MAX_AUTORETRACT) && fwretract.retracted[active_extruder] == (echange > 0.0)) {
+            #if ENABLED(SEGMENT_COALESCING)
+              flush_coalesced_move();
+            #endif
             current_position[E_CART] = destination[E_CART]; // Hide a G1-based retract/prime from calculations
             sync_plan_position_e();                         // AND from the planner
             return fwretract.retract(echange < 0.0);        // Firmware-based retract/prime (double-retract ignored)
@@ -3450,12 +4053,22 @@ inline void gcode_G0_G1(
       }
     #endif // FWRETRACT
 
+    #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+      planner.override_percentage = feedrate_percentage;
+    #endif
+
     #if IS_SCARA
       fast_move ? prepare_uninterpolated_move_to_destination() : prepare_move_to_destination();
+    #elif ENABLED(SEGMENT_COALESCING)
+      coalesce_move_to_destination();
     #else
       prepare_move_to_destination();
     #endif
 
+    #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+      planner.override_percentage = 0;
+    #endif
+
     #if ENABLED(NANODLP_Z_SYNC)
       #if ENABLED(NANODLP_ALL_AXIS)
         #define _MOVE_SYNC parser.seenval('X') || parser.seenval('Y') || parser.seenval('Z') // For any move wait and output sync message
@@ -3552,7 +4165,13 @@ inline void gcode_G0_G1(
         #endif
 
         // Send the arc to the planner
+        #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+          planner.override_percentage = feedrate_percentage;
+        #endif
         plan_arc(destination, arc_offset, clockwise);
+        #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+          planner.override_percentage = 0;
+        #endif
       }
       else {
         // Bad arguments
@@ -3624,7 +4243,13 @@ inline void gcode_G4() {
         parser.linearval('Q')
       };
 
+      #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+        planner.override_percentage = feedrate_percentage;
+      #endif
       plan_cubic_move(destination, offset);
+      #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+        planner.override_percentage = 0;
+      #endif
     }
   }
 
@@ -4636,7 +5261,7 @@ void home_all_axes() { gcode_G28(true); }
         }
 
         if (parser.seenval('Z'))
-          mbl.z_values[px][py] = parser.value_linear_units();
+          mbl.set_z(px, py, parser.value_linear_units());
         else {
           SERIAL_CHAR('Z'); echo_not_entered();
           return;
@@ -5270,6 +5895,10 @@ void home_all_axes() { gcode_G28(true); }
 
         measured_z = 0;
 
+        #if ENABLED(PROBE_SCAN)
+          if (!faux) probe_scan_start();
+        #endif
+
         // Outer loop is Y with PROBE_Y_FIRST disabled
         for (uint8_t PR_OUTER_VAR = 0; PR_OUTER_VAR < PR_OUTER_END && !isnan(measured_z); PR_OUTER_VAR++) {
 
@@ -5335,6 +5964,10 @@ void home_all_axes() { gcode_G28(true); }
           } // inner
         } // outer
 
+        #if ENABLED(PROBE_SCAN)
+          probe_scan_end();
+        #endif
+
       #elif ENABLED(AUTO_BED_LEVELING_3POINT)
 
         // Probe at 3 arbitrary points
@@ -6453,6 +7086,52 @@ void home_all_axes() { gcode_G28(true); }
 
 #endif // HAS_MESH
 
+#if ENABLED(PATH_BLENDING)
+
+  /**
+   * G61: Exact path mode. Take every junction at the corner speed.
+   */
+  inline void gcode_G61() {
+    planner.blend_tolerance_mm = 0;
+    #if ENABLED(SEGMENT_COALESCING)
+      coalesce_deviation_mm = 0;
+    #endif
+  }
+
+  /**
+   * G64: Path blending mode
+   *
+   *   P<mm>  Furthest the path may be from the arc through short moves. Default BLEND_TOLERANCE_MM.
+   *   Q<mm>  Furthest a dropped point may be from a merged move. (Requires SEGMENT_COALESCING)
+   *
+   * With no parameters, report the current settings.
+   */
+  inline void gcode_G64() {
+    if (!parser.seen('P') && !parser.seen('Q')) {
+      SERIAL_ECHO_START();
+      SERIAL_ECHOPAIR("Path blending P", planner.blend_tolerance_mm);
+      #if ENABLED(SEGMENT_COALESCING)
+        SERIAL_ECHOPAIR(" Q", coalesce_deviation_mm);
+      #endif
+      SERIAL_EOL();
+      return;
+    }
+    if (parser.seen('P')) {
+      const float p = parser.has_value() ? parser.value_linear_units() : BLEND_TOLERANCE_MM;
+      if (WITHIN(p, 0, 1)) planner.blend_tolerance_mm = p;
+      else SERIAL_PROTOCOLLNPGM("?P value out of range (0-1).");
+    }
+    #if ENABLED(SEGMENT_COALESCING)
+      if (parser.seen('Q')) {
+        const float q = parser.has_value() ? parser.value_linear_units() : COALESCE_DEVIATION_MM;
+        if (WITHIN(q, 0, 1)) coalesce_deviation_mm = q;
+        else SERIAL_PROTOCOLLNPGM("?Q value out of range (0-1).");
+      }
+    #endif
+  }
+
+#endif // PATH_BLENDING
+
 /**
  * G92: Set current position to given X Y Z E
  */
@@ -7519,8 +8198,40 @@ inline void gcode_M17() {
 
   /**
    * M28: Start SD Write
+   *
+   * With BINARY_FILE_UPLOAD:
+   *
+   *   M28 B1 [S<bytes>] <filename>
+   *
+   *   Receive the file as binary packets. S pre-allocates the file.
+   *   Replies "BINARY_UPLOAD chunk:<max data bytes> window:<packets>".
    */
-  inline void gcode_M28() { card.openFile(parser.string_arg, false); }
+  inline void gcode_M28() {
+    #if ENABLED(BINARY_COMMAND_QUEUE)
+      queue_keeps_text = false; // From here card.saving keeps it, for a text upload only
+    #endif
+    #if ENABLED(BINARY_FILE_UPLOAD)
+      char *p = parser.string_arg;
+      if (p && p[0] == 'B' && p[1] == '1' && p[2] == ' ') {
+        p += 3;
+        while (*p == ' ') p++;
+        uint32_t size = 0;
+        if (*p == 'S') {
+          size = strtoul(p + 1, &p, 10);
+          while (*p == ' ') p++;
+        }
+        if (card.openBinaryUpload(p, size)) {
+          upload.state = BU_SYNC1;
+          upload.next_seq = 0;
+          upload.last_ms = millis();
+          SERIAL_PROTOCOLPAIR("BINARY_UPLOAD chunk:", BINARY_UPLOAD_CHUNK_SIZE);
+          SERIAL_PROTOCOLLNPAIR(" window:", BINARY_UPLOAD_WINDOW);
+        }
+        return;
+      }
+    #endif
+    card.openFile(parser.string_arg, false);
+  }
 
   /**
    * M29: Stop SD Write
@@ -7622,6 +8333,9 @@ inline void gcode_M31() {
    * M928: Start SD Write
    */
   inline void gcode_M928() {
+    #if ENABLED(BINARY_COMMAND_QUEUE)
+      queue_keeps_text = false; // From here card.saving keeps it
+    #endif
     card.openLogFile(parser.string_arg);
   }
 
@@ -8268,6 +8982,62 @@ inline void gcode_M77() { print_job_timer.stop(); }
   }
 #endif
 
+#if ENABLED(IDLE_TASK_SCHEDULER)
+
+  /**
+   * M102: Report the runs, deferrals and run times of the idle tasks
+   *
+   *   R  Reset the statistics after reporting
+   */
+  inline void gcode_M102() {
+    for (uint8_t t = 0; t < IDLE_TASKS; t++) {
+      SERIAL_ECHO_START();
+      serialprintPGM(idle_task_name(t));
+      SERIAL_ECHOPAIR(": runs:", idle_task_stats[t].runs);
+      SERIAL_ECHOPAIR(" deferred:", idle_task_stats[t].deferred);
+      SERIAL_ECHOPAIR(" total(ms):", idle_task_stats[t].total_us / 1000UL);
+      if (idle_task_stats[t].runs)
+        SERIAL_ECHOPAIR(" avg(us):", idle_task_stats[t].total_us / idle_task_stats[t].runs);
+      SERIAL_ECHOLNPAIR(" max(us):", idle_task_stats[t].max_us);
+      if (parser.seen('R')) {
+        idle_task_stats[t].runs = idle_task_stats[t].deferred = idle_task_stats[t].total_us = 0;
+        idle_task_stats[t].max_us = 0;
+      }
+    }
+  }
+
+#endif // IDLE_TASK_SCHEDULER
+
+#if ENABLED(PLANNER_STARVATION_REPORT)
+
+  /**
+   * M103: Report how often and how long the planner ran out of moves
+   *       during a print job, and the command that came next.
+   *
+   *   R  Reset the counters after reporting
+   */
+  inline void gcode_M103() {
+    SERIAL_ECHO_START();
+    SERIAL_ECHOPAIR("Planner starved:", starvation.events);
+    SERIAL_ECHOPAIR(" total(ms):", starvation.total_ms);
+    SERIAL_ECHOLNPAIR(" longest(ms):", starvation.longest_ms);
+    if (starvation.events) {
+      SERIAL_ECHO_START();
+      SERIAL_ECHOPGM("Last before: ");
+      SERIAL_ECHO(starvation.command);
+      #if ENABLED(SDSUPPORT)
+        if (starvation.sdpos) SERIAL_ECHOPAIR(" SD pos:", starvation.sdpos);
+      #endif
+      SERIAL_EOL();
+    }
+    if (parser.seen('R')) {
+      starvation.events = starvation.longest_ms = 0;
+      starvation.total_ms = 0;
+    }
+  }
+
+#endif // PLANNER_STARVATION_REPORT
+
 /**
  * M104: Set hot end temperature
  */
@@ -8578,6 +9348,10 @@ inline void gcode_M109() {
 
   } while (wait_for_heatup && TEMP_CONDITIONS);
 
+  #if ENABLED(PLANNER_STARVATION_REPORT)
+    planner.starved_ms = 0; // Ran dry waiting to heat
+  #endif
+
   if (wait_for_heatup) {
     lcd_reset_status();
     #if ENABLED(PRINTER_EVENT_LEDS)
@@ -8739,6 +9513,10 @@ inline void gcode_M109() {
 
     } while (wait_for_heatup && TEMP_BED_CONDITIONS);
 
+    #if ENABLED(PLANNER_STARVATION_REPORT)
+      planner.starved_ms = 0; // Ran dry waiting to heat
+    #endif
+
     #ifdef ANYCUBIC_TFT_MODEL
     AnycubicTFT.BedHeatingDone();
     #endif
@@ -9481,6 +10259,7 @@ inline void gcode_M121() { endstops.enable_globally(false); }
    *
    *    T<extruder> - Optional extruder number. Current extruder if omitted.
    *    D<linear> - Diameter of the filament. Use "D0" to switch back to linear units on the E axis.
+   *    L<float>  - Maximum volumetric flow in mm³/s. Use "L0" for no limit. (Requires VOLUMETRIC_EXTRUDER_LIMIT)
    */
   inline void gcode_M200() {
 
@@ -9493,6 +10272,16 @@ inline void gcode_M121() { endstops.enable_globally(false); }
       if ( (parser.volumetric_enabled = (parser.value_linear_units() != 0)) )
         planner.set_filament_size(target_extruder, parser.value_linear_units());
     }
+
+    #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+      if (parser.seenval('L')) {
+        const float lval = parser.value_float();
+        if (WITHIN(lval, 0, 100))
+          planner.volumetric_extruder_limit[target_extruder] = lval;
+        else
+          SERIAL_PROTOCOLLNPGM("?L value out of range (0-100).");
+      }
+    #endif
     planner.calculate_volumetric_multipliers();
   }
 
@@ -10243,6 +11032,18 @@ inline void gcode_M226() {
 
 #endif // HAS_LCD_CONTRAST
 
+#if ENABLED(LCD_DIRTY_REGIONS)
+
+  /**
+   * M251: Report the LCD refresh count, the refreshes skipped
+   *       because nothing changed, and the time spent drawing.
+   *
+   *   R  Reset the counters after reporting
+   */
+  inline void gcode_M251() { lcd_report_draw_stats(parser.seen('R')); }
+
+#endif // LCD_DIRTY_REGIONS
+
 #if ENABLED(PREVENT_COLD_EXTRUSION)
 
   /**
@@ -10519,6 +11320,9 @@ inline void gcode_M400() { planner.synchronize(); }
 #endif // FILAMENT_WIDTH_SENSOR
 
 void quickstop_stepper() {
+  #if ENABLED(SEGMENT_COALESCING)
+    discard_coalesced_move();
+  #endif
   planner.quick_stop();
   planner.synchronize();
   set_current_from_steppers_for_axis(ALL_AXES);
@@ -10647,7 +11451,9 @@ void quickstop_stepper() {
             for (uint8_t x = GRID_MAX_POINTS_X; x--;)
               for (uint8_t y = GRID_MAX_POINTS_Y; y--;)
                 Z_VALUES(x, y) -= zmean;
-            #if ENABLED(ABL_BILINEAR_SUBDIVISION)
+            #if ENABLED(MESH_BED_LEVELING)
+              mbl.reset_layer();
+            #elif ENABLED(ABL_BILINEAR_SUBDIVISION)
               bed_level_virt_interpolate();
             #endif
           }
@@ -10806,7 +11612,7 @@ void quickstop_stepper() {
       SERIAL_ERRORLNPGM(MSG_ERR_MESH_XY);
     }
     else
-      ubl.z_values[ix][iy] = hasN ? NAN : parser.value_linear_units() + (hasQ ? ubl.z_values[ix][iy] : 0);
+      ubl.set_z(ix, iy, hasN ? NAN : parser.value_linear_units() + (hasQ ? ubl.z_values[ix][iy] : 0));
   }
 
 #endif // AUTO_BED_LEVELING_UBL
@@ -10892,6 +11698,52 @@ inline void gcode_M502() {
   }
 #endif
 
+#if ENABLED(SETTINGS_PROFILES)
+
+  /**
+   * M506: Store or clear a settings profile
+   *
+   *   P<slot>  Store the current settings as profile <slot>
+   *   C        Clear profile <slot> instead
+   *
+   * With no P parameter report the stored profiles.
+   */
+  inline void gcode_M506() {
+    if (!parser.seenval('P')) return settings.report_profiles();
+    const int16_t slot = parser.value_int();
+    if (!WITHIN(slot, 0, SETTINGS_PROFILE_SLOTS - 1)) {
+      SERIAL_ERROR_START();
+      SERIAL_ERRORLNPGM("?Invalid profile slot.");
+      return;
+    }
+    if (parser.seen('C'))
+      settings.clear_profile(slot);
+    else
+      (void)settings.save_profile(slot);
+  }
+
+  /**
+   * M507: Load a settings profile
+   *
+   *   P<slot>  Profile to apply over the base settings.
+   *            Omit (or P-1) to restore the base settings.
+   *
+   * Queued moves are finished first since postprocess()
+   * re-seeds the planner and stepper positions.
+   */
+  inline void gcode_M507() {
+    const int16_t slot = parser.intval('P', -1);
+    if (!WITHIN(slot, -1, SETTINGS_PROFILE_SLOTS - 1)) {
+      SERIAL_ERROR_START();
+      SERIAL_ERRORLNPGM("?Invalid profile slot.");
+      return;
+    }
+    planner.synchronize();
+    (void)settings.load_profile(slot);
+  }
+
+#endif // SETTINGS_PROFILES
+
 #if ENABLED(SDSUPPORT)
 
   /**
@@ -10914,6 +11766,72 @@ inline void gcode_M502() {
 
 #endif // ABORT_ON_ENDSTOP_HIT_FEATURE_ENABLED
 
+#if ENABLED(INPUT_SHAPING)
+
+  /**
+   * M593: Set or report the X/Y input shaper
+   *
+   *  X Y       Axes to set. Both if neither is given.
+   *  F<hz>     Resonant frequency. 0 leaves the axis unshaped.
+   *  D<zeta>   Damping ratio (0-0.5)
+   *  T<type>   Shaper for both axes: 0=ZV 1=MZV 2=EI
+   *
+   * With no F, D or T report the settings and how many steps
+   * were output unshaped because the step history was full.
+   */
+  inline void gcode_M593() {
+    const bool seen_x = parser.seen('X'), seen_y = parser.seen('Y'),
+               set_x = seen_x || !seen_y, set_y = seen_y || !seen_x;
+    bool changed = false;
+
+    if (parser.seenval('T')) {
+      const uint8_t t = parser.value_byte();
+      if (t < SHAPER_COUNT) {
+        input_shaping.type = t;
+        changed = true;
+      }
+      else
+        SERIAL_PROTOCOLLNPGM("?T value out of range (0-2).");
+    }
+
+    if (parser.seenval('F')) {
+      const float f = parser.value_float();
+      if (f >= 0) {
+        if (set_x) input_shaping.frequency[X_AXIS] = f;
+        if (set_y) input_shaping.frequency[Y_AXIS] = f;
+        changed = true;
+      }
+      else
+        SERIAL_PROTOCOLLNPGM("?F value out of range (>= 0).");
+    }
+
+    if (parser.seenval('D')) {
+      const float d = parser.value_float();
+      if (WITHIN(d, 0, 0.5)) {
+        if (set_x) input_shaping.zeta[X_AXIS] = d;
+        if (set_y) input_shaping.zeta[Y_AXIS] = d;
+        changed = true;
+      }
+      else
+        SERIAL_PROTOCOLLNPGM("?D value out of range (0-0.5).");
+    }
+
+    if (changed) {
+      input_shaping.refresh();
+      return;
+    }
+
+    SERIAL_ECHO_START();
+    SERIAL_ECHOPAIR("Shaper T", int(input_shaping.type));
+    SERIAL_ECHOPAIR(" X F", input_shaping.frequency[X_AXIS]);
+    SERIAL_ECHOPAIR(" D", input_shaping.zeta[X_AXIS]);
+    SERIAL_ECHOPAIR(" Y F", input_shaping.frequency[Y_AXIS]);
+    SERIAL_ECHOPAIR(" D", input_shaping.zeta[Y_AXIS]);
+    SERIAL_ECHOLNPAIR(" Unshaped steps:", stepper.shaping_overflows);
+  }
+
+#endif // INPUT_SHAPING
+
 #if HAS_BED_PROBE
 
   inline void gcode_M851() {
@@ -11501,14 +12419,35 @@ inline void gcode_M502() {
 #endif // LIN_ADVANCE
 
 #if HAS_TRINAMIC
-  #if ENABLED(TMC_DEBUG)
+  #if ENABLED(TMC_DEBUG) || ENABLED(TMC_ASYNC_MONITOR)
+    /**
+     * M122: Debug TMC drivers
+     *
+     *   S<bool> - Enable/disable the periodic status report (Requires TMC_DEBUG)
+     *   C       - Report the cached readings of the driver monitor (Requires TMC_ASYNC_MONITOR)
+     *   L       - Report the stallGuard load histograms and stall events (Requires STALLGUARD_LOAD_LOG)
+     *   R       - Clear the stallGuard load log (Requires STALLGUARD_LOAD_LOG)
+     */
     inline void gcode_M122() {
-      if (parser.seen('S'))
-        tmc_set_report_status(parser.value_bool());
-      else
-        tmc_report_all();
+      #if ENABLED(STALLGUARD_LOAD_LOG)
+        const bool load_log = parser.seen('L'), reset = parser.seen('R');
+        if (load_log) tmc_report_load_log();
+        if (reset) tmc_load_log_reset();
+        if (load_log || reset) return;
+      #endif
+      #if ENABLED(TMC_ASYNC_MONITOR)
+        if (parser.seen('C')) return tmc_report_cached();
+      #endif
+      #if ENABLED(TMC_DEBUG)
+        if (parser.seen('S'))
+          tmc_set_report_status(parser.value_bool());
+        else
+          tmc_report_all();
+      #else
+        tmc_report_cached();
+      #endif
     }
-  #endif // TMC_DEBUG
+  #endif // TMC_DEBUG || TMC_ASYNC_MONITOR
 
   /**
    * M906: Set motor current in milliamps using axis codes X, Y, Z, E
@@ -12782,6 +13721,11 @@ inline void gcode_T(const uint8_t tmp_extruder) {
 void process_parsed_command() {
   KEEPALIVE_STATE(IN_HANDLER);
 
+  #if ENABLED(SEGMENT_COALESCING)
+    // Only another G0/G1 may follow a held move
+    if (parser.command_letter != 'G' || parser.codenum > 1) flush_coalesced_move();
+  #endif
+
   // Handle a known G, M, or T
   switch (parser.command_letter) {
     case 'G': switch (parser.codenum) {
@@ -12826,6 +13770,10 @@ void process_parsed_command() {
         case 21: gcode_G21(); break;                              // G21: Millimeter Units
       #endif
 
+      #if ENABLED(LA_CALIBRATION_PATTERN)
+        case 25: gcode_G25(); break;                              // G25: Linear Advance Calibration Pattern
+      #endif
+
       #if ENABLED(G26_MESH_VALIDATION)
         case 26: gcode_G26(); break;                              // G26: Mesh Validation Pattern
       #endif
@@ -12864,6 +13812,11 @@ void process_parsed_command() {
         case 42: gcode_G42(); break;                              // G42: Move to mesh point
       #endif
 
+      #if ENABLED(PATH_BLENDING)
+        case 61: gcode_G61(); break;                              // G61: Exact path mode
+        case 64: gcode_G64(); break;                              // G64: Path blending mode
+      #endif
+
       case 90: relative_mode = false; break;                      // G90: Absolute coordinates
       case 91: relative_mode = true; break;                       // G91: Relative coordinates
 
@@ -12944,6 +13897,14 @@ void process_parsed_command() {
         case 100: gcode_M100(); break;                            // M100: Free Memory Report
       #endif
 
+      #if ENABLED(IDLE_TASK_SCHEDULER)
+        case 102: gcode_M102(); break;                            // M102: Report Idle Task Statistics
+      #endif
+
+      #if ENABLED(PLANNER_STARVATION_REPORT)
+        case 103: gcode_M103(); break;                            // M103: Report Planner Starvation
+      #endif
+
       case 104: gcode_M104(); break;                              // M104: Set Hotend Temperature
       case 110: gcode_M110(); break;                              // M110: Set Current Line Number
       case 111: gcode_M111(); break;                              // M111: Set Debug Flags
@@ -13076,6 +14037,10 @@ void process_parsed_command() {
         case 250: gcode_M250(); break;                            // M250: Set LCD Contrast
       #endif
 
+      #if ENABLED(LCD_DIRTY_REGIONS)
+        case 251: gcode_M251(); break;                            // M251: Report LCD drawing time
+      #endif
+
       #if ENABLED(EXPERIMENTAL_I2CBUS)
         case 260: gcode_M260(); break;                            // M260: Send Data to i2c slave
         case 261: gcode_M261(); break;                            // M261: Request Data from i2c slave
@@ -13153,6 +14118,10 @@ void process_parsed_command() {
       #if ENABLED(EEPROM_SETTINGS)
         case 504: gcode_M504(); break;                            // M504: Validate EEPROM
       #endif
+      #if ENABLED(SETTINGS_PROFILES)
+        case 506: gcode_M506(); break;                            // M506: Store/Clear/Report Settings Profiles
+        case 507: gcode_M507(); break;                            // M507: Load Settings Profile
+      #endif
 
       #if ENABLED(SDSUPPORT)
         case 524: gcode_M524(); break;                            // M524: Abort SD print job
@@ -13162,6 +14131,10 @@ void process_parsed_command() {
         case 540: gcode_M540(); break;                            // M540: Set Abort on Endstop Hit for SD Printing
       #endif
 
+      #if ENABLED(INPUT_SHAPING)
+        case 593: gcode_M593(); break;                            // M593: Set X/Y Input Shaper
+      #endif
+
       #if ENABLED(ADVANCED_PAUSE_FEATURE)
         case 600: gcode_M600(); break;                            // M600: Pause for Filament Change
         case 603: gcode_M603(); break;                            // M603: Configure Filament Change
@@ -13229,7 +14202,7 @@ void process_parsed_command() {
       #endif
 
       #if HAS_DRIVER(TMC2130) || HAS_DRIVER(TMC2208)
-        #if ENABLED(TMC_DEBUG)
+        #if ENABLED(TMC_DEBUG) || ENABLED(TMC_ASYNC_MONITOR)
           case 122: gcode_M122(); break;                          // M122: Debug TMC steppers
         #endif
         case 906: gcode_M906(); break;                            // M906: Set motor current in milliamps using axis codes X, Y, Z, E
@@ -13262,7 +14235,12 @@ void process_parsed_command() {
 }
 
 void process_next_command() {
-  char * const current_command = command_queue[cmd_queue_index_r];
+  #if ENABLED(BINARY_COMMAND_QUEUE)
+    const gcode_record_t * const rec = current_record();
+    char * const current_command = rec->text ? rec->command_text() : (char*)"";
+  #else
+    char * const current_command = command_queue[cmd_queue_index_r];
+  #endif
 
   if (DEBUGGING(ECHO)) {
     SERIAL_ECHO_START();
@@ -13273,8 +14251,31 @@ void process_next_command() {
     #endif
   }
 
+  #if ENABLED(PLANNER_STARVATION_REPORT)
+    #if ENABLED(BINARY_COMMAND_QUEUE)
+      if (!rec->text) {
+        // No text was kept, so note the command code
+        char code[8];
+        sprintf_P(code, PSTR("%c%i"), rec->letter, rec->codenum);
+        note_planner_starvation(code);
+      }
+      else
+    #endif
+        note_planner_starvation(current_command);
+  #endif
+
   // Parse the next command in the queue
-  parser.parse(current_command);
+  #if ENABLED(BINARY_COMMAND_QUEUE)
+    parser.load(rec);
+  #else
+    #if ENABLED(SERIAL_LINE_TOKENIZER)
+      const gcode_tokens_t &tokens = command_tokens[cmd_queue_index_r];
+      if (tokens.cmd != 0xFF)
+        parser.parse(current_command, tokens);
+      else
+    #endif
+        parser.parse(current_command);
+  #endif
   process_parsed_command();
 }
 
@@ -13300,16 +14301,28 @@ void flush_and_request_resend() {
  *   B<int>  Block queue space remaining
  */
 void ok_to_send() {
-  if (!send_ok[cmd_queue_index_r]) return;
+  #if ENABLED(BINARY_COMMAND_QUEUE)
+    const gcode_record_t * const rec = current_record();
+    if (!(rec->flags & RECORD_SAY_OK)) return;
+  #else
+    if (!send_ok[cmd_queue_index_r]) return;
+  #endif
   SERIAL_PROTOCOLPGM(MSG_OK);
   #if ENABLED(ADVANCED_OK)
-    char* p = command_queue[cmd_queue_index_r];
-    if (*p == 'N') {
-      SERIAL_PROTOCOL(' ');
-      SERIAL_ECHO(*p++);
-      while (NUMERIC_SIGNED(*p))
+    #if ENABLED(BINARY_COMMAND_QUEUE)
+      if (rec->flags & RECORD_HAS_N) {
+        SERIAL_PROTOCOLPGM(" N");
+        SERIAL_PROTOCOL(rec->N);
+      }
+    #else
+      char* p = command_queue[cmd_queue_index_r];
+      if (*p == 'N') {
+        SERIAL_PROTOCOL(' ');
         SERIAL_ECHO(*p++);
-    }
+        while (NUMERIC_SIGNED(*p))
+          SERIAL_ECHO(*p++);
+      }
+    #endif
     SERIAL_PROTOCOLPGM(" P"); SERIAL_PROTOCOL(int(BLOCK_BUFFER_SIZE - planner.movesplanned() - 1));
     SERIAL_PROTOCOLPGM(" B"); SERIAL_PROTOCOL(BUFSIZE - commands_in_queue);
   #endif
@@ -14405,6 +15418,125 @@ void prepare_move_to_destination() {
   set_current_from_destination();
 }
 
+#if ENABLED(SEGMENT_COALESCING)
+
+  /**
+   * Merge runs of short, nearly collinear G0/G1 moves into one move.
+   *
+   * The first short move is held back, with current_position already at its
+   * end. Each following short move either extends it or sends it on through
+   * prepare_move_to_destination(). A merged move must keep the same feedrate,
+   * Z height and extrusion per mm, and every point it drops must lie within
+   * coalesce_deviation_mm of it. Any other command sends the held move first.
+   */
+  static struct {
+    bool pending;
+    uint8_t points;                         // Points dropped so far
+    float start[XYZE],                      // Where the held move starts
+          feedrate_mm_s,
+          length;                           // Length of the path it replaces
+    float point[COALESCE_MAX_POINTS][2];    // The dropped points
+  } coalesce;
+
+  /**
+   * Send the held move, if any, to the planner
+   */
+  void flush_coalesced_move() {
+    if (!coalesce.pending) return;
+    coalesce.pending = false;
+
+    float saved_destination[XYZE];
+    COPY(saved_destination, destination);
+    const float saved_feedrate_mm_s = feedrate_mm_s;
+
+    set_destination_from_current();
+    COPY(current_position, coalesce.start);
+    feedrate_mm_s = coalesce.feedrate_mm_s;
+    #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+      const int16_t saved_override = planner.override_percentage;
+      planner.override_percentage = feedrate_percentage;
+    #endif
+
+    prepare_move_to_destination();
+
+    #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+      planner.override_percentage = saved_override;
+    #endif
+    feedrate_mm_s = saved_feedrate_mm_s;
+    COPY(destination, saved_destination);
+  }
+
+  /**
+   * Drop the held move. For a quick stop, which resets current_position.
+   */
+  inline void discard_coalesced_move() { coalesce.pending = false; }
+
+  /**
+   * Try to extend the held move to the destination by dropping the
+   * current position. Return false if the result would be off the path.
+   */
+  static bool coalesce_extend(const float &seg_length) {
+    if (coalesce.points >= COALESCE_MAX_POINTS || feedrate_mm_s != coalesce.feedrate_mm_s) return false;
+
+    // Keep the same extrusion per mm, within 5%
+    const float held_rate = (current_position[E_CART] - coalesce.start[E_CART]) / coalesce.length,
+                seg_rate = (destination[E_CART] - current_position[E_CART]) / seg_length;
+    if (ABS(seg_rate - held_rate) > ABS(held_rate) * 0.05f + 0.00001f) return false;
+
+    // A path longer than the new move means a turn or a reversal
+    const float dx = destination[X_AXIS] - coalesce.start[X_AXIS],
+                dy = destination[Y_AXIS] - coalesce.start[Y_AXIS],
+                chord = HYPOT(dx, dy);
+    if (chord < 0.001f || coalesce.length + seg_length > chord + coalesce_deviation_mm) return false;
+
+    // Every dropped point must stay within the deviation of the new move
+    coalesce.point[coalesce.points][X_AXIS] = current_position[X_AXIS];
+    coalesce.point[coalesce.points][Y_AXIS] = current_position[Y_AXIS];
+    const float max_cross = coalesce_deviation_mm * chord;
+    for (uint8_t i = 0; i <= coalesce.points; i++) {
+      const float cross = dx * (coalesce.point[i][Y_AXIS] - coalesce.start[Y_AXIS])
+                        - dy * (coalesce.point[i][X_AXIS] - coalesce.start[X_AXIS]);
+      if (ABS(cross) > max_cross) return false;
+    }
+
+    coalesce.points++;
+    coalesce.length += seg_length;
+    return true;
+  }
+
+  /**
+   * Buffer a G0/G1 move, merging it with the held move where possible
+   */
+  static void coalesce_move_to_destination() {
+    clamp_to_software_endstops(destination);
+
+    const float seg_length = HYPOT(destination[X_AXIS] - current_position[X_AXIS], destination[Y_AXIS] - current_position[Y_AXIS]);
+    const bool is_short = seg_length < (COALESCE_SEGMENT_MM) && seg_length > 0.0001f
+                          && destination[Z_AXIS] == current_position[Z_AXIS];
+
+    if (coalesce.pending) {
+      if (is_short && coalesce_extend(seg_length)) {
+        set_current_from_destination();
+        return;
+      }
+      flush_coalesced_move();
+    }
+
+    if (is_short) {
+      // Hold the move to see if the next one continues it
+      COPY(coalesce.start, current_position);
+      coalesce.feedrate_mm_s = feedrate_mm_s;
+      coalesce.length = seg_length;
+      coalesce.points = 0;
+      coalesce.pending = true;
+      set_current_from_destination();
+    }
+    else
+      prepare_move_to_destination();
+  }
+
+#endif // SEGMENT_COALESCING
+
 #if ENABLED(ARC_SUPPORT)
 
   #if N_ARC_CORRECTION < 1
@@ -14877,7 +16009,7 @@ void manage_inactivity(const bool ignore_stepper_queue/*=false*/) {
   AnycubicTFT.FilamentRunout();
   #endif
 
-  if (commands_in_queue < BUFSIZE) get_available_commands();
+  if (command_queue_has_room()) get_available_commands();
 
   const millis_t ms = millis();
 
@@ -15073,21 +16205,22 @@ void idle(
     bool no_stepper_sleep/*=false*/
   #endif
 ) {
+  #if ENABLED(IDLE_TASK_SCHEDULER)
+    const uint32_t idle_start_us = micros();
+  #endif
+
   #if ENABLED(MAX7219_DEBUG)
     max7219.idle_tasks();
   #endif
 
-#ifdef ANYCUBIC_TFT_MODEL
-  AnycubicTFT.CommandScan();
-#endif
-
 #ifdef ENDSTOP_BEEP
   EndstopBeep();
 #endif
 
-  lcd_update();
-
-  host_keepalive();
+  #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+    // Catch speed changes from M220, the LCD, or the TFT
+    planner.update_feedrate_override(feedrate_percentage);
+  #endif
 
   manage_inactivity(
     #if ENABLED(ADVANCED_PAUSE_FEATURE)
@@ -15105,24 +16238,44 @@ void idle(
     buzzer.tick();
   #endif
 
-  #if ENABLED(I2C_POSITION_ENCODERS)
-    static millis_t i2cpem_next_update_ms;
-    if (planner.has_blocks_queued() && ELAPSED(millis(), i2cpem_next_update_ms)) {
-      I2CPEM.update();
-      i2cpem_next_update_ms = millis() + I2CPE_MIN_UPD_TIME_MS;
-    }
-  #endif
+  #if ENABLED(IDLE_TASK_SCHEDULER)
 
-  #if HAS_AUTO_REPORTING
-    if (!suspend_auto_report) {
-      #if ENABLED(AUTO_REPORT_TEMPERATURES)
-        thermalManager.auto_report_temperatures();
-      #endif
-      #if ENABLED(AUTO_REPORT_SD_STATUS)
-        card.auto_report_sd_status();
-      #endif
-    }
-  #endif
+    run_idle_tasks(idle_start_us);
+
+  #else
+
+    #ifdef ANYCUBIC_TFT_MODEL
+      AnycubicTFT.CommandScan();
+    #endif
+
+    lcd_update();
+
+    host_keepalive();
+
+    #if ENABLED(SD_LOG_BUFFER)
+      card.manageLog();
+    #endif
+
+    #if ENABLED(I2C_POSITION_ENCODERS)
+      static millis_t i2cpem_next_update_ms;
+      if (planner.has_blocks_queued() && ELAPSED(millis(), i2cpem_next_update_ms)) {
+        I2CPEM.update();
+        i2cpem_next_update_ms = millis() + I2CPE_MIN_UPD_TIME_MS;
+      }
+    #endif
+
+    #if HAS_AUTO_REPORTING
+      if (!suspend_auto_report) {
+        #if ENABLED(AUTO_REPORT_TEMPERATURES)
+          thermalManager.auto_report_temperatures();
+        #endif
+        #if ENABLED(AUTO_REPORT_SD_STATUS)
+          card.auto_report_sd_status();
+        #endif
+      }
+    #endif
+
+  #endif // !IDLE_TASK_SCHEDULER
 }
 
 /**
@@ -15280,7 +16433,9 @@ void setup() {
   SERIAL_ECHOLNPAIR(MSG_PLANNER_BUFFER_BYTES, int(sizeof(block_t))*(BLOCK_BUFFER_SIZE));
 
   // Send "ok" after commands by default
-  for (int8_t i = 0; i < BUFSIZE; i++) send_ok[i] = true;
+  #if DISABLED(BINARY_COMMAND_QUEUE)
+    for (int8_t i = 0; i < BUFSIZE; i++) send_ok[i] = true;
+  #endif
 
   // Load data from EEPROM if available (or use defaults)
   // This also updates variables in the planner, elsewhere
@@ -15502,14 +16657,19 @@ void loop() {
 
   #endif // SDSUPPORT
 
-  if (commands_in_queue < BUFSIZE) get_available_commands();
+  if (command_queue_has_room()) get_available_commands();
 
   if (commands_in_queue) {
 
     #if ENABLED(SDSUPPORT)
 
       if (card.saving) {
-        char* command = command_queue[cmd_queue_index_r];
+        #if ENABLED(BINARY_COMMAND_QUEUE)
+          const gcode_record_t * const rec = current_record();
+          char* command = rec->text ? rec->command_text() : (char*)"";
+        #else
+          char* command = command_queue[cmd_queue_index_r];
+        #endif
         if (strstr_P(command, PSTR("M29"))) {
           // M29 closes the file
           card.closefile();
@@ -15551,9 +16711,19 @@ void loop() {
     // The queue may be reset by a command handler or by code invoked by idle() within a handler
     if (commands_in_queue) {
       --commands_in_queue;
-      if (++cmd_queue_index_r >= BUFSIZE) cmd_queue_index_r = 0;
+      #if ENABLED(BINARY_COMMAND_QUEUE)
+        cmd_queue_index_r += current_record()->size;
+      #else
+        if (++cmd_queue_index_r >= BUFSIZE) cmd_queue_index_r = 0;
+      #endif
     }
   }
+
+  #if ENABLED(SEGMENT_COALESCING)
+    // Don't hold a move while waiting for the next command
+    if (!commands_in_queue) flush_coalesced_move();
+  #endif
+
   endstops.event_handler();
   idle();
 
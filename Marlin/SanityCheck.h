@@ -421,6 +421,44 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
   #error "Graphical LCD is required for SHOW_CUSTOM_BOOTSCREEN and CUSTOM_STATUS_SCREEN_IMAGE."
 #endif
 
+/**
+ * Probe Scan
+ */
+#if ENABLED(PROBE_SCAN)
+  #if !HAS_BED_PROBE
+    #error "PROBE_SCAN requires a bed probe."
+  #elif IS_KINEMATIC
+    #error "PROBE_SCAN is not supported for DELTA or SCARA."
+  #endif
+#endif
+
+/**
+ * SD Extent Map
+ */
+#if ENABLED(SD_EXTENT_MAP) && !WITHIN(SD_EXTENT_MAP_SIZE, 2, 255)
+  #error "SD_EXTENT_MAP_SIZE must be from 2 to 255."
+#endif
+
+/**
+ * Binary File Upload
+ */
+#if ENABLED(BINARY_FILE_UPLOAD)
+  #if DISABLED(SDSUPPORT)
+    #error "BINARY_FILE_UPLOAD requires SDSUPPORT."
+  #elif !WITHIN(BINARY_UPLOAD_CHUNK_SIZE, 16, 512)
+    #error "BINARY_UPLOAD_CHUNK_SIZE must be from 16 to 512."
+  #elif defined(RX_BUFFER_SIZE) && RX_BUFFER_SIZE < BINARY_UPLOAD_CHUNK_SIZE + 8
+    #error "BINARY_UPLOAD_CHUNK_SIZE is too large for RX_BUFFER_SIZE."
+  #endif
+#endif
+
+/**
+ * SD Log Buffer
+ */
+#if ENABLED(SD_LOG_BUFFER) && DISABLED(SDSUPPORT)
+  #error "SD_LOG_BUFFER requires SDSUPPORT."
+#endif
+
 /**
  * SD File Sorting
  */
@@ -456,6 +494,13 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
     #error "I2C_POSITION_ENCODERS requires BABYSTEPPING and BABYSTEP_XY."
   #elif !WITHIN(I2CPE_ENCODER_CNT, 1, 5)
     #error "I2CPE_ENCODER_CNT must be between 1 and 5."
+  #elif ENABLED(TWI_TRANSACTION_QUEUE) && !WITHIN(I2CPE_EC_FILTER, 0, 4)
+    #error "I2CPE_EC_FILTER must be between 0 and 4."
+  #elif ENABLED(TWI_TRANSACTION_QUEUE) && I2CPE_EC_MAX_STEPS < 1
+    #error "I2CPE_EC_MAX_STEPS must be 1 or more."
+  #endif
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    static_assert(WITHIN(I2CPE_EC_GAIN, 0, 1), "I2CPE_EC_GAIN must be between 0 and 1.");
   #endif
 #endif
 
@@ -963,6 +1008,8 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
     #error "MESH_BED_LEVELING is not compatible with DELTA printers."
   #elif GRID_MAX_POINTS_X > 9 || GRID_MAX_POINTS_Y > 9
     #error "GRID_MAX_POINTS_X and GRID_MAX_POINTS_Y must be less than 10 for MBL."
+  #elif ENABLED(MESH_FADE_PER_LAYER) && DISABLED(ENABLE_LEVELING_FADE_HEIGHT)
+    #error "MESH_FADE_PER_LAYER requires ENABLE_LEVELING_FADE_HEIGHT."
   #endif
 
 #endif
@@ -1374,6 +1421,23 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
   #endif
 #endif
 
+/**
+ * TWI transaction queue
+ */
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+  #ifndef __AVR__
+    #error "TWI_TRANSACTION_QUEUE requires an AVR board."
+  #elif ENABLED(EXPERIMENTAL_I2CBUS) && I2C_SLAVE_ADDRESS > 0
+    #error "TWI_TRANSACTION_QUEUE is master only. Set I2C_SLAVE_ADDRESS to 0."
+  #elif ENABLED(LCD_I2C_TYPE_PCF8575) || ENABLED(LCD_I2C_TYPE_PCA8574) || ENABLED(LCD_I2C_TYPE_MCP23017) || ENABLED(LCD_I2C_TYPE_MCP23008)
+    #error "TWI_TRANSACTION_QUEUE can't be used with an I2C LCD, which uses Wire."
+  #elif !WITHIN(TWI_QUEUE_SIZE, 2, 32)
+    #error "TWI_QUEUE_SIZE must be between 2 and 32."
+  #elif TWI_CLOCK_HZ > 400000 || (F_CPU) / (TWI_CLOCK_HZ) - 16 > 510
+    #error "TWI_CLOCK_HZ must be between about 31kHz and 400kHz."
+  #endif
+#endif
+
 /**
  * G38 Probe Target
  */
@@ -1515,7 +1579,7 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
 /**
  * TMC2208 software UART and ENDSTOP_INTERRUPTS both use pin change interrupts (PCI)
  */
-#if HAS_DRIVER(TMC2208) && ENABLED(ENDSTOP_INTERRUPTS_FEATURE) && !( \
+#if HAS_DRIVER(TMC2208) && (ENABLED(ENDSTOP_INTERRUPTS_FEATURE) || ENABLED(ENDSTOP_SCAN_MASK)) && !( \
        defined(X_HARDWARE_SERIAL ) \
     || defined(X2_HARDWARE_SERIAL) \
     || defined(Y_HARDWARE_SERIAL ) \
@@ -1527,7 +1591,7 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
     || defined(E2_HARDWARE_SERIAL) \
     || defined(E3_HARDWARE_SERIAL) \
     || defined(E4_HARDWARE_SERIAL) )
-  #error "select hardware UART for TMC2208 to use both TMC2208 and ENDSTOP_INTERRUPTS_FEATURE."
+  #error "select hardware UART for TMC2208 to use both TMC2208 and ENDSTOP_INTERRUPTS_FEATURE or ENDSTOP_SCAN_MASK."
 #endif
 
 #if ENABLED(SENSORLESS_HOMING)
@@ -1577,6 +1641,32 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
   #error "STEALTHCHOP requires TMC2130 or TMC2208 stepper drivers."
 #endif
 
+/**
+ * TMC_ASYNC_MONITOR requirements
+ */
+#if ENABLED(TMC_ASYNC_MONITOR)
+  #if DISABLED(MONITOR_DRIVER_STATUS)
+    #error "TMC_ASYNC_MONITOR requires MONITOR_DRIVER_STATUS."
+  #elif !defined(MONITOR_DRIVER_STATUS_INTERVAL_MS) || MONITOR_DRIVER_STATUS_INTERVAL_MS < 100
+    #error "TMC_ASYNC_MONITOR requires MONITOR_DRIVER_STATUS_INTERVAL_MS of 100 or more."
+  #endif
+#endif
+
+/**
+ * STALLGUARD_LOAD_LOG requirements
+ */
+#if ENABLED(STALLGUARD_LOAD_LOG)
+  #if DISABLED(TMC_ASYNC_MONITOR)
+    #error "STALLGUARD_LOAD_LOG requires TMC_ASYNC_MONITOR."
+  #elif !HAS_STALLGUARD
+    #error "STALLGUARD_LOAD_LOG requires at least one TMC2130 stepper driver."
+  #elif !(LOAD_LOG_BINS == 2 || LOAD_LOG_BINS == 4 || LOAD_LOG_BINS == 8 || LOAD_LOG_BINS == 16 || LOAD_LOG_BINS == 32)
+    #error "LOAD_LOG_BINS must be 2, 4, 8, 16 or 32."
+  #elif !WITHIN(LOAD_LOG_EVENTS, 1, 32)
+    #error "LOAD_LOG_EVENTS must be between 1 and 32."
+  #endif
+#endif
+
 /**
  * Digipot requirement
  */
@@ -1702,4 +1792,140 @@ static_assert(COUNT(sanity_arr_3) <= NUM_AXIS_N, "DEFAULT_MAX_ACCELERATION has t
   #error "POWER_LOSS_RECOVERY currently requires an LCD Controller."
 #endif
 
+#if ENABLED(SETTINGS_PROFILES)
+  #if DISABLED(EEPROM_SETTINGS)
+    #error "SETTINGS_PROFILES requires EEPROM_SETTINGS."
+  #elif !WITHIN(SETTINGS_PROFILE_SLOTS, 1, 16)
+    #error "SETTINGS_PROFILE_SLOTS must be between 1 and 16."
+  #elif !WITHIN(SETTINGS_PROFILE_MAX_DELTAS, 1, 40)
+    #error "SETTINGS_PROFILE_MAX_DELTAS must be between 1 and 40."
+  #endif
+#endif
+
+#if ENABLED(SERIAL_LINE_TOKENIZER) && DISABLED(FASTER_GCODE_PARSER)
+  #error "SERIAL_LINE_TOKENIZER requires FASTER_GCODE_PARSER."
+#endif
+
+#if ENABLED(BINARY_COMMAND_QUEUE)
+  #if DISABLED(FASTER_GCODE_PARSER)
+    #error "BINARY_COMMAND_QUEUE requires FASTER_GCODE_PARSER."
+  #elif ENABLED(SERIAL_LINE_TOKENIZER)
+    #error "BINARY_COMMAND_QUEUE already decodes each command once. Disable SERIAL_LINE_TOKENIZER."
+  #elif ENABLED(CNC_COORDINATE_SYSTEMS)
+    #error "BINARY_COMMAND_QUEUE is not compatible with CNC_COORDINATE_SYSTEMS."
+  #elif ENABLED(POWER_LOSS_RECOVERY)
+    #error "BINARY_COMMAND_QUEUE is not compatible with POWER_LOSS_RECOVERY."
+  #elif ENABLED(M100_FREE_MEMORY_WATCHER)
+    #error "BINARY_COMMAND_QUEUE is not compatible with M100_FREE_MEMORY_WATCHER."
+  #elif !WITHIN(BUFSIZE, 2, 255)
+    #error "BUFSIZE must be between 2 and 255 with BINARY_COMMAND_QUEUE."
+  #endif
+#endif
+
+/**
+ * LCD Dirty Regions
+ */
+#if ENABLED(LCD_DIRTY_REGIONS)
+  #if DISABLED(ULTRA_LCD)
+    #error "LCD_DIRTY_REGIONS requires a character or graphical LCD."
+  #elif ENABLED(LIGHTWEIGHT_UI)
+    #error "LCD_DIRTY_REGIONS is not compatible with LIGHTWEIGHT_UI, which already redraws only changed fields."
+  #elif ENABLED(LCD_SCREEN_ROT_90) || ENABLED(LCD_SCREEN_ROT_180) || ENABLED(LCD_SCREEN_ROT_270)
+    #error "LCD_DIRTY_REGIONS is not compatible with LCD_SCREEN_ROT_*."
+  #endif
+#endif
+
+/**
+ * Idle Task Scheduler
+ */
+#if ENABLED(IDLE_TASK_SCHEDULER)
+  #if !WITHIN(IDLE_PLANNER_LOW, 0, BLOCK_BUFFER_SIZE - 1)
+    #error "IDLE_PLANNER_LOW must be between 0 and BLOCK_BUFFER_SIZE - 1."
+  #elif IDLE_TIME_BUDGET_US < 100
+    #error "IDLE_TIME_BUDGET_US is too small for idle() to run any task."
+  #endif
+#endif
+
+/**
+ * Segment Coalescing
+ */
+#if ENABLED(SEGMENT_COALESCING)
+  #if IS_SCARA
+    #error "SEGMENT_COALESCING is not compatible with SCARA."
+  #elif !WITHIN(COALESCE_MAX_POINTS, 1, 32)
+    #error "COALESCE_MAX_POINTS must be between 1 and 32."
+  #endif
+  static_assert(COALESCE_DEVIATION_MM > 0, "COALESCE_DEVIATION_MM must be greater than 0.");
+#endif
+
+/**
+ * Path Blending
+ */
+#if ENABLED(PATH_BLENDING)
+  #if IS_KINEMATIC
+    #error "PATH_BLENDING requires a Cartesian machine."
+  #elif DISABLED(JUNCTION_DEVIATION)
+    #error "PATH_BLENDING requires JUNCTION_DEVIATION."
+  #endif
+  static_assert(WITHIN(BLEND_TOLERANCE_MM, 0, 1), "BLEND_TOLERANCE_MM must be between 0 and 1.");
+  static_assert(BLEND_SEGMENT_MM > 0, "BLEND_SEGMENT_MM must be greater than 0.");
+#endif
+
+/**
+ * Volumetric extrusion limit
+ */
+#if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+  #if ENABLED(NO_VOLUMETRICS)
+    #error "VOLUMETRIC_EXTRUDER_LIMIT requires NO_VOLUMETRICS to be disabled."
+  #endif
+  static_assert(WITHIN(DEFAULT_VOLUMETRIC_EXTRUDER_LIMIT, 0, 100), "DEFAULT_VOLUMETRIC_EXTRUDER_LIMIT must be between 0 and 100.");
+#endif
+
+/**
+ * Linear Advance calibration pattern
+ */
+#if ENABLED(LA_CALIBRATION_PATTERN)
+  #if DISABLED(LIN_ADVANCE)
+    #error "LA_CALIBRATION_PATTERN requires LIN_ADVANCE."
+  #elif IS_KINEMATIC
+    #error "LA_CALIBRATION_PATTERN requires a Cartesian machine."
+  #elif LA_CAL_MAX_LINES > 255
+    #error "LA_CAL_MAX_LINES must be 255 or less."
+  #endif
+  static_assert(LA_CAL_SLOW_FEEDRATE <= LA_CAL_FAST_FEEDRATE, "LA_CAL_SLOW_FEEDRATE must not exceed LA_CAL_FAST_FEEDRATE.");
+#endif
+
+/**
+ * Single ISR Linear Advance
+ */
+#if ENABLED(LA_SINGLE_ISR) && DISABLED(LIN_ADVANCE)
+  #error "LA_SINGLE_ISR requires LIN_ADVANCE."
+#endif
+
+/**
+ * Fractional Multistepping
+ */
+#if ENABLED(FRACTIONAL_MULTISTEPPING) && !WITHIN(MULTISTEP_FRACTION_BITS, 1, 3)
+  #error "MULTISTEP_FRACTION_BITS must be 1, 2 or 3."
+#endif
+
+/**
+ * Input Shaping
+ */
+#if ENABLED(INPUT_SHAPING)
+  #if IS_KINEMATIC || IS_CORE || ENABLED(HANGPRINTER)
+    #error "INPUT_SHAPING requires a Cartesian machine."
+  #elif ENABLED(DUAL_X_CARRIAGE)
+    #error "INPUT_SHAPING is not compatible with DUAL_X_CARRIAGE."
+  #elif ENABLED(ENDSTOPS_ALWAYS_ON_DEFAULT)
+    #error "INPUT_SHAPING doesn't shape moves with endstops enabled. Disable ENDSTOPS_ALWAYS_ON_DEFAULT."
+  #elif !WITHIN(SHAPING_TYPE, 0, 2)
+    #error "SHAPING_TYPE must be 0 (ZV), 1 (MZV) or 2 (EI)."
+  #elif !WITHIN(SHAPING_BUFFER_SIZE, 16, 256) || (SHAPING_BUFFER_SIZE & (SHAPING_BUFFER_SIZE - 1))
+    #error "SHAPING_BUFFER_SIZE must be a power of 2 from 16 to 256."
+  #endif
+  static_assert(WITHIN(SHAPING_ZETA_X, 0, 0.5) && WITHIN(SHAPING_ZETA_Y, 0, 0.5), "SHAPING_ZETA_[XY] must be between 0 and 0.5.");
+  static_assert(SHAPING_FREQ_X >= 0 && SHAPING_FREQ_Y >= 0, "SHAPING_FREQ_[XY] must be 0 or more.");
+#endif
+
 #endif // _SANITYCHECK_H_
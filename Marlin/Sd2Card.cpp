@@ -165,6 +165,11 @@
 
 // send command and return error code.  Return zero for OK
 uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
+  #if ENABLED(SD_STREAMING_READS)
+    // Any other command ends an open multiple block read
+    if (cmd != CMD12 && streamBlock_ != STREAM_NONE) readStop();
+  #endif
+
   // select card
   chipSelectLow();
 
@@ -299,6 +304,9 @@ bool Sd2Card::eraseSingleBlockEnable() {
  */
 bool Sd2Card::init(uint8_t sckRateID, pin_t chipSelectPin) {
   errorCode_ = type_ = 0;
+  #if ENABLED(SD_STREAMING_READS)
+    streamBlock_ = STREAM_NONE;
+  #endif
   chipSelectPin_ = chipSelectPin;
   // 16-bit init start time allows over a minute
   uint16_t t0 = (uint16_t)millis();
@@ -543,12 +551,18 @@ bool Sd2Card::readRegister(uint8_t cmd, void* buf) {
  * \return true for success, false for failure.
  */
 bool Sd2Card::readStart(uint32_t blockNumber) {
+  #if ENABLED(SD_STREAMING_READS)
+    const uint32_t firstBlock = blockNumber;
+  #endif
   if (type() != SD_CARD_TYPE_SDHC) blockNumber <<= 9;
   if (cardCommand(CMD18, blockNumber)) {
     error(SD_CARD_ERROR_CMD18);
     chipSelectHigh();
     return false;
   }
+  #if ENABLED(SD_STREAMING_READS)
+    streamBlock_ = firstBlock;
+  #endif
   chipSelectHigh();
   return true;
 }
@@ -559,6 +573,9 @@ bool Sd2Card::readStart(uint32_t blockNumber) {
  * \return true for success, false for failure.
  */
 bool Sd2Card::readStop() {
+  #if ENABLED(SD_STREAMING_READS)
+    streamBlock_ = STREAM_NONE;
+  #endif
   chipSelectLow();
   if (cardCommand(CMD12, 0)) {
     error(SD_CARD_ERROR_CMD12);
@@ -569,6 +586,33 @@ bool Sd2Card::readStop() {
   return true;
 }
 
+#if ENABLED(SD_STREAMING_READS)
+
+  /**
+   * Read a 512 byte block as part of a multiple block read.
+   *
+   * A block following the last one read comes straight from the open CMD18
+   * sequence, without a command of its own. Any other block starts a new
+   * sequence. On a read error the sequence is dropped and the block is read
+   * again with readBlock().
+   *
+   * \param[in] blockNumber Logical block to be read.
+   * \param[out] dst Pointer to the location that will receive the data.
+   * \return true for success, false for failure.
+   */
+  bool Sd2Card::readStream(uint32_t blockNumber, uint8_t* dst) {
+    if ((blockNumber == streamBlock_ || readStart(blockNumber)) && readData(dst)) {
+      streamBlock_++;
+      return true;
+    }
+
+    endStream();
+    errorCode_ = 0;
+    return readBlock(blockNumber, dst);
+  }
+
+#endif // SD_STREAMING_READS
+
 /**
  * Set the SPI clock rate.
  *
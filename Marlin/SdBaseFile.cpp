@@ -94,6 +94,9 @@ dir_t* SdBaseFile::cacheDirEntry(uint8_t action) {
  */
 bool SdBaseFile::close() {
   bool rtn = sync();
+  #if ENABLED(SD_STREAMING_READS)
+    if (flags_ & F_FILE_STREAM) stream(false);
+  #endif
   type_ = FAT_FILE_TYPE_CLOSED;
   return rtn;
 }
@@ -129,6 +132,85 @@ bool SdBaseFile::contiguousRange(uint32_t* bgnBlock, uint32_t* endBlock) {
   return false;
 }
 
+#if ENABLED(SD_EXTENT_MAP)
+
+  /**
+   * Map the cluster chain of a file opened read-only as runs of contiguous
+   * clusters, so that read() and seekSet() no longer need the FAT.
+   *
+   * The map is only used while this file stays open. It is dropped if the
+   * file needs more than SD_EXTENT_MAP_SIZE runs.
+   *
+   * \param[in] map Storage for the runs, owned by the caller.
+   *
+   * \return true for success, false if the chain doesn't fit or an I/O
+   * error occurred.
+   */
+  bool SdBaseFile::mapExtents(extent_map_t * const map) {
+    flags_ &= ~F_FILE_EXTENTS;
+    if (!isFile() || (flags_ & O_WRITE) || !firstCluster_ || !fileSize_) return false;
+
+    const uint32_t last = (fileSize_ - 1) >> (vol_->clusterSizeShift_ + 9);
+    uint32_t c = firstCluster_;
+    uint8_t n = 0;
+    map->run[0].index = 0;
+    map->run[0].cluster = c;
+    for (uint32_t index = 1; index <= last; index++) {
+      uint32_t next;
+      if (!vol_->fatGet(c, &next) || vol_->isEOC(next)) return false;
+      if (next != c + 1) {
+        if (++n >= SD_EXTENT_MAP_SIZE) return false;
+        map->run[n].index = index;
+        map->run[n].cluster = next;
+      }
+      c = next;
+    }
+    map->count = n + 1;
+    extents_ = map;
+    flags_ |= F_FILE_EXTENTS;
+    return true;
+  }
+
+  // cluster holding the given cluster index of the file
+  uint32_t SdBaseFile::extentCluster(const uint32_t index) const {
+    uint8_t lo = 0, hi = extents_->count - 1;
+    while (lo < hi) {
+      const uint8_t mid = (lo + hi + 1) >> 1;
+      if (extents_->run[mid].index <= index) lo = mid; else hi = mid - 1;
+    }
+    return extents_->run[lo].cluster + (index - extents_->run[lo].index);
+  }
+
+#endif // SD_EXTENT_MAP
+
+#if ENABLED(SD_STREAMING_READS)
+
+  /**
+   * Turn streaming reads on or off for a file opened read-only.
+   *
+   * While on, read() fetches blocks with a multiple block read (CMD18) that
+   * stays open between calls. A file whose clusters are contiguous also
+   * skips the FAT lookup at each cluster boundary.
+   *
+   * \param[in] onoff true to start streaming, false to end it.
+   */
+  void SdBaseFile::stream(const bool onoff) {
+    flags_ &= ~(F_FILE_STREAM | F_FILE_CONTIGUOUS);
+    if (onoff) {
+      if (!isFile() || (flags_ & O_WRITE)) return;
+      flags_ |= F_FILE_STREAM;
+      #if ENABLED(SD_EXTENT_MAP)
+        if (flags_ & F_FILE_EXTENTS) return; // the map already skips the FAT
+      #endif
+      uint32_t bgn, end;
+      if (contiguousRange(&bgn, &end)) flags_ |= F_FILE_CONTIGUOUS;
+    }
+    else
+      vol_->sdCard()->endStream();
+  }
+
+#endif // SD_STREAMING_READS
+
 /**
  * Create and open a new contiguous file of a specified size.
  *
@@ -1011,6 +1093,14 @@ int16_t SdBaseFile::read(void* buf, uint16_t nbyte) {
         // start of new cluster
         if (curPosition_ == 0)
           curCluster_ = firstCluster_;                      // use first cluster in file
+        #if ENABLED(SD_EXTENT_MAP)
+          else if (flags_ & F_FILE_EXTENTS)                 // look up next cluster in the map
+            curCluster_ = extentCluster(curPosition_ >> (vol_->clusterSizeShift_ + 9));
+        #endif
+        #if ENABLED(SD_STREAMING_READS)
+          else if (flags_ & F_FILE_CONTIGUOUS)
+            curCluster_++;                                  // next cluster follows this one
+        #endif
         else if (!vol_->fatGet(curCluster_, &curCluster_))  // get next cluster from FAT
           return -1;
       }
@@ -1023,10 +1113,22 @@ int16_t SdBaseFile::read(void* buf, uint16_t nbyte) {
 
     // no buffering needed if n == 512
     if (n == 512 && block != vol_->cacheBlockNumber()) {
+      #if ENABLED(SD_STREAMING_READS)
+        if (flags_ & F_FILE_STREAM) {
+          if (!vol_->readStream(block, dst)) return -1;
+        }
+        else
+      #endif
       if (!vol_->readBlock(block, dst)) return -1;
     }
     else {
       // read block to cache and copy data to caller
+      #if ENABLED(SD_STREAMING_READS)
+        if (flags_ & F_FILE_STREAM) {
+          if (!vol_->cacheStreamBlock(block)) return -1;
+        }
+        else
+      #endif
       if (!vol_->cacheRawBlock(block, SdVolume::CACHE_FOR_READ)) return -1;
       uint8_t* src = vol_->cache()->data + offset;
       memcpy(dst, src, n);
@@ -1391,6 +1493,14 @@ bool SdBaseFile::seekSet(const uint32_t pos) {
   nCur = (curPosition_ - 1) >> (vol_->clusterSizeShift_ + 9);
   nNew = (pos - 1) >> (vol_->clusterSizeShift_ + 9);
 
+  #if ENABLED(SD_EXTENT_MAP)
+    if (flags_ & F_FILE_EXTENTS) {
+      curCluster_ = extentCluster(nNew);
+      curPosition_ = pos;
+      return true;
+    }
+  #endif
+
   if (nNew < nCur || curPosition_ == 0)
     curCluster_ = firstCluster_;      // must follow chain from first cluster
   else
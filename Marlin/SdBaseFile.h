@@ -50,6 +50,20 @@ struct filepos_t {
   filepos_t() : position(0), cluster(0) {}
 };
 
+#if ENABLED(SD_EXTENT_MAP)
+  /**
+   * \struct extent_map_t
+   * \brief Runs of contiguous clusters making up an open file
+   */
+  struct extent_map_t {
+    uint8_t count;        // runs in use
+    struct {
+      uint32_t index,     // index of the first cluster of the run within the file
+               cluster;   // first cluster of the run on the volume
+    } run[SD_EXTENT_MAP_SIZE];
+  };
+#endif
+
 // use the gnu style oflag in open()
 uint8_t const O_READ = 0x01,                    // open() oflag for reading
               O_RDONLY = O_READ,                // open() oflag - same as O_IN
@@ -193,6 +207,12 @@ class SdBaseFile {
 
   bool close();
   bool contiguousRange(uint32_t* bgnBlock, uint32_t* endBlock);
+  #if ENABLED(SD_STREAMING_READS)
+    void stream(const bool onoff);
+  #endif
+  #if ENABLED(SD_EXTENT_MAP)
+    bool mapExtents(extent_map_t * const map);
+  #endif
   bool createContiguous(SdBaseFile* dirFile,
                         const char* path, uint32_t size);
   /**
@@ -356,6 +376,9 @@ class SdBaseFile {
 
   // bits defined in flags_
   static uint8_t const F_OFLAG = (O_ACCMODE | O_APPEND | O_SYNC),   // should be 0x0F
+                       F_FILE_EXTENTS = 0x10,                       // extents_ holds the cluster chain
+                       F_FILE_CONTIGUOUS = 0x20,                    // clusters follow one another, no FAT lookups
+                       F_FILE_STREAM = 0x40,                        // read blocks with multiple block reads
                        F_FILE_DIR_DIRTY = 0x80;                     // sync of directory entry required
 
   // private data
@@ -370,6 +393,11 @@ class SdBaseFile {
   uint32_t  firstCluster_;  // first cluster of file
   SdVolume* vol_;           // volume where file is located
 
+  #if ENABLED(SD_EXTENT_MAP)
+    extent_map_t* extents_;  // cluster runs, valid while F_FILE_EXTENTS is set
+    uint32_t extentCluster(const uint32_t index) const;
+  #endif
+
   /**
    * EXPERIMENTAL - Don't use!
    */
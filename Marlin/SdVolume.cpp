@@ -139,6 +139,20 @@ bool SdVolume::cacheRawBlock(uint32_t blockNumber, bool dirty) {
   return true;
 }
 
+#if ENABLED(SD_STREAMING_READS)
+
+  // like cacheRawBlock(blockNumber, CACHE_FOR_READ) but read as part of a stream
+  bool SdVolume::cacheStreamBlock(uint32_t blockNumber) {
+    if (cacheBlockNumber_ != blockNumber) {
+      if (!cacheFlush()) return false;
+      if (!sdCard_->readStream(blockNumber, cacheBuffer_.data)) return false;
+      cacheBlockNumber_ = blockNumber;
+    }
+    return true;
+  }
+
+#endif
+
 // return the size in bytes of a cluster chain
 bool SdVolume::chainSize(uint32_t cluster, uint32_t* size) {
   uint32_t s = 0;
@@ -170,6 +170,14 @@ class SdVolume {
     static bool cacheRawBlock(uint32_t blockNumber, bool dirty);
   #endif
 
+  #if ENABLED(SD_STREAMING_READS)
+    #if USE_MULTIPLE_CARDS
+      bool cacheStreamBlock(uint32_t blockNumber);
+    #else
+      static bool cacheStreamBlock(uint32_t blockNumber);
+    #endif
+  #endif
+
   // used by SdBaseFile write to assign cache to SD location
   void cacheSetBlockNumber(uint32_t blockNumber, bool dirty) {
     cacheDirty_ = dirty;
@@ -187,6 +195,9 @@ class SdVolume {
     return  cluster >= FAT32EOC_MIN;
   }
   bool readBlock(uint32_t block, uint8_t* dst) { return sdCard_->readBlock(block, dst); }
+  #if ENABLED(SD_STREAMING_READS)
+    bool readStream(uint32_t block, uint8_t* dst) { return sdCard_->readStream(block, dst); }
+  #endif
   bool writeBlock(uint32_t block, const uint8_t* dst) { return sdCard_->writeBlock(block, dst); }
 
   // Deprecated functions
@@ -30,6 +30,22 @@
 
 #include "blinkm.h"
 #include "leds.h"
+
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+
+#include "MarlinTWI.h"
+
+static uint8_t blinkm_data[5] = { 'o', 'n' }; // 'o' stops a running script
+static TWITransfer blinkm_xfer = { 0x09, sizeof(blinkm_data), 0, blinkm_data };
+
+void blinkm_set_led_color(const LEDColor &color) {
+  MarlinTWI::init();
+  const uint8_t rgb[] = { color.r, color.g, color.b };
+  MarlinTWI::refresh(blinkm_xfer, &blinkm_data[2], rgb, sizeof(rgb)); // Colors set in quick succession go out once
+}
+
+#else
+
 #include <Wire.h>
 
 void blinkm_set_led_color(const LEDColor &color) {
@@ -43,4 +59,6 @@ void blinkm_set_led_color(const LEDColor &color) {
   Wire.endTransmission();
 }
 
+#endif // !TWI_TRANSACTION_QUEUE
+
 #endif // BLINKM
@@ -35,6 +35,10 @@
   #include "power_loss_recovery.h"
 #endif
 
+#if ENABLED(BINARY_FILE_UPLOAD) && ENABLED(EMERGENCY_PARSER)
+  #include "emergency_parser.h"
+#endif
+
 CardReader::CardReader() {
   #if ENABLED(SDCARD_SORT_ALPHA)
     sort_count = 0;
@@ -45,6 +49,9 @@ CardReader::CardReader() {
     #endif
   #endif
   sdprinting = cardOK = saving = logging = false;
+  #if ENABLED(BINARY_FILE_UPLOAD)
+    uploading = false;
+  #endif
   filesize = 0;
   sdpos = 0;
   file_subcall_ctr = 0;
@@ -324,6 +331,10 @@ void CardReader::stopSDPrint(
 
 void CardReader::openLogFile(char * const path) {
   logging = true;
+  #if ENABLED(SD_LOG_BUFFER)
+    write_buffer_count = 0;
+    log_pending = false;
+  #endif
   openFile(path, false);
 }
 
@@ -399,6 +410,12 @@ void CardReader::openFile(char * const path, const bool read, const bool subcall
 
   if (read) {
     if (file.open(curDir, fname, O_READ)) {
+      #if ENABLED(SD_EXTENT_MAP)
+        file.mapExtents(&fileExtents);
+      #endif
+      #if ENABLED(SD_STREAMING_READS)
+        file.stream(true);
+      #endif
       filesize = file.fileSize();
       sdpos = 0;
       SERIAL_PROTOCOLPAIR(MSG_SD_FILE_OPENED, fname);
@@ -418,7 +435,7 @@ void CardReader::openFile(char * const path, const bool read, const bool subcall
     }
   }
   else { //write
-    if (!file.open(curDir, fname, O_CREAT | O_APPEND | O_WRITE | O_TRUNC)) {
+    if (!file.open(curDir, fname, O_CREAT | O_WRITE | O_TRUNC)) {
       SERIAL_PROTOCOLPAIR(MSG_SD_OPEN_FILE_FAIL, fname);
       SERIAL_PROTOCOLCHAR('.');
       SERIAL_EOL();
@@ -479,6 +496,18 @@ void CardReader::write_command(char *buf) {
   end[1] = '\r';
   end[2] = '\n';
   end[3] = '\0';
+  #if ENABLED(SD_LOG_BUFFER)
+    if (logging) {
+      const millis_t ms = millis();
+      if (!log_pending) {
+        log_pending = true;
+        log_pending_ms = ms;
+      }
+      log_write_ms = ms;
+      if (!bufferedWrite((uint8_t*)begin, end + 3 - begin)) file.writeError = true;
+    }
+    else
+  #endif
   file.write(begin);
   if (file.writeError) {
     SERIAL_ERROR_START();
@@ -526,6 +555,9 @@ void CardReader::beginautostart() {
 }
 
 void CardReader::closefile(const bool store_location) {
+  #if ENABLED(SD_LOG_BUFFER)
+    if (logging) flushWriteBuffer();
+  #endif
   file.sync();
   file.close();
   saving = logging = false;
@@ -536,6 +568,126 @@ void CardReader::closefile(const bool store_location) {
   }
 }
 
+#if HAS_SD_WRITE_BUFFER
+
+  /**
+   * Append to the file, writing each sector to the card as it fills.
+   */
+  bool CardReader::bufferedWrite(const uint8_t *data, const uint16_t len) {
+    for (uint16_t i = 0; i < len;) {
+      uint16_t n = sizeof(write_buffer) - write_buffer_count;
+      NOMORE(n, len - i);
+      memcpy(write_buffer + write_buffer_count, data + i, n);
+      write_buffer_count += n;
+      i += n;
+      if (write_buffer_count == sizeof(write_buffer) && !flushWriteBuffer()) return false;
+    }
+    return true;
+  }
+
+  /**
+   * Write out the buffered data. With keep_partial a partial sector stays
+   * in the buffer and the file position returns to the sector start, so
+   * the sector is written again, whole, once it fills.
+   */
+  bool CardReader::flushWriteBuffer(const bool keep_partial/*=false*/) {
+    if (!write_buffer_count) return true;
+    const int16_t n = write_buffer_count;
+    if (file.write(write_buffer, n) != n) {
+      write_buffer_count = 0;
+      return false;
+    }
+    if (keep_partial && n < (int16_t)sizeof(write_buffer))
+      return file.seekSet(file.curPosition() - n);
+    write_buffer_count = 0;
+    return true;
+  }
+
+#endif // HAS_SD_WRITE_BUFFER
+
+#if ENABLED(SD_LOG_BUFFER)
+
+  /**
+   * Write out and sync the log once it has been quiet for a while,
+   * or when lines have waited too long. Called from idle().
+   */
+  void CardReader::manageLog() {
+    if (!logging || !log_pending) return;
+    const millis_t ms = millis();
+    if (ELAPSED(ms, log_write_ms + SD_LOG_FLUSH_DELAY) || ELAPSED(ms, log_pending_ms + SD_LOG_SYNC_INTERVAL)) {
+      log_pending = false;
+      if (!flushWriteBuffer(true) || !file.sync()) {
+        SERIAL_ERROR_START();
+        SERIAL_ERRORLNPGM(MSG_SD_ERR_WRITE_TO_FILE);
+      }
+    }
+  }
+
+#endif // SD_LOG_BUFFER
+
+#if ENABLED(BINARY_FILE_UPLOAD)
+
+  /**
+   * Open a file to receive a binary upload, replacing any existing file.
+   * With a non-zero size the file is first allocated as one contiguous
+   * run of clusters, falling back to a normal file if there is no room.
+   */
+  bool CardReader::openBinaryUpload(char * const path, const uint32_t size) {
+    if (!cardOK) return false;
+
+    stopSDPrint();
+    if (isFileOpen()) closefile();
+
+    SdFile *curDir;
+    const char * const fname = diveToFile(curDir, path, false);
+    if (!fname) return false;
+
+    upload_reserved = 0;
+    if (size) {
+      file.remove(curDir, fname);
+      if (file.createContiguous(curDir, fname, size)) upload_reserved = size;
+    }
+    if (!upload_reserved && !file.open(curDir, fname, O_CREAT | O_WRITE | O_TRUNC)) {
+      SERIAL_PROTOCOLPAIR(MSG_SD_OPEN_FILE_FAIL, fname);
+      SERIAL_PROTOCOLCHAR('.');
+      SERIAL_EOL();
+      return false;
+    }
+
+    write_buffer_count = 0;
+    uploading = true;
+    #if ENABLED(EMERGENCY_PARSER)
+      emergency_parser.enable(false);
+    #endif
+    SERIAL_PROTOCOLLNPAIR(MSG_SD_WRITE_TO_FILE, path);
+    lcd_setstatus(fname);
+    return true;
+  }
+
+  /**
+   * Finish the upload. Keep the file, trimmed to the received size,
+   * or delete it if the upload was abandoned.
+   */
+  bool CardReader::closeBinaryUpload(const bool keep) {
+    bool ok = false;
+    if (keep) {
+      ok = flushWriteBuffer();
+      if (ok && file.curPosition() < upload_reserved) ok = file.truncate(file.curPosition());
+      ok = file.sync() && ok;
+      file.close();
+    }
+    else if (!file.remove())
+      file.close();
+
+    uploading = false;
+    #if ENABLED(EMERGENCY_PARSER)
+      emergency_parser.enable(true);
+    #endif
+    return ok;
+  }
+
+#endif // BINARY_FILE_UPLOAD
+
 /**
  * Get the name of a file in the current directory by index
  * with optional name to match.
@@ -47,6 +47,16 @@ public:
   void openLogFile(char * const path);
   void removeFile(const char * const name);
   void closefile(const bool store_location=false);
+
+  #if ENABLED(BINARY_FILE_UPLOAD)
+    bool openBinaryUpload(char * const path, const uint32_t size);
+    FORCE_INLINE bool writeBinaryUpload(const uint8_t *data, const uint16_t len) { return bufferedWrite(data, len); }
+    bool closeBinaryUpload(const bool keep);
+  #endif
+
+  #if ENABLED(SD_LOG_BUFFER)
+    void manageLog();
+  #endif
   void release();
   void openAndPrintFile(const char *name);
   void startFileprint();
@@ -118,6 +128,9 @@ public:
 
 public:
   bool saving, logging, sdprinting, cardOK, filenameIsDir, abort_sd_printing;
+  #if ENABLED(BINARY_FILE_UPLOAD)
+    bool uploading;
+  #endif
   char filename[FILENAME_LENGTH], longFilename[LONG_FILENAME_LENGTH];
   int8_t autostart_index;
 private:
@@ -178,6 +191,27 @@ private:
   SdVolume volume;
   SdFile file;
 
+  #if ENABLED(SD_EXTENT_MAP)
+    extent_map_t fileExtents;
+  #endif
+
+  #if HAS_SD_WRITE_BUFFER
+    uint8_t write_buffer[512];  // One sector, written to the card when full
+    uint16_t write_buffer_count;
+    bool bufferedWrite(const uint8_t *data, const uint16_t len);
+    bool flushWriteBuffer(const bool keep_partial=false);
+  #endif
+
+  #if ENABLED(BINARY_FILE_UPLOAD)
+    uint32_t upload_reserved;   // Size of a pre-allocated upload file
+  #endif
+
+  #if ENABLED(SD_LOG_BUFFER)
+    bool log_pending;           // Lines written since the last sync
+    millis_t log_pending_ms,    // Time of the first unsynced line
+             log_write_ms;      // Time of the last line
+  #endif
+
   #if ENABLED(POWER_LOSS_RECOVERY)
     SdFile jobRecoveryFile;
   #endif
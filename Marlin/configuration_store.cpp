@@ -37,7 +37,7 @@
  */
 
 // Change EEPROM version if the structure changes
-#define EEPROM_VERSION "V55"
+#define EEPROM_VERSION "V57"
 #define EEPROM_OFFSET 100
 
 // Check the integrity of data offsets.
@@ -73,6 +73,10 @@
   #include "fwretract.h"
 #endif
 
+#if ENABLED(INPUT_SHAPING)
+  #include "input_shaping.h"
+#endif
+
 #if ENABLED(PID_EXTRUSION_SCALING)
   #define LPQ_LEN thermalManager.lpq_len
 #endif
@@ -236,6 +240,7 @@ typedef struct SettingsDataStruct {
   //
   bool parser_volumetric_enabled;                       // M200 D  parser.volumetric_enabled
   float planner_filament_size[MAX_EXTRUDERS];           // M200 T D  planner.filament_size[]
+  float planner_volumetric_extruder_limit[MAX_EXTRUDERS]; // M200 T L  planner.volumetric_extruder_limit[]
 
   //
   // HAS_TRINAMIC
@@ -273,6 +278,13 @@ typedef struct SettingsDataStruct {
   float filament_change_unload_length[MAX_EXTRUDERS],   // M603 T U
         filament_change_load_length[MAX_EXTRUDERS];     // M603 T L
 
+  //
+  // INPUT_SHAPING
+  //
+  uint8_t shaping_type;                                 // M593 T
+  float shaping_frequency[2],                           // M593 X Y F
+        shaping_zeta[2];                                // M593 X Y D
+
 } SettingsData;
 
 #pragma pack(pop)
@@ -339,10 +351,18 @@ void MarlinSettings::postprocess() {
     fwretract.refresh_autoretract();
   #endif
 
+  #if ENABLED(INPUT_SHAPING)
+    input_shaping.refresh();
+  #endif
+
   #if ENABLED(JUNCTION_DEVIATION) && ENABLED(LIN_ADVANCE)
     planner.recalculate_max_e_jerk();
   #endif
 
+  #if ENABLED(SETTINGS_PROFILES)
+    active_profile = -1; // Any reload or reset leaves the base settings active
+  #endif
+
   // Refresh steps_to_mm with the reciprocal of axis_steps_per_mm
   // and init stepper.count[], planner.position[] with current_position
   planner.refresh_positioning();
@@ -730,6 +750,18 @@ void MarlinSettings::postprocess() {
 
     #endif
 
+    _FIELD_TEST(planner_volumetric_extruder_limit);
+
+    #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+      for (uint8_t q = 0; q < MAX_EXTRUDERS; q++) {
+        dummy = q < COUNT(planner.volumetric_extruder_limit) ? planner.volumetric_extruder_limit[q] : 0;
+        EEPROM_WRITE(dummy);
+      }
+    #else
+      dummy = 0;
+      for (uint8_t q = MAX_EXTRUDERS; q--;) EEPROM_WRITE(dummy);
+    #endif
+
     //
     // Save TMC2130 or TMC2208 Configuration, and placeholder values
     //
@@ -966,6 +998,23 @@ void MarlinSettings::postprocess() {
       for (uint8_t q = MAX_EXTRUDERS * 2; q--;) EEPROM_WRITE(dummy);
     #endif
 
+    //
+    // Input Shaping
+    //
+
+    _FIELD_TEST(shaping_type);
+
+    #if ENABLED(INPUT_SHAPING)
+      EEPROM_WRITE(input_shaping.type);
+      EEPROM_WRITE(input_shaping.frequency);
+      EEPROM_WRITE(input_shaping.zeta);
+    #else
+      const uint8_t shaping_type = 0;
+      EEPROM_WRITE(shaping_type);
+      dummy = 0;
+      for (uint8_t q = 4; q--;) EEPROM_WRITE(dummy);
+    #endif
+
     //
     // Validate CRC and Data Size
     //
@@ -1124,6 +1173,7 @@ void MarlinSettings::postprocess() {
         if (mesh_num_x == GRID_MAX_POINTS_X && mesh_num_y == GRID_MAX_POINTS_Y) {
           // EEPROM data fits the current mesh
           EEPROM_READ(mbl.z_values);
+          mbl.reset_layer();
         }
         else {
           // EEPROM data is stale
@@ -1366,6 +1416,16 @@ void MarlinSettings::postprocess() {
 
       #endif
 
+      _FIELD_TEST(planner_volumetric_extruder_limit);
+
+      for (uint8_t q = 0; q < MAX_EXTRUDERS; q++) {
+        EEPROM_READ(dummy);
+        #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+          if (!validating && q < COUNT(planner.volumetric_extruder_limit))
+            planner.volumetric_extruder_limit[q] = dummy;
+        #endif
+      }
+
       if (!validating) reset_stepper_drivers();
 
       //
@@ -1576,6 +1636,22 @@ void MarlinSettings::postprocess() {
         for (uint8_t q = MAX_EXTRUDERS * 2; q--;) EEPROM_READ(dummy);
       #endif
 
+      //
+      // Input Shaping
+      //
+
+      _FIELD_TEST(shaping_type);
+
+      #if ENABLED(INPUT_SHAPING)
+        EEPROM_READ(input_shaping.type);
+        EEPROM_READ(input_shaping.frequency);
+        EEPROM_READ(input_shaping.zeta);
+      #else
+        uint8_t shaping_type;
+        EEPROM_READ(shaping_type);
+        for (uint8_t q = 4; q--;) EEPROM_READ(dummy);
+      #endif
+
       eeprom_error = size_error(eeprom_index - (EEPROM_OFFSET));
       if (eeprom_error) {
         SERIAL_ECHO_START();
@@ -1663,6 +1739,292 @@ void MarlinSettings::postprocess() {
     return true;
   }
 
+  #if ENABLED(SETTINGS_PROFILES)
+
+    /**
+     * Settings Profiles
+     *
+     * A profile is a sparse list of { id, value } overrides for the
+     * parameters enumerated below. Parameters not in the list take the
+     * base value stored in SettingsData by M500, so loading a profile
+     * only reads the handful of EEPROM fields it touches.
+     *
+     * Slot layout: count (1 byte), crc (2 bytes), count * profile_delta_t
+     */
+
+    typedef struct { uint8_t id; float value; } profile_delta_t;
+
+    enum ProfileParam : uint8_t {
+      PP_JERK,                                          // M205 XYZE
+      PP_JUNCTION_DEV   = PP_JERK + NUM_AXIS,           // M205 J
+      PP_ACCEL,                                         // M204 P
+      PP_RETRACT_ACCEL,                                 // M204 R
+      PP_TRAVEL_ACCEL,                                  // M204 T
+      PP_MAX_ACCEL,                                     // M201 XYZE
+      PP_ADVANCE_K      = PP_MAX_ACCEL + NUM_AXIS,      // M900 K
+      PP_BED_PID,                                       // M304 P I D
+      PP_AUTORETRACT    = PP_BED_PID + 3,               // M209 S
+      PP_RETRACT,                                       // M207 S F Z, M208 S F, M207 W, M208 W R
+      PP_HOTEND_PID     = PP_RETRACT + 8,               // M301 E P I D
+      PP_COUNT          = PP_HOTEND_PID + (HOTENDS) * 3
+    };
+
+    enum ProfileType : uint8_t { PT_NONE, PT_FLOAT, PT_UINT32, PT_BOOL };
+
+    typedef struct {
+      void *ram;        // Live value
+      uint16_t base;    // Offset of the base value in SettingsData
+      ProfileType type;
+    } profile_param_t;
+
+    #define PP_FIELD(F) offsetof(SettingsData, F)
+    #define PP_SET(R,B,T) do{ p.ram = (void*)&(R); p.base = (B); p.type = T; }while(0)
+
+    /**
+     * Describe a profile parameter. Return PT_NONE for
+     * parameters that don't exist in this configuration.
+     */
+    static ProfileType profile_param(const uint8_t id, profile_param_t &p) {
+      p.type = PT_NONE;
+      #if DISABLED(JUNCTION_DEVIATION)
+        if (WITHIN(id, PP_JERK, PP_JERK + NUM_AXIS - 1))
+          PP_SET(planner.max_jerk[id - PP_JERK], PP_FIELD(planner_max_jerk) + (id - PP_JERK) * sizeof(float), PT_FLOAT);
+      #else
+        if (id == PP_JUNCTION_DEV)
+          PP_SET(planner.junction_deviation_mm, PP_FIELD(planner_junction_deviation_mm), PT_FLOAT);
+      #endif
+      else if (id == PP_ACCEL)
+        PP_SET(planner.acceleration, PP_FIELD(planner_acceleration), PT_FLOAT);
+      else if (id == PP_RETRACT_ACCEL)
+        PP_SET(planner.retract_acceleration, PP_FIELD(planner_retract_acceleration), PT_FLOAT);
+      else if (id == PP_TRAVEL_ACCEL)
+        PP_SET(planner.travel_acceleration, PP_FIELD(planner_travel_acceleration), PT_FLOAT);
+      else if (WITHIN(id, PP_MAX_ACCEL, PP_MAX_ACCEL + NUM_AXIS - 1))
+        PP_SET(planner.max_acceleration_mm_per_s2[id - PP_MAX_ACCEL], PP_FIELD(planner_max_acceleration_mm_per_s2) + (id - PP_MAX_ACCEL) * sizeof(uint32_t), PT_UINT32);
+      #if ENABLED(LIN_ADVANCE)
+        else if (id == PP_ADVANCE_K)
+          PP_SET(planner.extruder_advance_K, PP_FIELD(planner_extruder_advance_K), PT_FLOAT);
+      #endif
+      #if ENABLED(PIDTEMPBED)
+        else if (id == PP_BED_PID + 0) PP_SET(thermalManager.bedKp, PP_FIELD(bedPID.Kp), PT_FLOAT);
+        else if (id == PP_BED_PID + 1) PP_SET(thermalManager.bedKi, PP_FIELD(bedPID.Ki), PT_FLOAT);
+        else if (id == PP_BED_PID + 2) PP_SET(thermalManager.bedKd, PP_FIELD(bedPID.Kd), PT_FLOAT);
+      #endif
+      #if ENABLED(FWRETRACT)
+        else if (id == PP_AUTORETRACT)
+          PP_SET(fwretract.autoretract_enabled, PP_FIELD(autoretract_enabled), PT_BOOL);
+        else if (WITHIN(id, PP_RETRACT, PP_RETRACT + 7)) {
+          // Same order in FWRetract and SettingsData
+          float * const fw[] = {
+            &fwretract.retract_length, &fwretract.retract_feedrate_mm_s, &fwretract.retract_zlift,
+            &fwretract.retract_recover_length, &fwretract.retract_recover_feedrate_mm_s,
+            &fwretract.swap_retract_length, &fwretract.swap_retract_recover_length,
+            &fwretract.swap_retract_recover_feedrate_mm_s
+          };
+          PP_SET(*fw[id - PP_RETRACT], PP_FIELD(retract_length) + (id - PP_RETRACT) * sizeof(float), PT_FLOAT);
+        }
+      #endif
+      #if ENABLED(PIDTEMP)
+        else if (WITHIN(id, PP_HOTEND_PID, PP_COUNT - 1)) {
+          const uint8_t e = (id - PP_HOTEND_PID) / 3, k = (id - PP_HOTEND_PID) % 3;
+          const uint16_t base = PP_FIELD(hotendPID) + e * sizeof(PIDC);
+          UNUSED(e);
+          switch (k) {
+            case 0: PP_SET(PID_PARAM(Kp, e), base + offsetof(PIDC, Kp), PT_FLOAT); break;
+            case 1: PP_SET(PID_PARAM(Ki, e), base + offsetof(PIDC, Ki), PT_FLOAT); break;
+            case 2: PP_SET(PID_PARAM(Kd, e), base + offsetof(PIDC, Kd), PT_FLOAT); break;
+          }
+        }
+      #endif
+      return p.type;
+    }
+
+    static float profile_get(const profile_param_t &p) {
+      switch (p.type) {
+        case PT_UINT32: return *(uint32_t*)p.ram;
+        case PT_BOOL:   return *(bool*)p.ram;
+        default:        return *(float*)p.ram;
+      }
+    }
+
+    static void profile_set(const profile_param_t &p, const float v) {
+      switch (p.type) {
+        case PT_UINT32: *(uint32_t*)p.ram = v; break;
+        case PT_BOOL:   *(bool*)p.ram = v; break;
+        default:        *(float*)p.ram = v; break;
+      }
+    }
+
+    // Read a base value straight from the stored SettingsData
+    static float profile_base(const profile_param_t &p) {
+      union { float f; uint32_t u; bool b; } v;
+      const uint8_t size = p.type == PT_BOOL ? sizeof(bool) : sizeof(float);
+      for (uint8_t i = 0; i < size; i++)
+        ((uint8_t*)&v)[i] = eeprom_read_byte((uint8_t*)(EEPROM_OFFSET + p.base + i));
+      switch (p.type) {
+        case PT_UINT32: return v.u;
+        case PT_BOOL:   return v.b;
+        default:        return v.f;
+      }
+    }
+
+    int8_t MarlinSettings::active_profile = -1;
+
+    uint16_t MarlinSettings::profiles_start_index() {
+      return (datasize() + EEPROM_OFFSET + 32) & 0xFFF8;  // Same padding as the UBL meshes
+    }
+
+    // Deltas are only meaningful against a base of the same layout
+    bool MarlinSettings::base_is_valid() {
+      char stored_ver[4];
+      for (uint8_t i = 0; i < sizeof(stored_ver); i++)
+        stored_ver[i] = eeprom_read_byte((uint8_t*)(EEPROM_OFFSET + i));
+      if (strncmp(version, stored_ver, 3) == 0) return true;
+      SERIAL_ERROR_START();
+      SERIAL_ERRORLNPGM("No base settings. Store with M500 first.");
+      return false;
+    }
+
+    /**
+     * Read a profile slot into 'deltas' and check its CRC.
+     * Return the number of deltas, or 0xFF if the slot is empty or bad.
+     */
+    uint8_t MarlinSettings::read_profile(const uint8_t slot, void * const deltas) {
+      int pos = profiles_start_index() + slot * profile_slot_size;
+      uint16_t crc = 0, stored_crc;
+      uint8_t count;
+      eeprom_error = false;
+      read_data(pos, &count, sizeof(count), &crc, true);
+      if (count > SETTINGS_PROFILE_MAX_DELTAS) return 0xFF;   // Erased EEPROM reads 0xFF
+      read_data(pos, (uint8_t*)&stored_crc, sizeof(stored_crc), &crc, true);
+      crc = 0;
+      crc16(&crc, &count, 1);
+      if (count) read_data(pos, (uint8_t*)deltas, count * sizeof(profile_delta_t), &crc, true);
+      return (eeprom_error || crc != stored_crc) ? 0xFF : count;
+    }
+
+    /**
+     * Store the parameters that differ from the base settings
+     */
+    bool MarlinSettings::save_profile(const uint8_t slot) {
+      if (slot >= SETTINGS_PROFILE_SLOTS || !base_is_valid()) return false;
+
+      profile_delta_t deltas[SETTINGS_PROFILE_MAX_DELTAS];
+      uint8_t count = 0;
+      for (uint8_t id = 0; id < PP_COUNT; id++) {
+        profile_param_t p;
+        if (!profile_param(id, p)) continue;
+        const float v = profile_get(p);
+        if (v == profile_base(p)) continue;
+        if (count >= SETTINGS_PROFILE_MAX_DELTAS) {
+          SERIAL_ERROR_START();
+          SERIAL_ERRORLNPGM("Too many changes for one profile.");
+          return false;
+        }
+        deltas[count].id = id;
+        deltas[count].value = v;
+        count++;
+      }
+
+      uint16_t crc = 0, dummy_crc = 0;
+      crc16(&crc, &count, 1);
+      crc16(&crc, deltas, count * sizeof(profile_delta_t));
+
+      int pos = profiles_start_index() + slot * profile_slot_size;
+      eeprom_error = false;
+      write_data(pos, &count, sizeof(count), &dummy_crc);
+      write_data(pos, (uint8_t*)&crc, sizeof(crc), &dummy_crc);
+      if (count) write_data(pos, (uint8_t*)deltas, count * sizeof(profile_delta_t), &dummy_crc);
+
+      if (!eeprom_error) {
+        active_profile = slot;
+        #if ENABLED(EEPROM_CHITCHAT)
+          SERIAL_ECHO_START();
+          SERIAL_ECHOPAIR("Profile ", int(slot));
+          SERIAL_ECHOPAIR(" stored (", int(count));
+          SERIAL_ECHOLNPGM(" changes)");
+        #endif
+      }
+      return !eeprom_error;
+    }
+
+    /**
+     * Restore the base values of all profile parameters, then apply
+     * the slot's deltas. The slot is read and checked in full before
+     * anything is changed, so a bad slot leaves the settings intact.
+     * Pass -1 to return to the base settings.
+     */
+    bool MarlinSettings::load_profile(const int8_t slot) {
+      if (slot >= SETTINGS_PROFILE_SLOTS || !base_is_valid()) return false;
+
+      profile_delta_t deltas[SETTINGS_PROFILE_MAX_DELTAS];
+      uint8_t count = 0;
+      if (slot >= 0) {
+        count = read_profile(slot, deltas);
+        if (count == 0xFF) {
+          SERIAL_ERROR_START();
+          SERIAL_ERRORPGM("Invalid or empty profile ");
+          SERIAL_ERRORLN(int(slot));
+          return false;
+        }
+      }
+
+      for (uint8_t id = 0; id < PP_COUNT; id++) {
+        profile_param_t p;
+        if (profile_param(id, p)) profile_set(p, profile_base(p));
+      }
+
+      for (uint8_t i = 0; i < count; i++) {
+        profile_param_t p;
+        if (profile_param(deltas[i].id, p)) profile_set(p, deltas[i].value);
+      }
+
+      postprocess();
+
+      active_profile = slot;
+
+      #if ENABLED(EEPROM_CHITCHAT)
+        SERIAL_ECHO_START();
+        if (slot < 0)
+          SERIAL_ECHOLNPGM("Base settings restored");
+        else {
+          SERIAL_ECHOPAIR("Profile ", int(slot));
+          SERIAL_ECHOPAIR(" loaded (", int(count));
+          SERIAL_ECHOLNPGM(" changes)");
+        }
+      #endif
+      return true;
+    }
+
+    void MarlinSettings::clear_profile(const uint8_t slot) {
+      if (slot >= SETTINGS_PROFILE_SLOTS) return;
+      int pos = profiles_start_index() + slot * profile_slot_size;
+      const uint8_t empty = 0xFF;
+      uint16_t dummy_crc = 0;
+      eeprom_error = false;
+      write_data(pos, &empty, sizeof(empty), &dummy_crc);
+      if (active_profile == slot) active_profile = -1;
+    }
+
+    void MarlinSettings::report_profiles() {
+      profile_delta_t deltas[SETTINGS_PROFILE_MAX_DELTAS];
+      for (uint8_t s = 0; s < SETTINGS_PROFILE_SLOTS; s++) {
+        const uint8_t count = read_profile(s, deltas);
+        SERIAL_ECHO_START();
+        SERIAL_ECHOPAIR("Profile ", int(s));
+        if (count == 0xFF)
+          SERIAL_ECHOPGM(" empty");
+        else {
+          SERIAL_ECHOPAIR(": ", int(count));
+          SERIAL_ECHOPGM(" changes");
+        }
+        if (s == active_profile) SERIAL_ECHOPGM(" (active)");
+        SERIAL_EOL();
+      }
+    }
+
+  #endif // SETTINGS_PROFILES
+
   #if ENABLED(AUTO_BED_LEVELING_UBL)
 
     #if ENABLED(EEPROM_CHITCHAT)
@@ -1674,8 +2036,12 @@ void MarlinSettings::postprocess() {
     #endif
 
     uint16_t MarlinSettings::meshes_start_index() {
-      return (datasize() + EEPROM_OFFSET + 32) & 0xFFF8;  // Pad the end of configuration data so it can float up
-                                                          // or down a little bit without disrupting the mesh data
+      #if ENABLED(SETTINGS_PROFILES)
+        return profiles_end_index();
+      #else
+        return (datasize() + EEPROM_OFFSET + 32) & 0xFFF8;  // Pad the end of configuration data so it can float up
+                                                            // or down a little bit without disrupting the mesh data
+      #endif
     }
 
     uint16_t MarlinSettings::calc_num_meshes() {
@@ -1735,6 +2101,7 @@ void MarlinSettings::postprocess() {
         uint16_t crc = 0;
         uint8_t * const dest = into ? (uint8_t*)into : (uint8_t*)&ubl.z_values;
         read_data(pos, dest, sizeof(ubl.z_values), &crc);
+        if (!into) ubl.mesh_changed();
 
         // Compare crc with crc from MAT, or read from end
 
@@ -1932,6 +2299,10 @@ void MarlinSettings::reset() {
     fwretract.reset();
   #endif
 
+  #if ENABLED(INPUT_SHAPING)
+    input_shaping.reset();
+  #endif
+
   #if DISABLED(NO_VOLUMETRICS)
 
     parser.volumetric_enabled =
@@ -1944,6 +2315,11 @@ void MarlinSettings::reset() {
     for (uint8_t q = 0; q < COUNT(planner.filament_size); q++)
       planner.filament_size[q] = DEFAULT_NOMINAL_FILAMENT_DIA;
 
+    #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+      for (uint8_t q = 0; q < COUNT(planner.volumetric_extruder_limit); q++)
+        planner.volumetric_extruder_limit[q] = DEFAULT_VOLUMETRIC_EXTRUDER_LIMIT;
+    #endif
+
   #endif
 
   endstops.enable_globally(
@@ -2106,6 +2482,18 @@ void MarlinSettings::reset() {
         SERIAL_ECHOLNPGM("  M200 D0");
       }
 
+      #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+        if (!forReplay) {
+          CONFIG_ECHO_START;
+          SERIAL_ECHOLNPGM("Volumetric extrusion limit (mm3/s):");
+        }
+        for (uint8_t e = 0; e < EXTRUDERS; e++) {
+          CONFIG_ECHO_START;
+          SERIAL_ECHOPAIR("  M200 T", int(e));
+          SERIAL_ECHOLNPAIR(" L", planner.volumetric_extruder_limit[e]);
+        }
+      #endif
+
     #endif // !NO_VOLUMETRICS
 
     if (!forReplay) {
@@ -2512,6 +2900,23 @@ void MarlinSettings::reset() {
 
     #endif // FWRETRACT
 
+    #if ENABLED(INPUT_SHAPING)
+
+      if (!forReplay) {
+        CONFIG_ECHO_START;
+        SERIAL_ECHOLNPGM("Input Shaping: T<0=ZV 1=MZV 2=EI> F<Hz> D<damping>");
+      }
+      CONFIG_ECHO_START;
+      SERIAL_ECHOLNPAIR("  M593 T", int(input_shaping.type));
+      CONFIG_ECHO_START;
+      SERIAL_ECHOPAIR("  M593 X F", input_shaping.frequency[X_AXIS]);
+      SERIAL_ECHOLNPAIR(" D", input_shaping.zeta[X_AXIS]);
+      CONFIG_ECHO_START;
+      SERIAL_ECHOPAIR("  M593 Y F", input_shaping.frequency[Y_AXIS]);
+      SERIAL_ECHOLNPAIR(" D", input_shaping.zeta[Y_AXIS]);
+
+    #endif // INPUT_SHAPING
+
     /**
      * Probe Offset
      */
@@ -63,6 +63,16 @@ class MarlinSettings {
         //static void delete_mesh();    // necessary if we have a MAT
         //static void defrag_meshes();  // "
       #endif
+
+      #if ENABLED(SETTINGS_PROFILES)
+        static int8_t active_profile;           // Last profile loaded with M507, -1 for none
+        static uint16_t profiles_start_index();
+        FORCE_INLINE static uint16_t profiles_end_index() { return profiles_start_index() + (SETTINGS_PROFILE_SLOTS) * profile_slot_size; }
+        static bool save_profile(const uint8_t slot);
+        static bool load_profile(const int8_t slot);
+        static void clear_profile(const uint8_t slot);
+        static void report_profiles();
+      #endif
     #else
       FORCE_INLINE
       static bool load() { reset(); report(); return true; }
@@ -89,6 +99,12 @@ class MarlinSettings {
 
       #endif
 
+      #if ENABLED(SETTINGS_PROFILES)
+        static constexpr uint16_t profile_slot_size = 3 + (SETTINGS_PROFILE_MAX_DELTAS) * 5; // count, crc, { id, value }...
+        static uint8_t read_profile(const uint8_t slot, void * const deltas);
+        static bool base_is_valid();
+      #endif
+
       static bool _load();
       static void write_data(int &pos, const uint8_t *value, uint16_t size, uint16_t *crc);
       static void read_data(int &pos, uint8_t *value, uint16_t size, uint16_t *crc, const bool force=false);
@@ -39,20 +39,55 @@
 
 uint16_t mcp4728_values[XYZE];
 
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+
+  // Writes are queued and return 0, as Wire does for a write that worked. Each
+  // kind of write has its own buffer, so a channel write and the UPDATE after
+  // it go out in one batch. A buffer is only changed once its last write ended.
+  static uint8_t mcp4728_fast_data[2 * XYZE],
+                 mcp4728_eeprom_data[1 + 2 * XYZE],
+                 mcp4728_vref_data[1], mcp4728_gain_data[1], mcp4728_cmd_data[1];
+
+  static TWITransfer mcp4728_fast_xfer = { DAC_DEV_ADDRESS, sizeof(mcp4728_fast_data), 0, mcp4728_fast_data },
+                     mcp4728_eeprom_xfer = { DAC_DEV_ADDRESS, sizeof(mcp4728_eeprom_data), 0, mcp4728_eeprom_data },
+                     mcp4728_vref_xfer = { DAC_DEV_ADDRESS, 1, 0, mcp4728_vref_data },
+                     mcp4728_gain_xfer = { DAC_DEV_ADDRESS, 1, 0, mcp4728_gain_data },
+                     mcp4728_cmd_xfer = { GENERALCALL, 1, 0, mcp4728_cmd_data };
+
+  // Queue a one byte write once the previous one has ended
+  static void mcp4728_send(TWITransfer &t, uint8_t &buffer, const uint8_t data) {
+    MarlinTWI::wait(t);
+    buffer = data;
+    MarlinTWI::submit(t);
+  }
+
+#endif
+
 /**
  * Begin I2C, get current values (input register and eeprom) of mcp4728
  */
 void mcp4728_init() {
-  Wire.begin();
-  Wire.requestFrom(int(DAC_DEV_ADDRESS), 24);
-  while (Wire.available()) {
-    char deviceID = Wire.read(),
-         hiByte = Wire.read(),
-         loByte = Wire.read();
-
-    if (!(deviceID & 0x08))
-      mcp4728_values[(deviceID & 0x30) >> 4] = word((hiByte & 0x0F), loByte);
-  }
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    MarlinTWI::init();
+    uint8_t data[24];
+    const uint8_t len = MarlinTWI::read(DAC_DEV_ADDRESS, data, sizeof(data));
+    for (uint8_t i = 0; i + 2 < len; i += 3) {
+      const uint8_t deviceID = data[i], hiByte = data[i + 1], loByte = data[i + 2];
+      if (!(deviceID & 0x08))
+        mcp4728_values[(deviceID & 0x30) >> 4] = word((hiByte & 0x0F), loByte);
+    }
+  #else
+    Wire.begin();
+    Wire.requestFrom(int(DAC_DEV_ADDRESS), 24);
+    while (Wire.available()) {
+      char deviceID = Wire.read(),
+           hiByte = Wire.read(),
+           loByte = Wire.read();
+
+      if (!(deviceID & 0x08))
+        mcp4728_values[(deviceID & 0x30) >> 4] = word((hiByte & 0x0F), loByte);
+    }
+  #endif
 }
 
 /**
@@ -70,30 +105,51 @@ uint8_t mcp4728_analogWrite(uint8_t channel, uint16_t value) {
  * This will also write current Vref, PowerDown, Gain settings to EEPROM
  */
 uint8_t mcp4728_eepromWrite() {
-  Wire.beginTransmission(DAC_DEV_ADDRESS);
-  Wire.write(SEQWRITE);
-  LOOP_XYZE(i) {
-    Wire.write(DAC_STEPPER_VREF << 7 | DAC_STEPPER_GAIN << 4 | highByte(mcp4728_values[i]));
-    Wire.write(lowByte(mcp4728_values[i]));
-  }
-  return Wire.endTransmission();
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    MarlinTWI::wait(mcp4728_eeprom_xfer);
+    mcp4728_eeprom_data[0] = SEQWRITE;
+    LOOP_XYZE(i) {
+      mcp4728_eeprom_data[1 + 2 * i] = DAC_STEPPER_VREF << 7 | DAC_STEPPER_GAIN << 4 | highByte(mcp4728_values[i]);
+      mcp4728_eeprom_data[2 + 2 * i] = lowByte(mcp4728_values[i]);
+    }
+    MarlinTWI::submit(mcp4728_eeprom_xfer);
+    return 0;
+  #else
+    Wire.beginTransmission(DAC_DEV_ADDRESS);
+    Wire.write(SEQWRITE);
+    LOOP_XYZE(i) {
+      Wire.write(DAC_STEPPER_VREF << 7 | DAC_STEPPER_GAIN << 4 | highByte(mcp4728_values[i]));
+      Wire.write(lowByte(mcp4728_values[i]));
+    }
+    return Wire.endTransmission();
+  #endif
 }
 
 /**
  * Write Voltage reference setting to all input regiters
  */
 uint8_t mcp4728_setVref_all(uint8_t value) {
-  Wire.beginTransmission(DAC_DEV_ADDRESS);
-  Wire.write(VREFWRITE | (value ? 0x0F : 0x00));
-  return Wire.endTransmission();
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    mcp4728_send(mcp4728_vref_xfer, mcp4728_vref_data[0], VREFWRITE | (value ? 0x0F : 0x00));
+    return 0;
+  #else
+    Wire.beginTransmission(DAC_DEV_ADDRESS);
+    Wire.write(VREFWRITE | (value ? 0x0F : 0x00));
+    return Wire.endTransmission();
+  #endif
 }
 /**
  * Write Gain setting to all input regiters
  */
 uint8_t mcp4728_setGain_all(uint8_t value) {
-  Wire.beginTransmission(DAC_DEV_ADDRESS);
-  Wire.write(GAINWRITE | (value ? 0x0F : 0x00));
-  return Wire.endTransmission();
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    mcp4728_send(mcp4728_gain_xfer, mcp4728_gain_data[0], GAINWRITE | (value ? 0x0F : 0x00));
+    return 0;
+  #else
+    Wire.beginTransmission(DAC_DEV_ADDRESS);
+    Wire.write(GAINWRITE | (value ? 0x0F : 0x00));
+    return Wire.endTransmission();
+  #endif
 }
 
 /**
@@ -133,21 +189,44 @@ void mcp4728_setDrvPct(uint8_t pct[XYZE]) {
  * No EEPROM update
  */
 uint8_t mcp4728_fastWrite() {
-  Wire.beginTransmission(DAC_DEV_ADDRESS);
-  LOOP_XYZE(i) {
-    Wire.write(highByte(mcp4728_values[i]));
-    Wire.write(lowByte(mcp4728_values[i]));
-  }
-  return Wire.endTransmission();
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    // If the last write is still waiting in the queue it sends these values
+    uint8_t data[2 * XYZE];
+    LOOP_XYZE(i) {
+      data[2 * i] = highByte(mcp4728_values[i]);
+      data[2 * i + 1] = lowByte(mcp4728_values[i]);
+    }
+    MarlinTWI::refresh(mcp4728_fast_xfer, mcp4728_fast_data, data, sizeof(data));
+    return 0;
+  #else
+    Wire.beginTransmission(DAC_DEV_ADDRESS);
+    LOOP_XYZE(i) {
+      Wire.write(highByte(mcp4728_values[i]));
+      Wire.write(lowByte(mcp4728_values[i]));
+    }
+    return Wire.endTransmission();
+  #endif
 }
 
 /**
  * Common function for simple general commands
  */
 uint8_t mcp4728_simpleCommand(byte simpleCommand) {
-  Wire.beginTransmission(GENERALCALL);
-  Wire.write(simpleCommand);
-  return Wire.endTransmission();
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    mcp4728_send(mcp4728_cmd_xfer, mcp4728_cmd_data[0], simpleCommand);
+    if (simpleCommand != RESET) return 0;
+    // RESET is only sent by dac_init, which needs to know if the DAC answered
+    switch (MarlinTWI::wait(mcp4728_cmd_xfer)) {
+      case TWI_OK: return 0;
+      case TWI_NACK_ADDR: return 2;
+      case TWI_NACK_DATA: return 3;
+      default: return 4;
+    }
+  #else
+    Wire.beginTransmission(GENERALCALL);
+    Wire.write(simpleCommand);
+    return Wire.endTransmission();
+  #endif
 }
 
 #endif // DAC_STEPPER_CURRENT
@@ -30,7 +30,12 @@
 #include "MarlinConfig.h"
 
 #if ENABLED(DAC_STEPPER_CURRENT)
-#include "Wire.h"
+
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+  #include "MarlinTWI.h"
+#else
+  #include "Wire.h"
+#endif
 
 #define defaultVDD     DAC_STEPPER_MAX //was 5000 but differs with internal Vref
 #define BASE_ADDR      0x60
@@ -24,9 +24,13 @@
 
 #if ENABLED(DIGIPOT_I2C) && DISABLED(DIGIPOT_MCP4018)
 
-#include "Stream.h"
-#include "utility/twi.h"
-#include "Wire.h"
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+  #include "MarlinTWI.h"
+#else
+  #include "Stream.h"
+  #include "utility/twi.h"
+  #include "Wire.h"
+#endif
 
 // Settings for the I2C based DIGIPOT (MCP4451) on Azteeg X3 Pro
 #if MB(5DPRINT)
@@ -41,6 +45,41 @@ static byte current_to_wiper(const float current) {
   return byte(CEIL(float((DIGIPOT_I2C_FACTOR * current))));
 }
 
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+
+// One continuous write per digipot sets up TCON0 and TCON1, then all four
+// wipers. Setting several channels queues each digipot once.
+#define DIGIPOT_DATA { 0x40, 0xFF, 0xA0, 0xFF, 0x00, 0, 0x10, 0, 0x60, 0, 0x70, 0 }
+static uint8_t digipot_data[2][12] = { DIGIPOT_DATA, DIGIPOT_DATA };
+static TWITransfer digipot_xfer[2] = {
+  { 0x2C, sizeof(digipot_data[0]), 0, digipot_data[0] },  // channel 0-3
+  { 0x2E, sizeof(digipot_data[1]), 0, digipot_data[1] }   // channel 4-7
+};
+
+#define DIGIPOT_WIPER(C) digipot_data[(C) >> 2][5 + 2 * ((C) & 3)]
+
+static byte digipot_i2c_wiper(float current) {
+  current = MIN((float) MAX(current, 0), DIGIPOT_I2C_MAX_CURRENT);
+  return current_to_wiper(current);
+}
+
+void digipot_i2c_set_current(uint8_t channel, float current) {
+  const byte wiper = digipot_i2c_wiper(current);
+  MarlinTWI::refresh(digipot_xfer[channel >> 2], &DIGIPOT_WIPER(channel), &wiper, 1);
+}
+
+void digipot_i2c_init() {
+  static const float digipot_motor_current[] PROGMEM = DIGIPOT_I2C_MOTOR_CURRENTS;
+  MarlinTWI::init();
+  // setup initial currents as defined in Configuration_adv.h
+  for (uint8_t i = 0; i < COUNT(digipot_motor_current); i++)
+    DIGIPOT_WIPER(i) = digipot_i2c_wiper(pgm_read_float(&digipot_motor_current[i]));
+  MarlinTWI::submit(digipot_xfer[0]);
+  if (COUNT(digipot_motor_current) > 4) MarlinTWI::submit(digipot_xfer[1]);
+}
+
+#else
+
 static void i2c_send(const byte addr, const byte a, const byte b) {
   Wire.beginTransmission(addr);
   Wire.write(a);
@@ -76,4 +115,6 @@ void digipot_i2c_init() {
     digipot_i2c_set_current(i, pgm_read_float(&digipot_motor_current[i]));
 }
 
+#endif // !TWI_TRANSACTION_QUEUE
+
 #endif // DIGIPOT_I2C
@@ -33,6 +33,9 @@
 // Static data members
 bool EmergencyParser::killed_by_M112; // = false
 EmergencyParser::State EmergencyParser::state; // = EP_RESET
+#if ENABLED(BINARY_FILE_UPLOAD)
+  bool EmergencyParser::enabled = true;
+#endif
 
 // Global instance
 EmergencyParser emergency_parser;
@@ -54,11 +54,20 @@ public:
   static bool killed_by_M112;
   static State state;
 
+  #if ENABLED(BINARY_FILE_UPLOAD)
+    static bool enabled;  // Off while binary data is arriving
+    static void enable(const bool onoff) { enabled = onoff; state = EP_RESET; }
+  #endif
+
   EmergencyParser() {}
 
   __attribute__((always_inline)) inline
   static void update(const uint8_t c) {
 
+    #if ENABLED(BINARY_FILE_UPLOAD)
+      if (!enabled) return;
+    #endif
+
     switch (state) {
       case EP_RESET:
         switch (c) {
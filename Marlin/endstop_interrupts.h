@@ -29,7 +29,8 @@
  * least one endstop has changed state, saving valuable CPU cycles.
  *
  * This feature only works when all used endstop pins can generate either an
- * 'external interrupt' or a 'pin change interrupt'.
+ * 'external interrupt' or a 'pin change interrupt'. ENDSTOP_SCAN_MASK uses
+ * interrupts only on the pins that have one and keeps polling the others.
  *
  * Test whether pins issue interrupts on your board by flashing 'pin_interrupt_test.ino'.
  * (Located in Marlin/buildroot/share/pin_interrupt_test/pin_interrupt_test.ino)
@@ -101,6 +102,8 @@ void pciSetup(const int8_t pin) {
   ISR(PCINT3_vect) { endstop_ISR(); }
 #endif
 
+#if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+
 void setup_endstop_interrupts( void ) {
 
   #if HAS_X_MAX
@@ -236,4 +239,72 @@ void setup_endstop_interrupts( void ) {
   // If we arrive here without raising an assertion, each pin has either an EXT-interrupt or a PCI.
 }
 
+#endif // ENDSTOP_INTERRUPTS_FEATURE
+
+#if ENABLED(ENDSTOP_SCAN_MASK)
+
+  // Give the pin an EXT-interrupt or a PCI, if it has one. Return false if it must be polled.
+  bool setup_endstop_interrupt(const int8_t pin) {
+    if (digitalPinToInterrupt(pin) != NOT_AN_INTERRUPT)
+      attachInterrupt(digitalPinToInterrupt(pin), endstop_ISR, CHANGE);
+    else if (digitalPinToPCICR(pin))
+      pciSetup(pin);
+    else
+      return false;
+    return true;
+  }
+
+  /**
+   * Attach interrupts to the endstop pins that can raise one and leave
+   * the rest to endstops.poll(). Return the endstops that need polling.
+   */
+  Endstops::esbits_t setup_available_endstop_interrupts() {
+    Endstops::esbits_t polled = 0;
+    #define _ENDSTOP_IRQ(ES) do{ if (!setup_endstop_interrupt(ES##_PIN)) SBI(polled, ES); }while(0)
+
+    #if HAS_X_MAX
+      _ENDSTOP_IRQ(X_MAX);
+    #endif
+    #if HAS_X_MIN
+      _ENDSTOP_IRQ(X_MIN);
+    #endif
+    #if HAS_Y_MAX
+      _ENDSTOP_IRQ(Y_MAX);
+    #endif
+    #if HAS_Y_MIN
+      _ENDSTOP_IRQ(Y_MIN);
+    #endif
+    #if HAS_Z_MAX
+      _ENDSTOP_IRQ(Z_MAX);
+    #endif
+    #if HAS_Z_MIN
+      _ENDSTOP_IRQ(Z_MIN);
+    #endif
+    #if HAS_X2_MAX
+      _ENDSTOP_IRQ(X2_MAX);
+    #endif
+    #if HAS_X2_MIN
+      _ENDSTOP_IRQ(X2_MIN);
+    #endif
+    #if HAS_Y2_MAX
+      _ENDSTOP_IRQ(Y2_MAX);
+    #endif
+    #if HAS_Y2_MIN
+      _ENDSTOP_IRQ(Y2_MIN);
+    #endif
+    #if HAS_Z2_MAX
+      _ENDSTOP_IRQ(Z2_MAX);
+    #endif
+    #if HAS_Z2_MIN
+      _ENDSTOP_IRQ(Z2_MIN);
+    #endif
+    #if HAS_Z_MIN_PROBE_PIN
+      _ENDSTOP_IRQ(Z_MIN_PROBE);
+    #endif
+
+    return polled;
+  }
+
+#endif // ENDSTOP_SCAN_MASK
+
 #endif // _ENDSTOP_INTERRUPTS_H_
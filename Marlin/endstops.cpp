@@ -31,7 +31,7 @@
 #include "stepper.h"
 #include "ultralcd.h"
 
-#if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+#if ENABLED(ENDSTOP_INTERRUPTS_FEATURE) || ENABLED(ENDSTOP_SCAN_MASK)
   #include "endstop_interrupts.h"
 #endif
 
@@ -49,6 +49,12 @@ Endstops::esbits_t Endstops::live_state = 0;
   uint8_t Endstops::endstop_poll_count;
 #endif
 
+#if ENABLED(ENDSTOP_SCAN_MASK)
+  volatile Endstops::esbits_t Endstops::scan_mask; // = 0
+  Endstops::esbits_t Endstops::polled_bits; // Initialized by init()
+  volatile uint32_t Endstops::poll_count, Endstops::polls_skipped; // = 0
+#endif
+
 #if HAS_BED_PROBE
   volatile bool Endstops::z_probe_enabled = false;
 #endif
@@ -176,6 +182,8 @@ void Endstops::init() {
 
   #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
     setup_endstop_interrupts();
+  #elif ENABLED(ENDSTOP_SCAN_MASK)
+    polled_bits = setup_available_endstop_interrupts();
   #endif
 
   // Enable endstops
@@ -196,7 +204,17 @@ void Endstops::poll() {
     run_monitor();  // report changes in endstop status
   #endif
 
-  #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE) && ENABLED(ENDSTOP_NOISE_FILTER)
+  #if ENABLED(ENDSTOP_SCAN_MASK)
+    // Endstops with an interrupt only need polling while the noise filter settles
+    ++poll_count;
+    if ((scan_mask & polled_bits)
+      #if ENABLED(ENDSTOP_NOISE_FILTER)
+        || endstop_poll_count
+      #endif
+    ) update();
+    else
+      ++polls_skipped;
+  #elif ENABLED(ENDSTOP_INTERRUPTS_FEATURE) && ENABLED(ENDSTOP_NOISE_FILTER)
     if (endstop_poll_count) update();
   #elif DISABLED(ENDSTOP_INTERRUPTS_FEATURE) || ENABLED(ENDSTOP_NOISE_FILTER)
     update();
@@ -206,6 +224,10 @@ void Endstops::poll() {
 void Endstops::enable_globally(const bool onoff) {
   enabled_globally = enabled = onoff;
 
+  #if ENABLED(ENDSTOP_SCAN_MASK)
+    refresh_scan_mask();
+  #endif
+
   #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
     update();
   #endif
@@ -215,6 +237,10 @@ void Endstops::enable_globally(const bool onoff) {
 void Endstops::enable(const bool onoff) {
   enabled = onoff;
 
+  #if ENABLED(ENDSTOP_SCAN_MASK)
+    refresh_scan_mask();
+  #endif
+
   #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
     update();
   #endif
@@ -224,6 +250,10 @@ void Endstops::enable(const bool onoff) {
 void Endstops::not_homing() {
   enabled = enabled_globally;
 
+  #if ENABLED(ENDSTOP_SCAN_MASK)
+    refresh_scan_mask();
+  #endif
+
   #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
     update();
   #endif
@@ -242,6 +272,10 @@ void Endstops::not_homing() {
   void Endstops::enable_z_probe(const bool onoff) {
     z_probe_enabled = onoff;
 
+    #if ENABLED(ENDSTOP_SCAN_MASK)
+      refresh_scan_mask();
+    #endif
+
     #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
       update();
     #endif
@@ -383,6 +417,14 @@ void _O2 Endstops::M119() {
       }
     #endif
   #endif
+  #if ENABLED(ENDSTOP_SCAN_MASK)
+    CRITICAL_SECTION_START;
+    const uint32_t polls = poll_count, skipped = polls_skipped;
+    CRITICAL_SECTION_END;
+    SERIAL_PROTOCOLPAIR("Endstop polls skipped: ", skipped);
+    SERIAL_PROTOCOLPAIR(" of ", polls);
+    SERIAL_PROTOCOLLNPAIR(" Polled: ", polled_bits);
+  #endif
 } // Endstops::M119
 
 // The following routines are called from an ISR context. It could be the temperature ISR, the
@@ -395,11 +437,27 @@ void _O2 Endstops::M119() {
 // Check endstops - Could be called from Temperature ISR!
 void Endstops::update() {
 
-  #if DISABLED(ENDSTOP_NOISE_FILTER)
-    if (!abort_enabled()) return;
+  #if ENABLED(ENDSTOP_SCAN_MASK)
+    // Only read the endstops that can stop the current move
+    const esbits_t mask = scan_mask;
+    if (!mask) {
+      #if ENABLED(ENDSTOP_NOISE_FILTER)
+        endstop_poll_count = 0; // Nothing left to validate
+      #endif
+      return;
+    }
+    #define ENDSTOP_SCANNED(ES) TEST(mask, ES)
+  #else
+    #if DISABLED(ENDSTOP_NOISE_FILTER)
+      if (!abort_enabled()) return;
+    #endif
+    #define ENDSTOP_SCANNED(ES) true
   #endif
 
-  #define UPDATE_ENDSTOP_BIT(AXIS, MINMAX) SET_BIT_TO(live_state, _ENDSTOP(AXIS, MINMAX), (READ(_ENDSTOP_PIN(AXIS, MINMAX)) != _ENDSTOP_INVERTING(AXIS, MINMAX)))
+  #define UPDATE_ENDSTOP_BIT(AXIS, MINMAX) do{ \
+    if (ENDSTOP_SCANNED(_ENDSTOP(AXIS, MINMAX))) \
+      SET_BIT_TO(live_state, _ENDSTOP(AXIS, MINMAX), (READ(_ENDSTOP_PIN(AXIS, MINMAX)) != _ENDSTOP_INVERTING(AXIS, MINMAX))); \
+  }while(0)
   #define COPY_LIVE_STATE(SRC_BIT, DST_BIT) SET_BIT_TO(live_state, DST_BIT, TEST(live_state, SRC_BIT))
 
   #if ENABLED(G38_PROBE_TARGET) && PIN_EXISTS(Z_MIN_PROBE) && !(CORE_IS_XY || CORE_IS_XZ)
@@ -662,6 +720,58 @@ void Endstops::update() {
   }
 } // Endstops::update()
 
+#if ENABLED(ENDSTOP_SCAN_MASK)
+
+  #if ENABLED(X_DUAL_ENDSTOPS)
+    #define X_MIN_BITS (_BV(X_MIN) | _BV(X2_MIN))
+    #define X_MAX_BITS (_BV(X_MAX) | _BV(X2_MAX))
+  #else
+    #define X_MIN_BITS _BV(X_MIN)
+    #define X_MAX_BITS _BV(X_MAX)
+  #endif
+  #if ENABLED(Y_DUAL_ENDSTOPS)
+    #define Y_MIN_BITS (_BV(Y_MIN) | _BV(Y2_MIN))
+    #define Y_MAX_BITS (_BV(Y_MAX) | _BV(Y2_MAX))
+  #else
+    #define Y_MIN_BITS _BV(Y_MIN)
+    #define Y_MAX_BITS _BV(Y_MAX)
+  #endif
+  #if ENABLED(Z_DUAL_ENDSTOPS)
+    #define Z_MIN_BITS (_BV(Z_MIN) | _BV(Z2_MIN) | _BV(Z_MIN_PROBE))
+    #define Z_MAX_BITS (_BV(Z_MAX) | _BV(Z2_MAX))
+  #else
+    #define Z_MIN_BITS (_BV(Z_MIN) | _BV(Z_MIN_PROBE))
+    #define Z_MAX_BITS _BV(Z_MAX)
+  #endif
+
+  void Endstops::refresh_scan_mask() {
+    esbits_t mask = 0;
+
+    // Same selection as the checks at the end of update()
+    if (abort_enabled()) {
+      if (stepper.axis_is_moving(X_AXIS)) mask |= stepper.motor_direction(X_AXIS_HEAD) ? X_MIN_BITS : X_MAX_BITS;
+      if (stepper.axis_is_moving(Y_AXIS)) mask |= stepper.motor_direction(Y_AXIS_HEAD) ? Y_MIN_BITS : Y_MAX_BITS;
+      if (stepper.axis_is_moving(Z_AXIS)) mask |= stepper.motor_direction(Z_AXIS_HEAD) ? Z_MIN_BITS : Z_MAX_BITS;
+    }
+
+    #if ENABLED(G38_PROBE_TARGET) && PIN_EXISTS(Z_MIN_PROBE) && !(CORE_IS_XY || CORE_IS_XZ)
+      if (G38_move) SBI(mask, Z_MIN_PROBE);
+    #endif
+
+    CRITICAL_SECTION_START;
+    // Endstops left out keep their last state. One that's scanned again reads
+    // as open until it's read, so a stale state can't stop the new move.
+    const esbits_t rescanned = mask & ~scan_mask;
+    scan_mask = mask;
+    live_state &= ~rescanned;
+    #if ENABLED(ENDSTOP_NOISE_FILTER)
+      validated_live_state &= ~rescanned;
+    #endif
+    CRITICAL_SECTION_END;
+  }
+
+#endif // ENDSTOP_SCAN_MASK
+
 #if ENABLED(PINS_DEBUGGING)
 
   bool Endstops::monitor_flag = false;
@@ -77,6 +77,13 @@ class Endstops {
       static uint8_t endstop_poll_count;    // Countdown from threshold for polling
     #endif
 
+    #if ENABLED(ENDSTOP_SCAN_MASK)
+      static volatile esbits_t scan_mask;   // Endstops that can stop the current move
+      static esbits_t polled_bits;          // Endstops without an interrupt, which poll() must read
+      static volatile uint32_t poll_count,  // Calls to poll()
+                               polls_skipped; // Calls to poll() that had nothing to read
+    #endif
+
   public:
     Endstops() {};
 
@@ -108,6 +115,14 @@ class Endstops {
      */
     static void update();
 
+    #if ENABLED(ENDSTOP_SCAN_MASK)
+      /**
+       * Select the endstops update() reads from the move direction and the enabled state.
+       * Called by the Stepper ISR at the start of each block and whenever checking is switched.
+       */
+      static void refresh_scan_mask();
+    #endif
+
     /**
      * Get Endstop hit state.
      */
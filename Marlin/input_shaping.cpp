@@ -0,0 +1,117 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (C) 2016 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * input_shaping.cpp - Compute the X/Y input shaper impulses
+ *
+ * A shaper replaces each step with a few smaller, delayed impulses.
+ * The delays are fractions of the ringing period and the weights are
+ * chosen so the vibrations started by the impulses cancel out.
+ * See buildroot/share/scripts/inputShapingSim.py for the same math.
+ */
+
+#include "MarlinConfig.h"
+
+#if ENABLED(INPUT_SHAPING)
+
+#include "input_shaping.h"
+#include "Marlin.h"
+#include "planner.h"
+#include "stepper.h"
+
+InputShaping input_shaping; // Single instance - this calls the constructor
+
+uint8_t InputShaping::type;                 // M593 T - Shaper type
+float InputShaping::frequency[2],           // M593 F - (Hz) Resonant frequency of X and Y
+      InputShaping::zeta[2];                // M593 D - Damping ratio of X and Y
+
+void InputShaping::reset() {
+  type = SHAPING_TYPE;
+  frequency[X_AXIS] = SHAPING_FREQ_X;
+  frequency[Y_AXIS] = SHAPING_FREQ_Y;
+  zeta[X_AXIS] = SHAPING_ZETA_X;
+  zeta[Y_AXIS] = SHAPING_ZETA_Y;
+}
+
+uint8_t InputShaping::impulses(const AxisEnum axis, uint16_t weight[SHAPING_MAX_IMPULSES], uint8_t delay[SHAPING_MAX_IMPULSES]) {
+  if (frequency[axis] <= 0) return 0;
+
+  const float z = constrain(zeta[axis], 0, 0.5),
+              df = SQRT(1 - sq(z)),
+              K = exp(-z * M_PI / df),
+              td = 1 / (frequency[axis] * df);   // Damped period of the ringing
+
+  float a[SHAPING_MAX_IMPULSES], t[SHAPING_MAX_IMPULSES];
+  uint8_t n;
+  switch (type) {
+    case SHAPER_ZV:
+      a[0] = 1; a[1] = K;
+      t[0] = 0; t[1] = 0.5 * td;
+      n = 2;
+      break;
+    case SHAPER_MZV: {
+      const float Km = exp(-0.75 * z * M_PI / df);
+      a[0] = 1 - M_SQRT1_2; a[1] = (M_SQRT2 - 1) * Km; a[2] = a[0] * sq(Km);
+      t[0] = 0; t[1] = 0.375 * td; t[2] = 0.75 * td;
+      n = 3;
+    } break;
+    default: {
+      const float v = 0.05; // Tolerated residual vibration
+      a[0] = 0.25 * (1 + v); a[1] = 0.5 * (1 - v) * K; a[2] = a[0] * sq(K);
+      t[0] = 0; t[1] = 0.5 * td; t[2] = td;
+      n = 3;
+    } break;
+  }
+
+  // Quantize to 1/256 step, keeping the sum of the weights exactly one step,
+  // and the delays to whole slots of the stepper's shaping clock.
+  float sum = 0;
+  for (uint8_t i = 0; i < n; i++) sum += a[i];
+  weight[0] = 256;
+  delay[0] = 0;
+  for (uint8_t i = 1; i < n; i++) {
+    weight[i] = LROUND(256 * a[i] / sum);
+    weight[0] -= weight[i];
+    const float slots = t[i] * float(STEPPER_TIMER_RATE) / (SHAPING_SLOT_TICKS);
+    // The step history must outlast the longest delay
+    if (slots > SHAPING_BUFFER_SIZE - 2) return 0;
+    delay[i] = MAX(1, LROUND(slots));
+  }
+  return n;
+}
+
+void InputShaping::refresh() {
+  planner.synchronize();
+  for (uint8_t i = X_AXIS; i <= Y_AXIS; i++) {
+    uint16_t weight[SHAPING_MAX_IMPULSES];
+    uint8_t delay[SHAPING_MAX_IMPULSES];
+    const uint8_t n = impulses((AxisEnum)i, weight, delay);
+    if (!n && frequency[i] > 0) {
+      SERIAL_ECHO_START();
+      SERIAL_CHAR(axis_codes[i]);
+      SERIAL_ECHOLNPGM(" shaping frequency too low");
+    }
+    stepper.set_shaping((AxisEnum)i, n, weight, delay);
+  }
+}
+
+#endif // INPUT_SHAPING
@@ -0,0 +1,59 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (C) 2016 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * input_shaping.h - Define the X/Y input shaper settings interface
+ */
+
+#ifndef INPUT_SHAPING_H
+#define INPUT_SHAPING_H
+
+#include "MarlinConfig.h"
+
+enum ShaperType : uint8_t { SHAPER_ZV, SHAPER_MZV, SHAPER_EI };
+
+#define SHAPER_COUNT         3
+#define SHAPING_MAX_IMPULSES 3
+
+// The stepper times shaped steps in slots of 1024 timer ticks (512µs on AVR)
+#define SHAPING_SLOT_TICKS   1024
+
+class InputShaping {
+public:
+  static uint8_t type;          // M593 T - Shaper type
+  static float frequency[2],    // M593 F - (Hz) Resonant frequency of X and Y. 0 = unshaped.
+               zeta[2];         // M593 D - Damping ratio of X and Y
+
+  InputShaping() { reset(); }
+
+  static void reset();
+
+  // Hand the shaper impulses to the stepper. Waits for all moves to finish.
+  static void refresh();
+
+  // Impulse weights (1/256) and delays (shaping slots) for an axis. Returns the impulse count.
+  static uint8_t impulses(const AxisEnum axis, uint16_t weight[SHAPING_MAX_IMPULSES], uint8_t delay[SHAPING_MAX_IMPULSES]);
+};
+
+extern InputShaping input_shaping;
+
+#endif // INPUT_SHAPING_H
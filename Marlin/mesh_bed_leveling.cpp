@@ -28,6 +28,10 @@
   #include "Marlin.h"
   #include "serial.h"
 
+  #if ENABLED(MESH_FADE_PER_LAYER)
+    #include "planner.h"
+  #endif
+
   mesh_bed_leveling mbl;
 
   float mesh_bed_leveling::z_offset,
@@ -35,6 +39,13 @@
         mesh_bed_leveling::index_to_xpos[GRID_MAX_POINTS_X],
         mesh_bed_leveling::index_to_ypos[GRID_MAX_POINTS_Y];
 
+  #if ENABLED(MESH_FADE_PER_LAYER)
+    float mesh_bed_leveling::layer_z = -999.999f,
+          mesh_bed_leveling::layer_factor,
+          mesh_bed_leveling::layer_values[GRID_MAX_POINTS_X][GRID_MAX_POINTS_Y];
+    uint16_t mesh_bed_leveling::layer_rows;
+  #endif
+
   mesh_bed_leveling::mesh_bed_leveling() {
     for (uint8_t i = 0; i < GRID_MAX_POINTS_X; ++i)
       index_to_xpos[i] = MESH_MIN_X + i * (MESH_X_DIST);
@@ -46,8 +57,25 @@
   void mesh_bed_leveling::reset() {
     z_offset = 0;
     ZERO(z_values);
+    reset_layer();
   }
 
+  #if ENABLED(MESH_FADE_PER_LAYER)
+
+    void mesh_bed_leveling::start_layer(const float &rz) {
+      layer_z = rz;
+      layer_factor = planner.fade_scaling_factor_for_z(rz);
+      layer_rows = 0;
+    }
+
+    void mesh_bed_leveling::scale_layer_row(const uint8_t py) {
+      for (uint8_t px = 0; px < GRID_MAX_POINTS_X; px++)
+        layer_values[px][py] = z_values[px][py] * layer_factor;
+      SBI(layer_rows, py);
+    }
+
+  #endif
+
   void mesh_bed_leveling::report_mesh() {
     SERIAL_PROTOCOLLNPGM("Num X,Y: " STRINGIFY(GRID_MAX_POINTS_X) "," STRINGIFY(GRID_MAX_POINTS_Y));
     SERIAL_PROTOCOLPGM("Z offset: "); SERIAL_PROTOCOL_F(z_offset, 5);
@@ -57,7 +57,31 @@ public:
     return false;
   }
 
-  static void set_z(const int8_t px, const int8_t py, const float &z) { z_values[px][py] = z; }
+  #if ENABLED(MESH_FADE_PER_LAYER)
+
+    /**
+     * Leveling context for the current layer: the mesh scaled by the fade factor
+     * for layer_z. Rows are scaled as moves first reach them, so a Z hop or a layer
+     * that only covers part of the bed doesn't pay for the whole mesh.
+     */
+    static float layer_z, layer_factor,
+                 layer_values[GRID_MAX_POINTS_X][GRID_MAX_POINTS_Y];
+    static uint16_t layer_rows; // Bit per row of layer_values[][] already scaled
+    static_assert(GRID_MAX_POINTS_Y <= 8 * sizeof(layer_rows), "layer_rows needs a bit for each mesh row.");
+
+    // Call after z_values[][] or the fade height changes
+    FORCE_INLINE static void reset_layer() { layer_z = -999.999f; }
+
+    static void start_layer(const float &rz);
+    static void scale_layer_row(const uint8_t py);
+
+  #else
+
+    FORCE_INLINE static void reset_layer() {}
+
+  #endif
+
+  static void set_z(const int8_t px, const int8_t py, const float &z) { z_values[px][py] = z; reset_layer(); }
 
   static inline void zigzag(const int8_t index, int8_t &px, int8_t &py) {
     px = index % (GRID_MAX_POINTS_X);
@@ -113,6 +137,30 @@ public:
       #endif
     ;
   }
+
+  #if ENABLED(MESH_FADE_PER_LAYER)
+
+    /**
+     * Same as get_z, for the fade factor of rz, but interpolating the pre-scaled
+     * layer copy of the mesh. The mesh spacing is constant, so no division is needed.
+     */
+    static float get_layer_z(const float &x0, const float &y0, const float &rz) {
+      if (rz != layer_z) start_layer(rz);
+      if (!layer_factor) return z_offset;
+
+      const int8_t cx = cell_index_x(x0), cy = cell_index_y(y0);
+      if (!TEST(layer_rows, cy)) scale_layer_row(cy);
+      if (!TEST(layer_rows, cy + 1)) scale_layer_row(cy + 1);
+
+      const float xratio = (x0 - index_to_xpos[cx]) * (1.0f / (MESH_X_DIST)),
+                  yratio = (y0 - index_to_ypos[cy]) * (1.0f / (MESH_Y_DIST)),
+                  z1 = layer_values[cx][cy] + xratio * (layer_values[cx + 1][cy] - layer_values[cx][cy]),
+                  z2 = layer_values[cx][cy + 1] + xratio * (layer_values[cx + 1][cy + 1] - layer_values[cx][cy + 1]);
+
+      return z_offset + z1 + yratio * (z2 - z1);
+    }
+
+  #endif
 };
 
 extern mesh_bed_leveling mbl;
@@ -43,8 +43,13 @@ bool GCodeParser::volumetric_enabled;
 #endif
 
 char *GCodeParser::command_ptr,
-     *GCodeParser::string_arg,
-     *GCodeParser::value_ptr;
+     *GCodeParser::string_arg;
+#if ENABLED(BINARY_COMMAND_QUEUE)
+  const gcode_value_t *GCodeParser::value_ptr,
+                      *GCodeParser::values;
+#else
+  char *GCodeParser::value_ptr;
+#endif
 char GCodeParser::command_letter;
 int GCodeParser::codenum;
 #if USE_GCODE_SUBCODES
@@ -81,6 +86,219 @@ void GCodeParser::reset() {
   #endif
 }
 
+#if ENABLED(BINARY_COMMAND_QUEUE)
+
+  /**
+   * Only common commands that are always built in and don't use string_arg
+   * are queued without their text. Everything else keeps it, for string_arg
+   * and for the "Unknown command" echo.
+   */
+  static bool needs_text(const char letter, const int codenum) {
+    switch (letter) {
+      case 'T': return false;
+      case 'G': switch (codenum) {
+        case 0: case 1: case 4: case 28: case 90: case 91: case 92:
+        #if ENABLED(ARC_SUPPORT) && DISABLED(SCARA)
+          case 2: case 3:
+        #endif
+        #if ENABLED(FWRETRACT)
+          case 10: case 11:
+        #endif
+          return false;
+      }
+      break;
+      case 'M': switch (codenum) {
+        case 17: case 18: case 82: case 83: case 84: case 104: case 105: case 109: case 114:
+        case 204: case 205: case 220: case 221: case 400:
+        #if HAS_HEATED_BED
+          case 140: case 190:
+        #endif
+        #if FAN_COUNT > 0
+          case 106: case 107:
+        #endif
+          return false;
+      }
+      break;
+    }
+    return true;
+  }
+
+  // Store a value accepted by valid_float(), up to the first non-digit, as strtod would read it
+  static void encode_value(const char *p, gcode_value_t &v, const uint8_t ind) {
+    const bool neg = (*p == '-');
+    if (*p == '-' || *p == '+') p++;
+    int32_t m = 0;
+    uint8_t places = 0;
+    bool point = false;
+    for (;; p++) {
+      const char c = *p;
+      if (c == '.' && !point) { point = true; continue; }
+      if (!NUMERIC(c)) break;
+      if (m >= 214748364L) {                        // No room for another digit
+        if (!point) m = 2147483647L;                // Saturate, like strtol
+        continue;
+      }
+      if (point) {
+        if (places >= VALUE_PLACES_MAX) continue;   // Beyond float precision
+        places++;
+      }
+      m = m * 10 + (c - '0');
+    }
+    v.mantissa = neg ? -m : m;
+    v.code_places = (ind << 3) | places;
+  }
+
+  /**
+   * Decode the command and its parameters into the record, exactly as parse() would,
+   * and return the string_arg. The line (a copy) is modified in the same way.
+   */
+  static char* decode_command(char *p, gcode_record_t * const rec) {
+
+    // Get the command letter, which must be G, M, or T
+    const char letter = *p;
+    if (!letter) return NULL;
+    p++;
+
+    // Nullify asterisk and trailing whitespace
+    char *starpos = strchr(p, '*');
+    if (starpos) {
+      --starpos;                          // *
+      while (*starpos == ' ') --starpos;  // spaces...
+      starpos[1] = '\0';
+    }
+
+    // Bail if the letter is not G, M, or T
+    switch (letter) { case 'G': case 'M': case 'T': break; default: return NULL; }
+
+    // Skip spaces to get the numeric part
+    while (*p == ' ') p++;
+
+    // Bail if there's no command code number
+    if (!NUMERIC(*p)) return NULL;
+
+    rec->letter = letter;
+
+    int codenum = 0;
+    do {
+      codenum *= 10, codenum += *p++ - '0';
+    } while (NUMERIC(*p));
+    rec->codenum = codenum;
+
+    #if USE_GCODE_SUBCODES
+      if (*p == '.') {
+        p++;
+        while (NUMERIC(*p))
+          rec->subcode *= 10, rec->subcode += *p++ - '0';
+      }
+    #endif
+
+    // Skip all spaces to get to the first argument, or nul
+    while (*p == ' ') p++;
+
+    // Only use string_arg for these M codes
+    if (letter == 'M') switch (codenum) { case 23: case 28: case 30: case 117: case 118: case 928: return p; default: break; }
+
+    gcode_value_t * const values = rec->values();
+    char *string_arg = NULL;
+    while (const char code = *p++) {
+
+      // Special handling for M32 [P] !/path/to/file.g#
+      if (code == '!' && letter == 'M' && codenum == 32) {
+        char * const lb = strchr(p, '#');
+        if (lb) *lb = '\0';
+        return p;
+      }
+
+      if (WITHIN(code, 'A', 'Z')) {
+        while (*p == ' ') p++;                    // Skip spaces between parameters & values
+
+        const bool has_num = GCodeParser::valid_float(p);
+        if (!has_num && !string_arg) string_arg = p - 1;
+
+        const uint8_t ind = LETTER_BIT(code);
+        SBI32(rec->codebits, ind);
+
+        // A repeated parameter replaces the earlier one
+        uint8_t i = 0;
+        while (i < rec->count && (values[i].code_places >> 3) != ind) i++;
+        if (has_num) {
+          encode_value(p, values[i], ind);
+          if (i == rec->count) rec->count++;
+        }
+        else if (i < rec->count)
+          values[i] = values[--rec->count];
+      }
+      else if (!string_arg)                       // Not A-Z? First time, keep as the string_arg
+        string_arg = p - 1;
+
+      if (!WITHIN(*p, 'A', 'Z')) {                // Another parameter right away?
+        while (*p && DECIMAL_SIGNED(*p)) p++;     // Skip over the value section of a parameter
+        while (*p == ' ') p++;                    // Skip over all spaces
+      }
+    }
+    return string_arg;
+  }
+
+  uint16_t GCodeParser::encode(const char *p, gcode_record_t * const rec, const bool keep_text) {
+    rec->flags = rec->count = rec->text = rec->string_arg = 0;
+    rec->letter = '?';
+    rec->codenum = 0;
+    #if USE_GCODE_SUBCODES
+      rec->subcode = 0;
+    #endif
+    rec->codebits = 0;
+
+    // Skip spaces
+    while (*p == ' ') ++p;
+
+    // Skip N[-0-9] if included in the command line
+    if (*p == 'N' && NUMERIC_SIGNED(p[1])) {
+      #if ENABLED(ADVANCED_OK)
+        rec->flags |= RECORD_HAS_N;
+        rec->N = strtol(p + 1, NULL, 10);
+      #endif
+      p += 2;
+      while (NUMERIC(*p)) ++p;
+      while (*p == ' ') ++p;
+    }
+
+    // Decode a copy of the command placed beyond the largest set of values
+    char * const line = (char*)(rec->values() + 26);
+    strncpy(line, p, MAX_CMD_SIZE - 1);
+    line[MAX_CMD_SIZE - 1] = '\0';
+    const char * const string_arg = decode_command(line, rec);
+
+    uint16_t size = sizeof(gcode_record_t) + rec->count * sizeof(gcode_value_t);
+
+    // Move the text down to the values if it's wanted
+    if (keep_text || needs_text(rec->letter, rec->codenum)) {
+      const uint8_t len = strlen(line);
+      memmove((char*)rec + size, line, len + 1);
+      rec->text = size;
+      if (string_arg) rec->string_arg = string_arg - line;
+      size += len + 1;
+    }
+
+    return (rec->size = size);
+  }
+
+  // Populate all fields from a queue record
+  void GCodeParser::load(const gcode_record_t * const rec) {
+    command_letter = rec->letter;
+    codenum = rec->codenum;
+    #if USE_GCODE_SUBCODES
+      subcode = rec->subcode;
+    #endif
+    codebits = rec->codebits;
+    values = rec->values();
+    ZERO(param);
+    for (uint8_t i = 0; i < rec->count; i++) param[values[i].code_places >> 3] = i + 1;
+    command_ptr = rec->text ? rec->command_text() : (char*)"";
+    string_arg = rec->string_arg ? command_ptr + rec->string_arg : NULL;
+  }
+
+#else // !BINARY_COMMAND_QUEUE
+
 // Populate all fields by parsing a single line of GCode
 // 58 bytes of SRAM are used to speed up seen/value
 void GCodeParser::parse(char *p) {
@@ -228,6 +446,237 @@ void GCodeParser::parse(char *p) {
   }
 }
 
+#endif // !BINARY_COMMAND_QUEUE
+
+#if ENABLED(SERIAL_LINE_TOKENIZER)
+
+  // Populate all fields from tokens gathered by the serial line reader
+  void GCodeParser::parse(char * const p, const gcode_tokens_t &tokens) {
+    command_ptr = p + tokens.cmd;
+    command_letter = tokens.letter;
+    codenum = tokens.codenum;
+    #if USE_GCODE_SUBCODES
+      subcode = tokens.subcode;
+    #endif
+    string_arg = tokens.string_arg ? command_ptr + tokens.string_arg : NULL;
+    codebits = tokens.codebits;
+    memcpy(param, tokens.param, sizeof(param));
+  }
+
+  gcode_tokens_t GCodeLineReader::tokens;
+  bool GCodeLineReader::has_N, GCodeLineReader::has_checksum,
+       GCodeLineReader::N_negative, GCodeLineReader::sum_negative;
+  long GCodeLineReader::N;
+  uint8_t GCodeLineReader::checksum, GCodeLineReader::xsum,
+          GCodeLineReader::state, GCodeLineReader::value_state, GCodeLineReader::sum_state,
+          GCodeLineReader::value_index, GCodeLineReader::value_param,
+          GCodeLineReader::last_index, GCodeLineReader::cut;
+  int16_t GCodeLineReader::sent_checksum;
+
+  enum : uint8_t { VS_NONE, VS_START, VS_SIGN, VS_DOT };      // Checking for [-+]?.?[0-9]
+  enum : uint8_t { SUM_NONE, SUM_SPACES, SUM_DIGITS, SUM_DONE };  // Reading the number after '*'
+
+  /**
+   * Follow the same steps as parse() and the checksum test in
+   * get_serial_commands(), one character at a time.
+   */
+  void GCodeLineReader::feed(const char c, const uint8_t index) {
+
+    if (index == 0) {                         // A new line
+      state = LR_LEADING;
+      value_state = VS_NONE;
+      sum_state = SUM_NONE;
+      xsum = cut = 0;
+      has_N = has_checksum = N_negative = sum_negative = false;
+      tokens.cmd = 0xFF;
+    }
+
+    // Leading spaces are not part of the command or the checksum
+    if (state == LR_LEADING && c == ' ') return;
+
+    // The checksum covers everything before the last '*'
+    if (c == '*') {
+      checksum = xsum;
+      has_checksum = true;
+      sent_checksum = 0;
+      sum_negative = false;
+      sum_state = SUM_SPACES;
+    }
+    else switch (sum_state) {
+      case SUM_SPACES:
+        if (c == ' ') break;
+        sum_state = SUM_DIGITS;
+        if (c == '-' || c == '+') { sum_negative = (c == '-'); break; }
+      case SUM_DIGITS:
+        if (!NUMERIC(c)) sum_state = SUM_DONE;
+        else if (sent_checksum < 1000) sent_checksum = sent_checksum * 10 + c - '0';
+      default: break;
+    }
+    xsum ^= c;
+
+    if (state == LR_DONE) return;
+
+    if (state >= LR_CODE_START) {
+      if (c == '*') {                         // The command ends at the first '*'
+        cut = last_index + 1;                 // ...minus any trailing spaces
+        end_command(cut);
+        return;
+      }
+      if (c != ' ') last_index = index;
+    }
+
+    if (value_state != VS_NONE) resolve_value(c);
+
+    switch (state) {
+
+      case LR_LEADING:
+        if (c == 'N') {
+          has_N = true;
+          N = 0;
+          state = LR_N_START;
+        }
+        else
+          start_command(c, index);
+        break;
+
+      case LR_N_START:                        // Only N[-+0-9] is skipped
+        if (!NUMERIC_SIGNED(c)) { untokenize(); break; }
+        state = LR_N;
+        if (!NUMERIC(c)) { N_negative = (c == '-'); break; }
+      case LR_N:
+        if (NUMERIC(c)) { N = N * 10 + c - '0'; break; }
+        state = LR_N_SPACES;
+      case LR_N_SPACES:
+        if (c != ' ') start_command(c, index);
+        break;
+
+      case LR_CODE_START:
+        if (c == ' ') break;
+        if (!NUMERIC(c)) { untokenize(); break; } // No command code number
+        state = LR_CODE;
+      case LR_CODE:
+        if (NUMERIC(c)) { tokens.codenum = tokens.codenum * 10 + c - '0'; break; }
+        #if USE_GCODE_SUBCODES
+          if (c == '.') { state = LR_SUBCODE; break; }
+        #endif
+        if (!code_done()) break;
+        state = LR_ARGS_START;
+        if (c != ' ') next_code(c, index);
+        break;
+
+      #if USE_GCODE_SUBCODES
+        case LR_SUBCODE:
+          if (NUMERIC(c)) { tokens.subcode = tokens.subcode * 10 + c - '0'; break; }
+          if (!code_done()) break;
+          state = LR_ARGS_START;
+          if (c != ' ') next_code(c, index);
+          break;
+      #endif
+
+      case LR_ARGS_START:
+        if (c != ' ') next_code(c, index);
+        break;
+
+      case LR_VALUE_SPACES:                   // Skip spaces between parameters & values
+        if (c == ' ') break;
+        value_index = index;
+        value_state = VS_START;
+        resolve_value(c);
+      case LR_AFTER_CODE:                     // Another parameter right away?
+        if (WITHIN(c, 'A', 'Z')) { next_code(c, index); break; }
+        state = LR_SKIP_VALUE;
+      case LR_SKIP_VALUE:                     // Skip over the value section of a parameter
+        if (DECIMAL_SIGNED(c)) break;
+        state = LR_SKIP_SPACES;
+      case LR_SKIP_SPACES:                    // Skip over all spaces
+        if (c != ' ') next_code(c, index);
+        break;
+    }
+  }
+
+  void GCodeLineReader::finish(char * const line, const uint8_t length) {
+    if (state != LR_DONE) end_command(length);
+    if (N_negative) N = -N;
+    if (sum_negative) sent_checksum = -sent_checksum;
+    if (tokenized() && cut) line[cut] = '\0'; // Nullify asterisk and trailing whitespace
+  }
+
+  // The command letter, which must be G, M, or T
+  void GCodeLineReader::start_command(const char c, const uint8_t index) {
+    switch (c) { case 'G': case 'M': case 'T': break; default: untokenize(); return; }
+    tokens.cmd = last_index = index;
+    tokens.letter = c;
+    tokens.codenum = 0;
+    #if USE_GCODE_SUBCODES
+      tokens.subcode = 0;
+    #endif
+    tokens.codebits = 0;
+    tokens.string_arg = 0;
+    state = LR_CODE_START;
+  }
+
+  // Leave string commands and M110 (with its own line number test) to parse()
+  bool GCodeLineReader::code_done() {
+    if (tokens.letter == 'M') switch (tokens.codenum) {
+      case 23: case 28: case 30: case 32: case 110: case 117: case 118: case 928:
+        untokenize();
+        return false;
+    }
+    #if ENABLED(DEBUG_GCODE_PARSER)
+      if (tokens.codenum == 800) { untokenize(); return false; }
+    #endif
+    return true;
+  }
+
+  void GCodeLineReader::next_code(const char c, const uint8_t index) {
+    if (WITHIN(c, 'A', 'Z')) {
+      value_param = LETTER_BIT(c);
+      state = LR_VALUE_SPACES;
+    }
+    else {
+      if (!tokens.string_arg) tokens.string_arg = index - tokens.cmd; // Not A-Z? First time, keep as the string_arg
+      state = LR_AFTER_CODE;
+    }
+  }
+
+  // Decide whether a value is numeric, as valid_float() would, once enough characters are in
+  void GCodeLineReader::resolve_value(const char c) {
+    switch (value_state) {
+      case VS_START:
+        if (c == '-' || c == '+') { value_state = VS_SIGN; return; }
+      case VS_SIGN:
+        if (c == '.') { value_state = VS_DOT; return; }
+      default: break;
+    }
+    value_state = VS_NONE;
+    const bool has_num = NUMERIC(c);
+    SBI32(tokens.codebits, value_param);
+    tokens.param[value_param] = has_num ? value_index - tokens.cmd : 0;
+    if (!has_num && !tokens.string_arg) tokens.string_arg = value_index - 1 - tokens.cmd;
+  }
+
+  // The end of the command, at the end of the line or the first '*'
+  void GCodeLineReader::end_command(const uint8_t index) {
+    if (value_state != VS_NONE) resolve_value('\0');
+    switch (state) {
+      case LR_LEADING: case LR_N_START: case LR_N: case LR_N_SPACES: case LR_CODE_START:
+        untokenize();                         // No command code
+        return;
+      case LR_CODE: case LR_SUBCODE:
+        if (!code_done()) return;
+        break;
+      case LR_VALUE_SPACES:                   // A parameter at the very end
+        value_index = index;
+        value_state = VS_START;
+        resolve_value('\0');
+        break;
+      default: break;
+    }
+    state = LR_DONE;
+  }
+
+#endif // SERIAL_LINE_TOKENIZER
+
 #if ENABLED(CNC_COORDINATE_SYSTEMS)
 
   // Parse the next parameter as a new command
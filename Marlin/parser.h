@@ -41,6 +41,67 @@
 
 #define strtof strtod
 
+#if ENABLED(SERIAL_LINE_TOKENIZER)
+  /**
+   * Tokens for one queued command, gathered by the serial line reader
+   * as the characters arrived. Offsets are relative to the command letter.
+   */
+  typedef struct {
+    uint32_t codebits;            // Parameters seen
+    uint8_t param[26],            // For A-Z, offsets to values (0 = no value)
+            cmd,                  // Offset of the command letter. 0xFF = no tokens.
+            string_arg;           // Offset of string_arg (0 = none)
+    char letter;                  // G, M, or T
+    int codenum;                  // 123
+    #if USE_GCODE_SUBCODES
+      uint8_t subcode;            // .1
+    #endif
+  } gcode_tokens_t;
+#endif
+
+#if ENABLED(BINARY_COMMAND_QUEUE)
+
+  /**
+   * A parameter value in fixed point: mantissa / 10^places
+   */
+  typedef struct {
+    int32_t mantissa;
+    uint8_t code_places;          // Parameter index << 3 | decimal places (0-7)
+  } gcode_value_t;
+
+  #define VALUE_PLACES_MAX 7
+
+  enum RecordFlag : uint8_t { RECORD_SAY_OK = _BV(0), RECORD_HAS_N = _BV(1) };
+
+  /**
+   * A command in the queue, decoded by GCodeParser::encode().
+   * The values follow the header, then the command text (if kept).
+   */
+  typedef struct {
+    uint16_t size;                // Size of the record. 0 marks the end of the pool.
+    uint8_t flags,                // RecordFlag bits
+            count,                // Number of values following the header
+            text,                 // Offset of the command text (0 = none)
+            string_arg;           // Offset of string_arg in the text (0 = none)
+    char letter;                  // G, M, T, or '?'
+    int codenum;                  // 123
+    #if USE_GCODE_SUBCODES
+      uint8_t subcode;            // .1
+    #endif
+    uint32_t codebits;            // Parameters seen
+    #if ENABLED(ADVANCED_OK)
+      int32_t N;                  // Line number, if RECORD_HAS_N
+    #endif
+
+    FORCE_INLINE gcode_value_t* values() const { return (gcode_value_t*)(this + 1); }
+    FORCE_INLINE char* command_text() const { return text ? (char*)this + text : NULL; }
+  } gcode_record_t;
+
+  // The largest record for a single line
+  #define RECORD_SIZE_MAX (sizeof(gcode_record_t) + 26 * sizeof(gcode_value_t) + MAX_CMD_SIZE)
+
+#endif
+
 /**
  * GCode parser
  *
@@ -56,7 +117,12 @@
 class GCodeParser {
 
 private:
-  static char *value_ptr;           // Set by seen, used to fetch the value
+  #if ENABLED(BINARY_COMMAND_QUEUE)
+    static const gcode_value_t *value_ptr;  // Set by seen, used to fetch the value
+    static const gcode_value_t *values;     // Values of the loaded record
+  #else
+    static char *value_ptr;                 // Set by seen, used to fetch the value
+  #endif
 
   #if ENABLED(FASTER_GCODE_PARSER)
     static uint32_t codebits;       // Parameters pre-scanned
@@ -146,8 +212,12 @@ public:
             SERIAL_CHAR('\''); SERIAL_CHAR(c); SERIAL_ECHOLNPGM("' is seen");
           }
         #endif
-        char * const ptr = command_ptr + param[ind];
-        value_ptr = param[ind] && valid_float(ptr) ? ptr : (char*)NULL;
+        #if ENABLED(BINARY_COMMAND_QUEUE)
+          value_ptr = param[ind] ? &values[param[ind] - 1] : NULL;
+        #else
+          char * const ptr = command_ptr + param[ind];
+          value_ptr = param[ind] && valid_float(ptr) ? ptr : (char*)NULL;
+        #endif
       }
       return b;
     }
@@ -178,9 +248,27 @@ public:
     return SEEN_TEST('X') || SEEN_TEST('Y') || SEEN_TEST('Z') || SEEN_TEST('E');
   }
 
-  // Populate all fields by parsing a single line of GCode
-  // This uses 54 bytes of SRAM to speed up seen/value
-  static void parse(char * p);
+  #if ENABLED(BINARY_COMMAND_QUEUE)
+
+    // Decode a single line of GCode into a queue record, which must have
+    // room for RECORD_SIZE_MAX bytes. Return the size of the record.
+    static uint16_t encode(const char *p, gcode_record_t * const rec, const bool keep_text);
+
+    // Populate all fields from a queue record. Values are read from the record.
+    static void load(const gcode_record_t * const rec);
+
+  #else
+
+    // Populate all fields by parsing a single line of GCode
+    // This uses 54 bytes of SRAM to speed up seen/value
+    static void parse(char * p);
+
+  #endif
+
+  #if ENABLED(SERIAL_LINE_TOKENIZER)
+    // Populate all fields from tokens gathered while the line was received
+    static void parse(char * const p, const gcode_tokens_t &tokens);
+  #endif
 
   #if ENABLED(CNC_COORDINATE_SYSTEMS)
     // Parse the next parameter as a new command
@@ -193,29 +281,54 @@ public:
   // Seen a parameter with a value
   inline static bool seenval(const char c) { return seen(c) && has_value(); }
 
-  // Float removes 'E' to prevent scientific notation interpretation
-  inline static float value_float() {
-    if (value_ptr) {
-      char *e = value_ptr;
-      for (;;) {
-        const char c = *e;
-        if (c == '\0' || c == ' ') break;
-        if (c == 'E' || c == 'e') {
-          *e = '\0';
-          const float ret = strtof(value_ptr, NULL);
-          *e = c;
-          return ret;
+  #if ENABLED(BINARY_COMMAND_QUEUE)
+
+    // 10^places for a fixed point value
+    FORCE_INLINE static int32_t value_scale() {
+      int32_t scale = 1;
+      for (uint8_t p = value_ptr->code_places & 0x07; p--;) scale *= 10;
+      return scale;
+    }
+
+    inline static float value_float() {
+      if (!value_ptr) return 0;
+      return (value_ptr->code_places & 0x07) ? float(value_ptr->mantissa) / value_scale() : float(value_ptr->mantissa);
+    }
+
+    // Code value as a long or ulong, dropping the fraction like strtol
+    inline static int32_t value_long() {
+      if (!value_ptr) return 0L;
+      return (value_ptr->code_places & 0x07) ? value_ptr->mantissa / value_scale() : value_ptr->mantissa;
+    }
+    FORCE_INLINE static uint32_t value_ulong() { return (uint32_t)value_long(); }
+
+  #else
+
+    // Float removes 'E' to prevent scientific notation interpretation
+    inline static float value_float() {
+      if (value_ptr) {
+        char *e = value_ptr;
+        for (;;) {
+          const char c = *e;
+          if (c == '\0' || c == ' ') break;
+          if (c == 'E' || c == 'e') {
+            *e = '\0';
+            const float ret = strtof(value_ptr, NULL);
+            *e = c;
+            return ret;
+          }
+          ++e;
         }
-        ++e;
+        return strtof(value_ptr, NULL);
       }
-      return strtof(value_ptr, NULL);
+      return 0;
     }
-    return 0;
-  }
 
-  // Code value as a long or ulong
-  inline static int32_t value_long() { return value_ptr ? strtol(value_ptr, NULL, 10) : 0L; }
-  inline static uint32_t value_ulong() { return value_ptr ? strtoul(value_ptr, NULL, 10) : 0UL; }
+    // Code value as a long or ulong
+    inline static int32_t value_long() { return value_ptr ? strtol(value_ptr, NULL, 10) : 0L; }
+    inline static uint32_t value_ulong() { return value_ptr ? strtoul(value_ptr, NULL, 10) : 0UL; }
+
+  #endif // !BINARY_COMMAND_QUEUE
 
   // Code value for use as time
   FORCE_INLINE static millis_t value_millis() { return value_ulong(); }
@@ -338,4 +451,63 @@ public:
 
 extern GCodeParser parser;
 
+#if ENABLED(SERIAL_LINE_TOKENIZER)
+
+  /**
+   * Serial line reader
+   *
+   * Each character is fed in as it's stored in the line buffer, so the
+   * line number, checksum, command code and parameter offsets are all
+   * known when the line ends. The queue keeps the tokens with the command
+   * and the parser uses them instead of scanning the line a second time.
+   *
+   * Lines the reader doesn't handle (M110, string arguments, commands
+   * without a code) get no tokens and go through the usual checks.
+   */
+  class GCodeLineReader {
+
+  public:
+    static gcode_tokens_t tokens;   // Tokens for the last line
+    static bool has_N,              // The line starts with N
+                has_checksum;       // The line has a '*'
+    static long N;                  // The line number
+    static uint8_t checksum;        // XOR of the line up to the last '*'
+    static int16_t sent_checksum;   // The number following the last '*'
+
+    // Take the next character, stored at 'index' in the line. Index 0 starts a new line.
+    static void feed(const char c, const uint8_t index);
+
+    // End the line, which is 'length' characters long. Tokens may shorten the line.
+    static void finish(char * const line, const uint8_t length);
+
+    FORCE_INLINE static bool tokenized() { return tokens.cmd != 0xFF; }
+
+  private:
+    enum LineReaderState : uint8_t {
+      LR_LEADING, LR_N_START, LR_N, LR_N_SPACES,          // Before the command letter
+      LR_CODE_START, LR_CODE, LR_SUBCODE, LR_ARGS_START,  // Command code
+      LR_VALUE_SPACES, LR_AFTER_CODE, LR_SKIP_VALUE,      // Parameters
+      LR_SKIP_SPACES, LR_DONE
+    };
+
+    static uint8_t state,           // Where we are in the line
+                   value_state,     // Where we are in checking for a parameter value
+                   sum_state,       // Where we are in the number after '*'
+                   value_index,     // Where the parameter value starts
+                   value_param,     // The parameter that owns the value
+                   last_index,      // The last non-space character of the command
+                   cut;             // Where the command ends if there's a '*'
+    static uint8_t xsum;            // Running XOR of the line
+    static bool N_negative, sum_negative;
+
+    static void untokenize() { tokens.cmd = 0xFF; state = LR_DONE; }
+    static void start_command(const char c, const uint8_t index);
+    static bool code_done();
+    static void next_code(const char c, const uint8_t index);
+    static void resolve_value(const char c);
+    static void end_command(const uint8_t index);
+  };
+
+#endif // SERIAL_LINE_TOKENIZER
+
 #endif // _PARSER_H_
@@ -31,7 +31,6 @@
 
 #include "pca9632.h"
 #include "leds.h"
-#include <Wire.h>
 
 #define PCA9632_MODE1_VALUE   0b00000001 //(ALLCALL)
 #define PCA9632_MODE2_VALUE   0b00010101 //(DIMMING, INVERT, CHANGE ON STOP,TOTEM)
@@ -73,6 +72,40 @@
 
 byte PCA_init = 0;
 
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+
+#include "MarlinTWI.h"
+
+static uint8_t pca9632_mode[] = { PCA9632_AUTO_ALL | PCA9632_MODE1, PCA9632_MODE1_VALUE, PCA9632_MODE2_VALUE },
+               pca9632_pwm[] = { PCA9632_AUTO_IND | PCA9632_PWM0, 0, 0, 0 },
+               pca9632_ledout[] = { PCA9632_LEDOUT, 0 };
+
+static TWITransfer pca9632_mode_xfer = { PCA9632_ADDRESS, sizeof(pca9632_mode), 0, pca9632_mode },
+                   pca9632_pwm_xfer = { PCA9632_ADDRESS, sizeof(pca9632_pwm), 0, pca9632_pwm },
+                   pca9632_ledout_xfer = { PCA9632_ADDRESS, sizeof(pca9632_ledout), 0, pca9632_ledout };
+
+void pca9632_set_led_color(const LEDColor &color) {
+  if (!PCA_init) {
+    PCA_init = 1;
+    MarlinTWI::init();
+    MarlinTWI::submit(pca9632_mode_xfer);
+  }
+
+  const uint8_t pwm[] = { color.r, color.g, color.b },
+                LEDOUT = (color.r ? LED_PWM << PCA9632_RED : 0)
+                       | (color.g ? LED_PWM << PCA9632_GRN : 0)
+                       | (color.b ? LED_PWM << PCA9632_BLU : 0);
+
+  // Both writes go out in one batch. If they're still waiting from the last
+  // call they take the new color with them.
+  MarlinTWI::refresh(pca9632_pwm_xfer, &pca9632_pwm[1], pwm, sizeof(pwm));
+  MarlinTWI::refresh(pca9632_ledout_xfer, &pca9632_ledout[1], &LEDOUT, 1);
+}
+
+#else
+
+#include <Wire.h>
+
 static void PCA9632_WriteRegister(const byte addr, const byte regadd, const byte value) {
   Wire.beginTransmission(addr);
   Wire.write(regadd);
@@ -115,4 +148,6 @@ void pca9632_set_led_color(const LEDColor &color) {
   PCA9632_WriteRegister(PCA9632_ADDRESS,PCA9632_LEDOUT, LEDOUT);
 }
 
+#endif // !TWI_TRANSACTION_QUEUE
+
 #endif // PCA9632
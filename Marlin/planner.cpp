@@ -146,12 +146,29 @@ float Planner::max_feedrate_mm_s[NUM_AXIS_N], // (mm/s) M203 XYZE - Max speeds
 
 int16_t Planner::flow_percentage[EXTRUDERS] = ARRAY_BY_EXTRUDERS1(100); // Extrusion factor for each extruder
 
+#if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+  int16_t Planner::override_percentage, // = 0
+          Planner::applied_feedrate_percentage = 100;
+#endif
+
 float Planner::e_factor[EXTRUDERS] = ARRAY_BY_EXTRUDERS1(1.0f); // The flow percentage and volumetric multiplier combine to scale E movement
 
+#if ENABLED(PLANNER_STARVATION_REPORT)
+  volatile millis_t Planner::starved_ms; // = 0
+#endif
+
+#if ENABLED(PATH_BLENDING)
+  float Planner::blend_tolerance_mm = BLEND_TOLERANCE_MM; // (mm) G64 P - Furthest a blended path may be from the moves
+#endif
+
 #if DISABLED(NO_VOLUMETRICS)
   float Planner::filament_size[EXTRUDERS],          // diameter of filament (in millimeters), typically around 1.75 or 2.85, 0 disables the volumetric calculations for the extruder
         Planner::volumetric_area_nominal = CIRCLE_AREA(float(DEFAULT_NOMINAL_FILAMENT_DIA) * 0.5f), // Nominal cross-sectional area
         Planner::volumetric_multiplier[EXTRUDERS];  // Reciprocal of cross-sectional area of filament (in mm^2). Pre-calculated to reduce computation in the planner
+  #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+    float Planner::volumetric_extruder_limit[EXTRUDERS],          // (mm³/s) M200 T L - Maximum volumetric flow, 0 for no limit
+          Planner::volumetric_extruder_feedrate_limit[EXTRUDERS]; // (mm/s) The same limit as a filament feedrate
+  #endif
 #endif
 
 #if HAS_LEVELING
@@ -197,6 +214,12 @@ uint32_t Planner::cutoff_long;
 float Planner::previous_speed[NUM_AXIS],
       Planner::previous_nominal_speed_sqr;
 
+#if ENABLED(PATH_BLENDING)
+  float Planner::previous_xy[2],
+        Planner::previous_xy_mm,
+        Planner::previous_e_per_mm;
+#endif
+
 #if ENABLED(DISABLE_INACTIVE_EXTRUDER)
   uint8_t Planner::g_uc_extruder_last_move[EXTRUDERS] = { 0 };
 #endif
@@ -233,6 +256,9 @@ void Planner::init() {
   #endif
   ZERO(previous_speed);
   previous_nominal_speed_sqr = 0;
+  #if ENABLED(PATH_BLENDING)
+    previous_xy_mm = 0;
+  #endif
   #if ABL_PLANAR
     bed_level_matrix.set_to_identity();
   #endif
@@ -1133,6 +1159,98 @@ void Planner::recalculate() {
   recalculate_trapezoids();
 }
 
+#if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+
+  /**
+   * Rescale the nominal speed of the queued blocks to a new feedrate percentage
+   * and replan them in place, so an override takes effect without waiting for
+   * the buffer to drain.
+   *
+   * The block next in line for the Stepper ISR is left alone, and the entry speed
+   * of the block after it is pinned, so no trapezoid can change under the ISR.
+   * From there each junction may drop no lower than full deceleration allows.
+   * Junctions never go above their speed at planning time.
+   *
+   * Returns false if the Stepper ISR took the pinned block during setup.
+   */
+  bool Planner::apply_feedrate_override(const int16_t percentage) {
+    if (percentage < 1) return true;
+
+    // The ISR may advance the nonbusy index, so get a local copy.
+    const uint8_t first_index = block_buffer_nonbusy,
+                  head_index = block_buffer_head;
+    if (first_index == head_index) return true;
+    const uint8_t pinned_index = next_block_index(first_index);
+    if (pinned_index == head_index) return true;
+
+    // Keep the Stepper ISR away from the blocks about to change
+    for (uint8_t b = pinned_index; b != head_index; b = next_block_index(b))
+      SBI(block_buffer[b].flag, BLOCK_BIT_RECALCULATE);
+
+    // If the ISR already took the pinned block, try again on the next call.
+    // Nothing was changed, so the existing trapezoids are still valid.
+    const uint8_t nonbusy_index = block_buffer_nonbusy;
+    if (nonbusy_index != first_index && nonbusy_index != pinned_index) {
+      for (uint8_t b = pinned_index; b != head_index; b = next_block_index(b))
+        CBI(block_buffer[b].flag, BLOCK_BIT_RECALCULATE);
+      return false;
+    }
+
+    const float min_speed_sqr = sq(float(MINIMUM_PLANNER_SPEED));
+    float floor_sqr = 0, ratio = 1;
+    block_t *previous = NULL;
+    for (uint8_t b = pinned_index; b != head_index; b = next_block_index(b)) {
+      block_t * const block = &block_buffer[b];
+
+      // Skip SYNC blocks
+      if (TEST(block->flag, BLOCK_BIT_SYNC_POSITION)) continue;
+
+      // The entry speed of the pinned block is the exit speed of the previous block
+      if (!previous) floor_sqr = block->entry_speed_sqr;
+
+      if (block->feedrate_percentage) {
+        const float factor = MIN(float(percentage) / block->feedrate_percentage, block->override_limit);
+        ratio = factor / block->override_factor;
+        block->override_factor = factor;
+        block->nominal_speed_sqr *= sq(ratio);
+      }
+      else
+        ratio = 1;
+
+      // The block must still be able to carry the slowest speed it can be entered with
+      NOLESS(block->nominal_speed_sqr, floor_sqr);
+      block->nominal_rate = CEIL(SQRT(block->nominal_speed_sqr) * block->step_event_count / block->millimeters);
+
+      if (previous) {
+        block->max_entry_speed_sqr = MIN3(block->max_junction_speed_sqr, block->nominal_speed_sqr, previous->nominal_speed_sqr);
+        NOLESS(block->max_entry_speed_sqr, floor_sqr);
+      }
+
+      if (block->nominal_speed_sqr <= max_allowable_speed_sqr(-block->acceleration, min_speed_sqr, block->millimeters))
+        SBI(block->flag, BLOCK_BIT_NOMINAL_LENGTH);
+      else
+        CBI(block->flag, BLOCK_BIT_NOMINAL_LENGTH);
+
+      // Slowest possible exit speed, decelerating over the whole block
+      floor_sqr = max_allowable_speed_sqr(block->acceleration, floor_sqr, block->millimeters);
+
+      previous = block;
+    }
+
+    // Let the next buffered block join the rescaled plan
+    if (previous) {
+      LOOP_NUM_AXIS(i) previous_speed[i] *= ratio;
+      previous_nominal_speed_sqr = previous->nominal_speed_sqr;
+    }
+
+    // Replan everything after the pinned block
+    block_buffer_planned = pinned_index;
+    recalculate();
+    return true;
+  }
+
+#endif // LIVE_FEEDRATE_OVERRIDE
+
 #if ENABLED(AUTOTEMP)
 
   void Planner::getHighESpeed() {
@@ -1319,11 +1437,16 @@ void Planner::check_axes_activity() {
   /**
    * Convert the filament sizes into volumetric multipliers.
    * The multiplier converts a given E value into a length.
+   * Also convert the volumetric flow limits into filament feedrates.
    */
   void Planner::calculate_volumetric_multipliers() {
     for (uint8_t i = 0; i < COUNT(filament_size); i++) {
       volumetric_multiplier[i] = calculate_volumetric_multiplier(filament_size[i]);
       refresh_e_factor(i);
+      #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+        volumetric_extruder_feedrate_limit[i] = (volumetric_extruder_limit[i] && filament_size[i])
+          ? volumetric_extruder_limit[i] / CIRCLE_AREA(filament_size[i] * 0.5f) : 0;
+      #endif
     }
   }
 
@@ -1371,6 +1494,10 @@ void Planner::check_axes_activity() {
       rx = dx + X_TILT_FULCRUM;
       ry = dy + Y_TILT_FULCRUM;
 
+    #elif ENABLED(MESH_FADE_PER_LAYER)
+
+      rz += mbl.get_layer_z(rx, ry, rz);
+
     #elif HAS_MESH
 
       #if ENABLED(ENABLE_LEVELING_FADE_HEIGHT)
@@ -1478,6 +1605,10 @@ void Planner::quick_stop() {
   // Make sure to drop any attempt of queuing moves for at least 1 second
   cleaning_buffer_counter = 1000;
 
+  #if ENABLED(PATH_BLENDING)
+    previous_xy_mm = 0; // Don't blend into the path that was dropped
+  #endif
+
   // Reenable Stepper ISR
   if (was_enabled) ENABLE_STEPPER_DRIVER_INTERRUPT();
 
@@ -1495,7 +1626,11 @@ float Planner::triggered_position_mm(const AxisEnum axis) {
 }
 
 void Planner::finish_and_disable() {
-  while (has_blocks_queued() || cleaning_buffer_counter) idle();
+  while (has_blocks_queued() || cleaning_buffer_counter
+    #if ENABLED(INPUT_SHAPING)
+      || stepper.shaping_busy()
+    #endif
+  ) idle();
   disable_all_steppers();
 }
 
@@ -1536,7 +1671,16 @@ float Planner::get_axis_position_mm(const AxisEnum axis) {
 /**
  * Block until all buffered steps are executed / cleaned
  */
-void Planner::synchronize() { while (has_blocks_queued() || cleaning_buffer_counter) idle(); }
+void Planner::synchronize() {
+  while (has_blocks_queued() || cleaning_buffer_counter
+    #if ENABLED(INPUT_SHAPING)
+      || stepper.shaping_busy()
+    #endif
+  ) idle();
+  #if ENABLED(PLANNER_STARVATION_REPORT)
+    starved_ms = 0; // Emptied on purpose
+  #endif
+}
 
 #if ENABLED(UNREGISTERED_MOVE_SUPPORT)
   #define COUNT_MOVE count_it
@@ -2073,14 +2217,33 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
 
   // Calculate and limit speed in mm/sec for each axis
   float current_speed[NUM_AXIS], speed_factor = 1.0f; // factor <1 decreases speed
+  #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+    float override_limit = 100.0f; // The most a later override may speed up this block
+  #endif
   LOOP_NUM_AXIS(i) {
     const float cs = ABS((current_speed[i] = delta_mm[i] * inverse_secs));
     #if ENABLED(DISTINCT_E_FACTORS)
       if (i == E_AXIS) i += extruder;
     #endif
+    #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+      if (cs > 0) NOMORE(override_limit, max_feedrate_mm_s[i] / cs);
+    #endif
     if (cs > max_feedrate_mm_s[i]) NOMORE(speed_factor, max_feedrate_mm_s[i] / cs);
   }
 
+  #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+    // Slow down a printing move that would extrude faster than the hotend can melt
+    if (current_speed[E_AXIS] > 0 && (block->steps[A_AXIS] || block->steps[B_AXIS] || block->steps[C_AXIS])) {
+      const float e_limit = volumetric_extruder_feedrate_limit[extruder];
+      if (e_limit) {
+        #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+          NOMORE(override_limit, e_limit / current_speed[E_AXIS]);
+        #endif
+        if (current_speed[E_AXIS] > e_limit) NOMORE(speed_factor, e_limit / current_speed[E_AXIS]);
+      }
+    }
+  #endif
+
   // Max segment time in µs.
   #ifdef XY_FREQUENCY_LIMIT
 
@@ -2126,6 +2289,13 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
     block->nominal_speed_sqr = block->nominal_speed_sqr * sq(speed_factor);
   }
 
+  #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+    block->feedrate_percentage = override_percentage;
+    block->override_factor = speed_factor;
+    // A block held back by the XY frequency limit stays at its planned speed
+    block->override_limit = speed_factor < 1.0f ? speed_factor : override_limit;
+  #endif
+
   // Compute and limit the acceleration rate for the trapezoid generator.
   const float steps_per_mm = block->step_event_count * inverse_millimeters;
   uint32_t accel;
@@ -2240,7 +2410,12 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   #if DISABLED(S_CURVE_ACCELERATION)
     block->acceleration_rate = (uint32_t)(accel * (4096.0f * 4096.0f / (STEPPER_TIMER_RATE)));
   #endif
-  #if ENABLED(LIN_ADVANCE)
+  #if ENABLED(LA_SINGLE_ISR)
+    if (block->use_advance_lead) {
+      // The advance due at any step rate of this block, for the Stepper ISR to follow
+      block->advance_scale = extruder_advance_K * block->steps[E_AXIS] / block->step_event_count * 16777216.0f;
+    }
+  #elif ENABLED(LIN_ADVANCE)
     if (block->use_advance_lead) {
       block->advance_speed = (STEPPER_TIMER_RATE) / (extruder_advance_K * block->e_D_ratio * block->acceleration * axis_steps_per_mm[E_AXIS_N]);
       #if ENABLED(LA_DEBUG)
@@ -2435,8 +2610,47 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
 
   #endif // Classic Jerk Limiting
 
+  #if ENABLED(PATH_BLENDING)
+    /**
+     * A run of short XY moves at the same extrusion rate is likely a sampled curve.
+     * Fit the arc through the start of the previous move, this junction and the end
+     * of this move. If both moves stay within the blending tolerance of that arc,
+     * allow the speed of the arc at the junction instead of the corner speed.
+     */
+    const float xy_mm = HYPOT(delta_mm[X_AXIS], delta_mm[Y_AXIS]),
+                e_per_mm = xy_mm > 0.0001f ? delta_mm[E_AXIS] / xy_mm : 0;
+
+    if (blend_tolerance_mm > 0 && moves_queued && !UNEAR_ZERO(previous_nominal_speed_sqr)
+      && !block->steps[Z_AXIS] && WITHIN(xy_mm, 0.0001f, BLEND_SEGMENT_MM) && WITHIN(previous_xy_mm, 0.0001f, BLEND_SEGMENT_MM)
+      && ABS(e_per_mm - previous_e_per_mm) <= ABS(previous_e_per_mm) * 0.05f + 0.00001f
+    ) {
+      const float dot = previous_xy[X_AXIS] * delta_mm[X_AXIS] + previous_xy[Y_AXIS] * delta_mm[Y_AXIS],
+                  cross = previous_xy[X_AXIS] * delta_mm[Y_AXIS] - previous_xy[Y_AXIS] * delta_mm[X_AXIS];
+      // Only gentle turns. A straight junction is already taken at full speed.
+      if (dot > 0 && ABS(cross) > 0.000001f) {
+        // Circumradius of the triangle formed by the two moves
+        const float chord = HYPOT(previous_xy[X_AXIS] + delta_mm[X_AXIS], previous_xy[Y_AXIS] + delta_mm[Y_AXIS]),
+                    radius = previous_xy_mm * xy_mm * chord / (2.0f * ABS(cross)),
+                    half = 0.5f * MAX(xy_mm, previous_xy_mm);
+        // Sag of the longer move below the arc
+        if (radius - SQRT(sq(radius) - sq(half)) <= blend_tolerance_mm) {
+          const float arc_speed_sqr = MIN3(block->acceleration * radius, block->nominal_speed_sqr, previous_nominal_speed_sqr);
+          NOLESS(vmax_junction_sqr, arc_speed_sqr);
+        }
+      }
+    }
+
+    previous_xy[X_AXIS] = delta_mm[X_AXIS];
+    previous_xy[Y_AXIS] = delta_mm[Y_AXIS];
+    previous_xy_mm = xy_mm;
+    previous_e_per_mm = e_per_mm;
+  #endif
+
   // Max entry speed of this block equals the max exit speed of the previous block.
   block->max_entry_speed_sqr = vmax_junction_sqr;
+  #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+    block->max_junction_speed_sqr = vmax_junction_sqr;
+  #endif
 
   // Initialize block entry speed. Compute based on deceleration to user-defined MINIMUM_PLANNER_SPEED.
   const float v_allowable_sqr = max_allowable_speed_sqr(-block->acceleration, sq(float(MINIMUM_PLANNER_SPEED)), block->millimeters);
@@ -2682,6 +2896,9 @@ void Planner::_set_position_mm(const float &a, const float &b, const float &c
     #endif
     position_float[E_AXIS] = e;
   #endif
+  #if ENABLED(PATH_BLENDING)
+    previous_xy_mm = 0; // A new position ends the curve
+  #endif
   if (has_blocks_queued()) {
     //previous_nominal_speed_sqr = 0.0; // Reset planner junction speeds. Assume start from rest.
     //ZERO(previous_speed);
@@ -2736,6 +2953,9 @@ void Planner::set_position_mm(const AxisEnum axis, const float &v) {
   #if HAS_POSITION_FLOAT
     position_float[axis] = v;
   #endif
+  #if ENABLED(PATH_BLENDING)
+    previous_xy_mm = 0; // A new position ends the curve
+  #endif
   if (has_blocks_queued())
     buffer_sync_block();
   else
@@ -40,6 +40,10 @@
   #include "vector_3.h"
 #endif
 
+#if ENABLED(MESH_FADE_PER_LAYER)
+  #include "mesh_bed_leveling.h"
+#endif
+
 enum BlockFlagBit : char {
   // Recalculate trapezoids on entry junction. For optimization.
   BLOCK_BIT_RECALCULATE,
@@ -125,8 +129,12 @@ typedef struct {
   // Advance extrusion
   #if ENABLED(LIN_ADVANCE)
     bool use_advance_lead;
-    uint16_t advance_speed,                 // STEP timer value for extruder speed offset ISR
-             max_adv_steps,                 // max. advance steps to get cruising speed pressure (not always nominal_speed!)
+    #if ENABLED(LA_SINGLE_ISR)
+      uint32_t advance_scale;               // Advance steps per step event/s, fixed point 8.24
+    #else
+      uint16_t advance_speed;               // STEP timer value for extruder speed offset ISR
+    #endif
+    uint16_t max_adv_steps,                 // max. advance steps to get cruising speed pressure (not always nominal_speed!)
              final_adv_steps;               // advance steps due to exit speed
     float e_D_ratio;
   #endif
@@ -146,6 +154,13 @@ typedef struct {
 
   uint32_t segment_time_us;
 
+  #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+    int16_t feedrate_percentage;            // Feedrate percentage the block was planned with. 0 if the override leaves it alone
+    float override_limit,                   // Largest speed factor the axis limits allow, relative to the requested speed
+          override_factor,                  // Speed factor currently applied to the requested speed
+          max_junction_speed_sqr;           // Junction speed limit at planning time in (mm/sec)^2
+  #endif
+
 } block_t;
 
 #define HAS_POSITION_FLOAT (ENABLED(LIN_ADVANCE) || HAS_FEEDRATE_SCALING)
@@ -183,6 +198,18 @@ class Planner {
 
     static int16_t flow_percentage[EXTRUDERS];      // Extrusion factor for each extruder
 
+    #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+      static int16_t override_percentage;           // Feedrate percentage of the moves being buffered, 0 for moves exempt from the override
+    #endif
+
+    #if ENABLED(PLANNER_STARVATION_REPORT)
+      static volatile millis_t starved_ms;          // When the Stepper ran out of blocks, 0 once noted or drained on purpose
+    #endif
+
+    #if ENABLED(PATH_BLENDING)
+      static float blend_tolerance_mm;              // (mm) G64 P - Furthest a blended path may be from the moves, 0 for exact path
+    #endif
+
     static float e_factor[EXTRUDERS];               // The flow percentage and volumetric multiplier combine to scale E movement
 
     #if DISABLED(NO_VOLUMETRICS)
@@ -190,6 +217,10 @@ class Planner {
                    volumetric_area_nominal,           // Nominal cross-sectional area
                    volumetric_multiplier[EXTRUDERS];  // Reciprocal of cross-sectional area of filament (in mm^2). Pre-calculated to reduce computation in the planner
                                                       // May be auto-adjusted by a filament width sensor
+      #if ENABLED(VOLUMETRIC_EXTRUDER_LIMIT)
+        static float volumetric_extruder_limit[EXTRUDERS],          // (mm³/s) M200 T L - Maximum volumetric flow, 0 for no limit
+                     volumetric_extruder_feedrate_limit[EXTRUDERS]; // (mm/s) The same limit as a filament feedrate. Pre-calculated from the filament size.
+      #endif
     #endif
 
     static uint32_t max_acceleration_mm_per_s2[NUM_AXIS_N],    // (mm/s^2) M201 XYZE
@@ -288,6 +319,13 @@ class Planner {
      */
     static float previous_nominal_speed_sqr;
 
+    #if ENABLED(PATH_BLENDING)
+      /**
+       * XY move, XY length and E per XY mm of the previous path line segment
+       */
+      static float previous_xy[2], previous_xy_mm, previous_e_per_mm;
+    #endif
+
     /**
      * Limit where 64bit math is necessary for acceleration calculation
      */
@@ -317,6 +355,10 @@ class Planner {
       volatile static uint32_t block_buffer_runtime_us; //Theoretical block buffer runtime in µs
     #endif
 
+    #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+      static int16_t applied_feedrate_percentage;   // Feedrate percentage the queued blocks are scaled to
+    #endif
+
   public:
 
     /**
@@ -385,7 +427,12 @@ class Planner {
         return 1;
       }
 
-      FORCE_INLINE static void force_fade_recalc() { last_fade_z = -999.999f; }
+      FORCE_INLINE static void force_fade_recalc() {
+        last_fade_z = -999.999f;
+        #if ENABLED(MESH_FADE_PER_LAYER)
+          mbl.reset_layer();
+        #endif
+      }
 
       FORCE_INLINE static void set_z_fade_height(const float &zfh) {
         z_fade_height = zfh > 0 ? zfh : 0;
@@ -678,6 +725,19 @@ class Planner {
       FORCE_INLINE static float get_axis_position_degrees(const AxisEnum axis) { return get_axis_position_mm(axis); }
     #endif
 
+    #if ENABLED(LIVE_FEEDRATE_OVERRIDE)
+
+      // Rescale the queued blocks to a new feedrate percentage. False if the Stepper ISR got in the way.
+      static bool apply_feedrate_override(const int16_t percentage);
+
+      // Apply a changed feedrate percentage to the queued blocks
+      FORCE_INLINE static void update_feedrate_override(const int16_t percentage) {
+        if (percentage != applied_feedrate_percentage && apply_feedrate_override(percentage))
+          applied_feedrate_percentage = percentage;
+      }
+
+    #endif
+
     // Called to force a quick stop of the machine (for example, when an emergency
     // stop is required, or when endstops are hit)
     static void quick_stop();
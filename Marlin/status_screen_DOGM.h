@@ -196,6 +196,10 @@ inline void lcd_implementation_status_message(const bool blink) {
   #endif
 }
 
+#if ENABLED(LCD_DIRTY_REGIONS)
+  static uint8_t first_drawn_page; // Pages above the changed fields are skipped
+#endif
+
 static void lcd_implementation_status_screen() {
 
   const bool blink = lcd_blink();
@@ -381,7 +385,12 @@ static void lcd_implementation_status_screen() {
   #endif
 
   // At the first page, regenerate the XYZ strings
-  if (page.page == 0) {
+  #if ENABLED(LCD_DIRTY_REGIONS)
+    #define STATUS_FIRST_PAGE first_drawn_page
+  #else
+    #define STATUS_FIRST_PAGE 0
+  #endif
+  if (page.page == STATUS_FIRST_PAGE) {
     strcpy(xstring, ftostr4sign(LOGICAL_X_POSITION(current_position[X_AXIS])));
     strcpy(ystring, ftostr4sign(LOGICAL_Y_POSITION(current_position[Y_AXIS])));
     strcpy(zstring, ftostr52sp(LOGICAL_Z_POSITION(current_position[Z_AXIS])));
@@ -490,4 +499,41 @@ static void lcd_implementation_status_screen() {
   }
 }
 
+#if ENABLED(LCD_DIRTY_REGIONS)
+
+  /**
+   * Limit the picture loop to the pages holding changed Status Screen fields.
+   * On the first page skip ahead to the topmost changed field. After that
+   * return false once the pages are below the lowest changed field.
+   */
+  static bool lcd_implementation_status_pages(const bool first) {
+    static uint8_t ymax;
+    if (first) {
+      uint8_t ymin = LCD_PIXEL_HEIGHT;
+      ymax = 0;
+      #define _DIRTY_RANGE(F, Y1, Y2) do{ if (LCD_STATUS_DIRTY(F)) { NOMORE(ymin, (Y1)); NOLESS(ymax, (Y2)); } }while(0)
+      _DIRTY_RANGE(TEMPS, 0, 28);
+      _DIRTY_RANGE(POSITION, XYZ_FRAME_TOP, XYZ_FRAME_TOP + XYZ_FRAME_HEIGHT - 1);
+      _DIRTY_RANGE(PROGRESS, 41 - (TALL_FONT_CORRECTION), 52);
+      _DIRTY_RANGE(MESSAGE, STATUS_BASELINE - (INFO_FONT_HEIGHT - 1), STATUS_BASELINE);
+      #undef _DIRTY_RANGE
+      if (ymin > ymax) return false;
+
+      // Advance the page the same way u8g_page_Next does. The device sends
+      // each page to the rows given by the page, so skipped rows keep their pixels.
+      while (page.page_y1 < ymin) {
+        page.page++;
+        page.page_y0 = page.page_y1 + 1;
+        page.page_y1 = MIN(page.page_y0 + page.page_height - 1, page.total_height - 1);
+      }
+      u8g.getU8g()->current_page.y0 = page.page_y0;
+      u8g.getU8g()->current_page.y1 = page.page_y1;
+      first_drawn_page = page.page;
+      return true;
+    }
+    return page.page_y0 <= ymax;
+  }
+
+#endif // LCD_DIRTY_REGIONS
+
 #endif // _STATUS_SCREEN_DOGM_H_
@@ -130,6 +130,11 @@ bool Stepper::abort_current_block;
 uint32_t Stepper::acceleration_time, Stepper::deceleration_time;
 uint8_t Stepper::steps_per_isr;
 
+#if ENABLED(FRACTIONAL_MULTISTEPPING)
+  uint16_t Stepper::step_group = 8;
+  uint8_t Stepper::step_group_frac = 0;
+#endif
+
 #if DISABLED(ADAPTIVE_STEP_SMOOTHING)
   constexpr
 #endif
@@ -165,19 +170,61 @@ uint32_t Stepper::nextMainISR = 0;
 
 #if ENABLED(LIN_ADVANCE)
 
-  constexpr uint32_t LA_ADV_NEVER = 0xFFFFFFFF;
-  uint32_t Stepper::nextAdvanceISR = LA_ADV_NEVER,
-           Stepper::LA_isr_rate = LA_ADV_NEVER;
+  #if ENABLED(LA_SINGLE_ISR)
+    int16_t  Stepper::LA_steps = 0;
+    uint32_t Stepper::LA_scale,
+             Stepper::LA_flush_interval = (STEPPER_TIMER_RATE / 1000);
+    int8_t   Stepper::LA_e_dir = 0;
+
+    #if MINIMUM_STEPPER_DIR_DELAY > 0
+      #define LA_DIR_DELAY() DELAY_NS(MINIMUM_STEPPER_DIR_DELAY)
+    #else
+      #define LA_DIR_DELAY() NOOP
+    #endif
+
+    // Point the E stepper toward the steps still due
+    #define LA_SET_E_DIR() do{ \
+      const int8_t dir = LA_steps < 0 ? -1 : 1; \
+      if (dir != LA_e_dir) { \
+        LA_e_dir = dir; \
+        if (dir < 0) REV_E_DIR(active_extruder); else NORM_E_DIR(active_extruder); \
+        LA_DIR_DELAY(); \
+      } \
+    }while(0)
+  #else
+    constexpr uint32_t LA_ADV_NEVER = 0xFFFFFFFF;
+    uint32_t Stepper::nextAdvanceISR = LA_ADV_NEVER,
+             Stepper::LA_isr_rate = LA_ADV_NEVER;
+
+    int8_t   Stepper::LA_steps = 0;
+  #endif
+
   uint16_t Stepper::LA_current_adv_steps = 0,
            Stepper::LA_final_adv_steps,
            Stepper::LA_max_adv_steps;
 
-  int8_t   Stepper::LA_steps = 0;
-
   bool Stepper::LA_use_advance_lead;
 
 #endif // LIN_ADVANCE
 
+#if ENABLED(INPUT_SHAPING)
+
+  constexpr uint32_t SHAPING_NEVER = 0xFFFFFFFF;
+
+  // Shortest time between two shaped steps of one axis
+  #define SHAPING_MIN_INTERVAL ((STEPPER_TIMER_RATE) / 40000UL)
+
+  Stepper::shaping_axis_t Stepper::shaper[2];
+  uint8_t Stepper::shaping_axes = 0;
+  uint32_t Stepper::nextShapingISR = SHAPING_NEVER,
+           Stepper::shaping_ticks = 0;
+  uint16_t Stepper::shaping_overflows = 0;
+
+  // The current slot of the shaping clock
+  #define SHAPING_SLOT() uint8_t(shaping_ticks / (SHAPING_SLOT_TICKS))
+
+#endif // INPUT_SHAPING
+
 int32_t Stepper::ticks_nominal = -1;
 
 #if DISABLED(S_CURVE_ACCELERATION)
@@ -374,11 +421,24 @@ void Stepper::set_directions() {
       count_direction[_AXIS(A)] = 1; \
     }
 
+  #if ENABLED(INPUT_SHAPING)
+    // The shaper sets the direction of shaped axes as it steps them
+    #define SET_SHAPED_DIR(A) \
+      if (TEST(shaping_axes, _AXIS(A))) \
+        count_direction[_AXIS(A)] = motor_direction(_AXIS(A)) ? -1 : 1; \
+      else { \
+        SET_STEP_DIR(A); \
+        shaper[_AXIS(A)].dir = motor_direction(_AXIS(A)); \
+      }
+  #else
+    #define SET_SHAPED_DIR(A) SET_STEP_DIR(A)
+  #endif
+
   #if HAS_X_DIR
-    SET_STEP_DIR(X); // A
+    SET_SHAPED_DIR(X); // A
   #endif
   #if HAS_Y_DIR
-    SET_STEP_DIR(Y); // B
+    SET_SHAPED_DIR(Y); // B
   #endif
   #if HAS_Z_DIR
     SET_STEP_DIR(Z); // C
@@ -1179,35 +1239,50 @@ void Stepper::isr() {
     // Run main stepping pulse phase ISR if we have to
     if (!nextMainISR) Stepper::stepper_pulse_phase_isr();
 
-    #if ENABLED(LIN_ADVANCE)
+    #if ENABLED(LIN_ADVANCE) && DISABLED(LA_SINGLE_ISR)
       // Run linear advance stepper ISR if we have to
       if (!nextAdvanceISR) nextAdvanceISR = Stepper::advance_isr();
     #endif
 
+    #if ENABLED(INPUT_SHAPING)
+      // Run the input shaper stepper ISR if we have to
+      if (!nextShapingISR) nextShapingISR = Stepper::shaping_isr();
+    #endif
+
     // ^== Time critical. NOTHING besides pulse generation should be above here!!!
 
     // Run main stepping block processing ISR if we have to
     if (!nextMainISR) nextMainISR = Stepper::stepper_block_phase_isr();
 
     uint32_t interval =
-      #if ENABLED(LIN_ADVANCE)
+      #if ENABLED(LIN_ADVANCE) && DISABLED(LA_SINGLE_ISR)
         MIN(nextAdvanceISR, nextMainISR)  // Nearest time interval
       #else
         nextMainISR                       // Remaining stepper ISR time
       #endif
     ;
 
+    #if ENABLED(INPUT_SHAPING)
+      NOMORE(interval, nextShapingISR);
+    #endif
+
     // Limit the value to the maximum possible value of the timer
     NOMORE(interval, HAL_TIMER_TYPE_MAX);
 
     // Compute the time remaining for the main isr
     nextMainISR -= interval;
 
-    #if ENABLED(LIN_ADVANCE)
+    #if ENABLED(LIN_ADVANCE) && DISABLED(LA_SINGLE_ISR)
       // Compute the time remaining for the advance isr
       if (nextAdvanceISR != LA_ADV_NEVER) nextAdvanceISR -= interval;
     #endif
 
+    #if ENABLED(INPUT_SHAPING)
+      // Advance the shaping clock and the time remaining for the shaping isr
+      shaping_ticks += interval;
+      if (nextShapingISR != SHAPING_NEVER) nextShapingISR -= interval;
+    #endif
+
     /**
      * This needs to avoid a race-condition caused by interleaving
      * of interrupts required by both the LA and Stepper algorithms.
@@ -1328,6 +1403,20 @@ void Stepper::stepper_pulse_phase_isr() {
       } \
     }while(0)
 
+    #if ENABLED(INPUT_SHAPING)
+      // Hand the steps of shaped axes to the shaper
+      #define SHAPED_PULSE_START(AXIS) do{ \
+        delta_error[_AXIS(AXIS)] += advance_dividend[_AXIS(AXIS)]; \
+        if (delta_error[_AXIS(AXIS)] >= 0) { \
+          if (TEST(shaping_axes, _AXIS(AXIS))) shaping_push(_AXIS(AXIS)); \
+          else _APPLY_STEP(AXIS)(!_INVERT_STEP_PIN(AXIS), 0); \
+          if (COUNT_IT) count_position[_AXIS(AXIS)] += count_direction[_AXIS(AXIS)]; \
+        } \
+      }while(0)
+    #else
+      #define SHAPED_PULSE_START(AXIS) PULSE_START(AXIS)
+    #endif
+
     // Stop an active pulse, if any, and adjust error term
     #define PULSE_STOP(AXIS) do { \
       if (delta_error[_AXIS(AXIS)] >= 0) { \
@@ -1352,10 +1441,10 @@ void Stepper::stepper_pulse_phase_isr() {
       #endif
     #else
       #if HAS_X_STEP
-        PULSE_START(X);
+        SHAPED_PULSE_START(X);
       #endif
       #if HAS_Y_STEP
-        PULSE_START(Y);
+        SHAPED_PULSE_START(Y);
       #endif
       #if HAS_Z_STEP
         PULSE_START(Z);
@@ -1373,6 +1462,15 @@ void Stepper::stepper_pulse_phase_isr() {
         // Don't step E here - But remember the number of steps to perform
         motor_direction(E_AXIS) ? --LA_steps : ++LA_steps;
       }
+
+      #if ENABLED(LA_SINGLE_ISR)
+        // Step E once toward the steps still due, advance steps included
+        const bool e_step = LA_steps != 0;
+        if (e_step) {
+          LA_SET_E_DIR();
+          E_STEP_WRITE(active_extruder, !INVERT_E_STEP_PIN);
+        }
+      #endif
     #else // !LIN_ADVANCE - use linear interpolation for E also
       #if ENABLED(MIXING_EXTRUDER)
 
@@ -1429,7 +1527,12 @@ void Stepper::stepper_pulse_phase_isr() {
       #endif
     #endif
 
-    #if DISABLED(LIN_ADVANCE)
+    #if ENABLED(LA_SINGLE_ISR)
+      if (e_step) {
+        E_STEP_WRITE(active_extruder, INVERT_E_STEP_PIN);
+        LA_steps < 0 ? ++LA_steps : --LA_steps;
+      }
+    #elif DISABLED(LIN_ADVANCE)
       #if ENABLED(MIXING_EXTRUDER)
         MIXING_STEPPERS_LOOP(j) {
           if (delta_error_m[j] >= 0) {
@@ -1475,6 +1578,10 @@ uint32_t Stepper::stepper_block_phase_isr() {
       axis_did_move = 0;
       current_block = NULL;
       planner.discard_current_block();
+      #if ENABLED(PLANNER_STARVATION_REPORT)
+        // Note when the machine comes to a stop for lack of moves
+        if (!planner.has_blocks_queued() && !planner.starved_ms) planner.starved_ms = millis() | 1;
+      #endif
     }
     else {
       // Step events not completed yet...
@@ -1499,7 +1606,9 @@ uint32_t Stepper::stepper_block_phase_isr() {
         interval = calc_timer_interval(acc_step_rate, oversampling_factor, &steps_per_isr);
         acceleration_time += interval;
 
-        #if ENABLED(LIN_ADVANCE)
+        #if ENABLED(LA_SINGLE_ISR)
+          if (LA_use_advance_lead) advance_update(acc_step_rate, true);
+        #elif ENABLED(LIN_ADVANCE)
           if (LA_use_advance_lead) {
             // Fire ISR if final adv_rate is reached
             if (LA_steps && LA_isr_rate != current_block->advance_speed) nextAdvanceISR = 0;
@@ -1544,7 +1653,9 @@ uint32_t Stepper::stepper_block_phase_isr() {
         interval = calc_timer_interval(step_rate, oversampling_factor, &steps_per_isr);
         deceleration_time += interval;
 
-        #if ENABLED(LIN_ADVANCE)
+        #if ENABLED(LA_SINGLE_ISR)
+          if (LA_use_advance_lead) advance_update(step_rate, false);
+        #elif ENABLED(LIN_ADVANCE)
           if (LA_use_advance_lead) {
             // Wake up eISR on first deceleration loop and fire ISR if final adv_rate is reached
             if (step_events_completed <= decelerate_after + steps_per_isr || (LA_steps && LA_isr_rate != current_block->advance_speed)) {
@@ -1558,7 +1669,11 @@ uint32_t Stepper::stepper_block_phase_isr() {
       // We must be in cruise phase otherwise
       else {
 
-        #if ENABLED(LIN_ADVANCE)
+        #if ENABLED(LA_SINGLE_ISR)
+          // Finish building up the advance for the cruise speed
+          if (LA_use_advance_lead && LA_current_adv_steps < LA_max_adv_steps)
+            advance_update(current_block->nominal_rate, true);
+        #elif ENABLED(LIN_ADVANCE)
           // If there are any esteps, fire the next advance_isr "now"
           if (LA_steps && LA_isr_rate != current_block->advance_speed) nextAdvanceISR = 0;
         #endif
@@ -1579,6 +1694,16 @@ uint32_t Stepper::stepper_block_phase_isr() {
   // and prepare its movement
   if (!current_block) {
 
+    #if ENABLED(INPUT_SHAPING)
+      // Moves with endstops enabled (homing) are not shaped. The steps
+      // still echoing from earlier moves must be output before one starts,
+      // so leave the next block in the buffer until they are.
+      const uint8_t shape = endstops.enabled ? 0 : (
+        (shaper[X_AXIS].impulses > 1 ? _BV(X_AXIS) : 0) | (shaper[Y_AXIS].impulses > 1 ? _BV(Y_AXIS) : 0)
+      );
+      if ((shaping_axes & ~shape) && shaping_queued()) return interval;
+    #endif
+
     // Anything in the buffer?
     if ((current_block = planner.get_current_block())) {
 
@@ -1598,6 +1723,13 @@ uint32_t Stepper::stepper_block_phase_isr() {
           return interval; // No more queued movements!
       }
 
+      #if ENABLED(INPUT_SHAPING)
+        if (shape != shaping_axes) {
+          shaping_axes = shape;
+          last_direction_bits = ~current_block->direction_bits; // Refresh all directions
+        }
+      #endif
+
       // Flag all moving axes for proper endstop handling
 
       #if IS_CORE
@@ -1740,17 +1872,28 @@ uint32_t Stepper::stepper_block_phase_isr() {
       #if ENABLED(LIN_ADVANCE)
         #if DISABLED(MIXING_EXTRUDER) && E_STEPPERS > 1
           // If the now active extruder wasn't in use during the last move, its pressure is most likely gone.
-          if (active_extruder != last_moved_extruder) LA_current_adv_steps = 0;
+          if (active_extruder != last_moved_extruder) {
+            LA_current_adv_steps = 0;
+            #if ENABLED(LA_SINGLE_ISR)
+              LA_e_dir = 0; // Set the direction of this extruder on its first step
+            #endif
+          }
         #endif
 
         if ((LA_use_advance_lead = current_block->use_advance_lead)) {
           LA_final_adv_steps = current_block->final_adv_steps;
           LA_max_adv_steps = current_block->max_adv_steps;
-          //Start the ISR
-          nextAdvanceISR = 0;
-          LA_isr_rate = current_block->advance_speed;
+          #if ENABLED(LA_SINGLE_ISR)
+            LA_scale = current_block->advance_scale;
+          #else
+            //Start the ISR
+            nextAdvanceISR = 0;
+            LA_isr_rate = current_block->advance_speed;
+          #endif
         }
-        else LA_isr_rate = LA_ADV_NEVER;
+        #if DISABLED(LA_SINGLE_ISR)
+          else LA_isr_rate = LA_ADV_NEVER;
+        #endif
       #endif
 
       if (current_block->direction_bits != last_direction_bits
@@ -1772,6 +1915,9 @@ uint32_t Stepper::stepper_block_phase_isr() {
       // done against the endstop. So, check the limits here: If the movement
       // is against the limits, the block will be marked as to be killed, and
       // on the next call to this ISR, will be discarded.
+      #if ENABLED(ENDSTOP_SCAN_MASK)
+        endstops.refresh_scan_mask();
+      #endif
       endstops.update();
 
       #if ENABLED(Z_LATE_ENABLE)
@@ -1801,11 +1947,91 @@ uint32_t Stepper::stepper_block_phase_isr() {
     }
   }
 
+  #if ENABLED(LA_SINGLE_ISR)
+    // Spread the E steps the pulse phase can't take over the next ISRs, one more
+    // group each. If the moves ran out, keep going at the last rate until they're out.
+    if (current_block)
+      LA_flush_interval = interval;
+    else if (LA_steps)
+      interval = LA_flush_interval;
+    if (LA_steps) advance_flush(current_block ? steps_per_isr : 0, steps_per_isr);
+  #endif
+
+  #if ENABLED(FRACTIONAL_MULTISTEPPING)
+    // Alternate whole group sizes so the steps per ISR average out to the fractional group
+    if (current_block) {
+      step_group_frac += step_group & 7;
+      steps_per_isr = (step_group >> 3) + (step_group_frac >> 3);
+      step_group_frac &= 7;
+    }
+  #endif
+
   // Return the interval to wait
   return interval;
 }
 
-#if ENABLED(LIN_ADVANCE)
+#if ENABLED(LA_SINGLE_ISR)
+
+  /**
+   * Follow the block's advance profile: the advance steps due are the step rate
+   * times the block's advance scale. Advance only builds up while accelerating,
+   * up to the cruise amount, and only drains while decelerating, down to the exit
+   * amount. The change joins the E steps output by the pulse phase.
+   */
+  void Stepper::advance_update(const uint32_t step_rate, const bool accelerating) {
+    uint16_t target = STEP_MULTIPLY(step_rate, LA_scale);
+    if (accelerating) {
+      NOMORE(target, LA_max_adv_steps);
+      if (target > LA_current_adv_steps) {
+        LA_steps += target - LA_current_adv_steps;
+        LA_current_adv_steps = target;
+      }
+    }
+    else {
+      NOLESS(target, LA_final_adv_steps);
+      if (target < LA_current_adv_steps) {
+        LA_steps -= LA_current_adv_steps - target;
+        LA_current_adv_steps = target;
+      }
+    }
+  }
+
+  void Stepper::advance_flush(const uint8_t keep, uint8_t count) {
+    if (ABS(LA_steps) <= keep) return;
+
+    LA_SET_E_DIR();
+
+    // Get the timer count and estimate the end of the pulse
+    hal_timer_t pulse_end = HAL_timer_get_count(PULSE_TIMER_NUM) + hal_timer_t(MIN_PULSE_TICKS);
+
+    const hal_timer_t added_step_ticks = hal_timer_t(ADDED_STEP_TICKS);
+
+    while (ABS(LA_steps) > keep && count--) {
+      E_STEP_WRITE(active_extruder, !INVERT_E_STEP_PIN);
+
+      // Enforce a minimum duration for STEP pulse ON
+      #if MINIMUM_STEPPER_PULSE
+        while (HAL_timer_get_count(PULSE_TIMER_NUM) < pulse_end) { /* nada */ }
+      #endif
+
+      // Add the delay needed to ensure the maximum driver rate is enforced
+      if (signed(added_step_ticks) > 0) pulse_end += hal_timer_t(added_step_ticks);
+
+      LA_steps < 0 ? ++LA_steps : --LA_steps;
+
+      E_STEP_WRITE(active_extruder, INVERT_E_STEP_PIN);
+
+      // For minimum pulse time wait before looping
+      if (ABS(LA_steps) > keep && count) {
+        while (HAL_timer_get_count(PULSE_TIMER_NUM) < pulse_end) { /* nada */ }
+        #if MINIMUM_STEPPER_PULSE
+          pulse_end += hal_timer_t(MIN_PULSE_TICKS);
+        #endif
+      }
+    }
+  }
+
+#elif ENABLED(LIN_ADVANCE)
 
   // Timer interrupt for E. LA_steps is set in the main routine
   uint32_t Stepper::advance_isr() {
@@ -1899,6 +2125,146 @@ uint32_t Stepper::stepper_block_phase_isr() {
   }
 #endif // LIN_ADVANCE
 
+#if ENABLED(INPUT_SHAPING)
+
+  /**
+   * Record a commanded step of a shaped axis. The first impulse goes out
+   * right away and the step is kept in the history for the later ones.
+   * A step that finds the history full is output whole, unshaped.
+   */
+  void Stepper::shaping_push(const AxisEnum axis) {
+    shaping_axis_t &a = shaper[axis];
+    const int8_t dir = count_direction[axis];
+    const uint8_t now = SHAPING_SLOT(),
+                  last = (a.head - 1) & (SHAPING_BUFFER_SIZE - 1),
+                  next = (a.head + 1) & (SHAPING_BUFFER_SIZE - 1);
+
+    int16_t weight = a.weight[0];
+
+    // Add to the newest entry while it's still in the current slot
+    if (a.tail[0] != a.head && a.history[last].slot == now && WITHIN(a.history[last].steps + dir, -127, 127))
+      a.history[last].steps += dir;
+    else if (next != a.tail[a.impulses - 2]) {
+      a.history[a.head].slot = now;
+      a.history[a.head].steps = dir;
+      a.head = next;
+    }
+    else {
+      weight = 256;
+      shaping_overflows++;
+    }
+
+    shaping_add(a, dir * weight);
+
+    // Output a due step right away and make sure the history gets played out
+    if (a.pending || nextShapingISR == SHAPING_NEVER) nextShapingISR = 0;
+  }
+
+  // Shaped steps that have yet to be output
+  bool Stepper::shaping_queued() {
+    for (uint8_t i = X_AXIS; i <= Y_AXIS; i++) {
+      const shaping_axis_t &a = shaper[i];
+      if (a.pending || (a.impulses > 1 && a.tail[a.impulses - 2] != a.head)) return true;
+    }
+    return false;
+  }
+
+  bool Stepper::shaping_busy() {
+    const bool was_enabled = STEPPER_ISR_ENABLED();
+    if (was_enabled) DISABLE_STEPPER_DRIVER_INTERRUPT();
+    const bool busy = shaping_queued();
+    if (was_enabled) ENABLE_STEPPER_DRIVER_INTERRUPT();
+    return busy;
+  }
+
+  void Stepper::set_shaping(const AxisEnum axis, const uint8_t impulses, const uint16_t weight[], const uint8_t delay[]) {
+    const bool was_enabled = STEPPER_ISR_ENABLED();
+    if (was_enabled) DISABLE_STEPPER_DRIVER_INTERRUPT();
+
+    shaping_axis_t &a = shaper[axis];
+    a.impulses = impulses;
+    for (uint8_t i = 0; i < impulses; i++) {
+      a.weight[i] = weight[i];
+      a.delay[i] = delay[i];
+    }
+    a.head = 0;
+    for (uint8_t i = 0; i < COUNT(a.tail); i++) a.tail[i] = 0;
+    a.error = a.pending = 0;
+
+    if (was_enabled) ENABLE_STEPPER_DRIVER_INTERRUPT();
+  }
+
+  /**
+   * Timer interrupt for shaped X and Y steps. Adds the delayed impulses
+   * that have come due to the shaped position, then outputs one pending
+   * step per axis. Pending steps are spread over the rest of the slot.
+   */
+  uint32_t Stepper::shaping_isr() {
+    const uint8_t now = SHAPING_SLOT();
+
+    for (uint8_t i = X_AXIS; i <= Y_AXIS; i++) {
+      shaping_axis_t &a = shaper[i];
+      for (uint8_t e = 1; e < a.impulses; e++) {
+        uint8_t &t = a.tail[e - 1];
+        while (t != a.head && uint8_t(now - a.history[t].slot) >= a.delay[e]) {
+          shaping_add(a, int16_t(a.weight[e]) * a.history[t].steps);
+          t = (t + 1) & (SHAPING_BUFFER_SIZE - 1);
+        }
+      }
+    }
+
+    // Set the direction of the axes about to step
+    bool dir_changed = false;
+    #define SHAPED_DIR(A) do{ \
+      shaping_axis_t &a = shaper[_AXIS(A)]; \
+      if (a.pending && (a.pending < 0) != a.dir) { \
+        a.dir = !a.dir; \
+        A##_APPLY_DIR(a.dir ? INVERT_## A##_DIR : !INVERT_## A##_DIR, false); \
+        dir_changed = true; \
+      } \
+    }while(0)
+    SHAPED_DIR(X);
+    SHAPED_DIR(Y);
+
+    // A small delay may be needed after changing direction
+    #if MINIMUM_STEPPER_DIR_DELAY > 0
+      if (dir_changed) DELAY_NS(MINIMUM_STEPPER_DIR_DELAY);
+    #else
+      UNUSED(dir_changed);
+    #endif
+
+    // Step each axis once
+    #if MINIMUM_STEPPER_PULSE
+      const hal_timer_t pulse_end = HAL_timer_get_count(PULSE_TIMER_NUM) + hal_timer_t(MIN_PULSE_TICKS);
+    #endif
+
+    if (shaper[X_AXIS].pending) X_APPLY_STEP(!INVERT_X_STEP_PIN, 0);
+    if (shaper[Y_AXIS].pending) Y_APPLY_STEP(!INVERT_Y_STEP_PIN, 0);
+
+    #if MINIMUM_STEPPER_PULSE
+      // Just wait for the requested pulse duration
+      while (HAL_timer_get_count(PULSE_TIMER_NUM) < pulse_end) { /* nada */ }
+    #endif
+
+    #define SHAPED_PULSE_STOP(A) do{ \
+      int16_t &p = shaper[_AXIS(A)].pending; \
+      if (p) { \
+        A##_APPLY_STEP(INVERT_## A##_STEP_PIN, 0); \
+        p < 0 ? ++p : --p; \
+      } \
+    }while(0)
+    SHAPED_PULSE_STOP(X);
+    SHAPED_PULSE_STOP(Y);
+
+    // Come back for the next pending step, or at the next slot while steps are due
+    const uint16_t slot_left = SHAPING_SLOT_TICKS - (shaping_ticks & (SHAPING_SLOT_TICKS - 1)),
+                   most = MAX(ABS(shaper[X_AXIS].pending), ABS(shaper[Y_AXIS].pending));
+    if (most) return MAX(slot_left / most, uint16_t(SHAPING_MIN_INTERVAL));
+    return shaping_queued() ? slot_left : SHAPING_NEVER;
+  }
+
+#endif // INPUT_SHAPING
+
 // Check if the given block is busy or not - Must not be called from ISR contexts
 // The current_block could change in the middle of the read by an Stepper ISR, so
 // we must explicitly prevent that!
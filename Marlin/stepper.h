@@ -48,6 +48,10 @@
 // Disable multiple steps per ISR
 //#define DISABLE_MULTI_STEPPING
 
+#if ENABLED(DISABLE_MULTI_STEPPING) && ENABLED(FRACTIONAL_MULTISTEPPING)
+  #error "FRACTIONAL_MULTISTEPPING is not compatible with DISABLE_MULTI_STEPPING."
+#endif
+
 //
 // Estimate the amount of time the Stepper ISR will take to execute
 //
@@ -153,7 +157,7 @@
 #define ISR_LOOP_CYCLES (ISR_LOOP_BASE_CYCLES + MAX(MIN_STEPPER_PULSE_CYCLES, MIN_ISR_LOOP_CYCLES))
 
 // If linear advance is enabled, then it is handled separately
-#if ENABLED(LIN_ADVANCE)
+#if ENABLED(LIN_ADVANCE) && DISABLED(LA_SINGLE_ISR)
 
   // Estimate the minimum LA loop time
   #if ENABLED(MIXING_EXTRUDER)
@@ -185,6 +189,18 @@
 // The minimum allowable frequency for step smoothing will be 1/10 of the maximum nominal frequency (in Hz)
 #define MIN_STEP_ISR_FREQUENCY MAX_STEP_ISR_FREQUENCY_1X
 
+#if ENABLED(FRACTIONAL_MULTISTEPPING)
+  // ISR time spent outside the stepping loop
+  #define ISR_FIXED_CYCLES (ISR_BASE_CYCLES + ISR_S_CURVE_CYCLES + ISR_LA_BASE_CYCLES + ISR_LA_LOOP_CYCLES)
+
+  // Entry I of the fractional multistepping ladder is a group of (8 + I % 8) << (I / 8) eighth-steps.
+  // The maximum allowable stepping frequency (in Hz) when stepping a group per ISR:
+  #define FMS_GROUP(I) ((8UL + (I) % 8) << ((I) / 8))
+  #define FMS_LIMIT(I) uint32_t(uint64_t(F_CPU) * FMS_GROUP(I) / (uint64_t(ISR_FIXED_CYCLES) * 8 + uint64_t(ISR_LOOP_CYCLES) * FMS_GROUP(I)))
+  #define FMS_OCTAVE(E) FMS_LIMIT((E) * 8), FMS_LIMIT((E) * 8 + 1), FMS_LIMIT((E) * 8 + 2), FMS_LIMIT((E) * 8 + 3), \
+                        FMS_LIMIT((E) * 8 + 4), FMS_LIMIT((E) * 8 + 5), FMS_LIMIT((E) * 8 + 6), FMS_LIMIT((E) * 8 + 7)
+#endif
+
 //
 // Stepper class definition
 //
@@ -195,6 +211,10 @@
 #include "language.h"
 #include "types.h"
 
+#if ENABLED(INPUT_SHAPING)
+  #include "input_shaping.h"
+#endif
+
 // intRes = intIn1 * intIn2 >> 16
 // uses:
 // r26 to store 0
@@ -263,6 +283,11 @@ class Stepper {
     static uint32_t acceleration_time, deceleration_time; // time measured in Stepper Timer ticks
     static uint8_t steps_per_isr;         // Count of steps to perform per Stepper ISR call
 
+    #if ENABLED(FRACTIONAL_MULTISTEPPING)
+      static uint16_t step_group;         // Average steps per Stepper ISR call, in 1/8 step
+      static uint8_t step_group_frac;     // Fraction of a step carried to the next ISR call, in 1/8 step
+    #endif
+
     #if ENABLED(ADAPTIVE_STEP_SMOOTHING)
       static uint8_t oversampling_factor; // Oversampling factor (log2(multiplier)) to increase temporal resolution of axis
     #else
@@ -301,12 +326,44 @@ class Stepper {
 
     static uint32_t nextMainISR;   // time remaining for the next Step ISR
     #if ENABLED(LIN_ADVANCE)
-      static uint32_t nextAdvanceISR, LA_isr_rate;
+      #if DISABLED(LA_SINGLE_ISR)
+        static uint32_t nextAdvanceISR, LA_isr_rate;
+      #endif
       static uint16_t LA_current_adv_steps, LA_final_adv_steps, LA_max_adv_steps; // Copy from current executed block. Needed because current_block is set to NULL "too early".
-      static int8_t LA_steps;
       static bool LA_use_advance_lead;
+      #if ENABLED(LA_SINGLE_ISR)
+        static int16_t LA_steps;            // E steps still to output, the advance steps included
+        static uint32_t LA_scale,           // Advance steps per step event/s, from the block. Fixed point 8.24.
+                        LA_flush_interval;  // Interval of the last block, for the steps left when it ends
+        static int8_t LA_e_dir;             // Direction the E stepper is set to (0 = unknown)
+      #else
+        static int8_t LA_steps;
+      #endif
     #endif // LIN_ADVANCE
 
+    #if ENABLED(INPUT_SHAPING)
+      typedef struct {
+        uint8_t slot;                             // Shaping clock slot of the steps
+        int8_t steps;                             // Net steps commanded in the slot
+      } shaping_entry_t;
+
+      typedef struct {
+        uint8_t impulses,                         // Impulse count. Under 2 means not shaped.
+                delay[SHAPING_MAX_IMPULSES],      // Impulse delays, in slots
+                head,                             // Next free history entry
+                tail[SHAPING_MAX_IMPULSES - 1];   // Next history entry for each delayed impulse
+        uint16_t weight[SHAPING_MAX_IMPULSES];    // Impulse weights, in 1/256 step
+        int16_t error;                            // Shaped position not yet stepped, in 1/256 step
+        int16_t pending;                          // Whole steps waiting to be output
+        bool dir;                                 // Direction the motor is set to (true = reverse)
+        shaping_entry_t history[SHAPING_BUFFER_SIZE];
+      } shaping_axis_t;
+
+      static shaping_axis_t shaper[2];            // X and Y
+      static uint8_t shaping_axes;                // Axes shaped in the current block
+      static uint32_t nextShapingISR, shaping_ticks;
+    #endif
+
     static int32_t ticks_nominal;
     #if DISABLED(S_CURVE_ACCELERATION)
       static uint32_t acc_step_rate; // needed for deceleration start point
@@ -346,8 +403,29 @@ class Stepper {
     static uint32_t stepper_block_phase_isr();
 
     #if ENABLED(LIN_ADVANCE)
-      // The Linear advance stepper ISR
-      static uint32_t advance_isr();
+      #if ENABLED(LA_SINGLE_ISR)
+        // Bring the pressure advance to the amount due at a step rate
+        static void advance_update(const uint32_t step_rate, const bool accelerating);
+        // Output up to count of the E steps the next pulse phase won't get to
+        static void advance_flush(const uint8_t keep, uint8_t count);
+      #else
+        // The Linear advance stepper ISR
+        static uint32_t advance_isr();
+      #endif
+    #endif
+
+    #if ENABLED(INPUT_SHAPING)
+      // The shaped X/Y stepper ISR
+      static uint32_t shaping_isr();
+
+      static uint16_t shaping_overflows;          // Steps output unshaped for lack of history
+
+      // Set the impulses of an axis. Fewer than 2 impulses turn shaping off.
+      // Call with all moves finished.
+      static void set_shaping(const AxisEnum axis, const uint8_t impulses, const uint16_t weight[], const uint8_t delay[]);
+
+      // True while shaped steps are still to be output - Must not be called from ISR contexts
+      static bool shaping_busy();
     #endif
 
     // Check if the given block is busy or not - Must not be called from ISR contexts
@@ -467,6 +545,18 @@ class Stepper {
     // Set direction bits for all steppers
     static void set_directions();
 
+    #if ENABLED(INPUT_SHAPING)
+      static bool shaping_queued();
+      static void shaping_push(const AxisEnum axis);
+
+      // Add a weighted step to the shaped position. Whole steps become pending steps.
+      FORCE_INLINE static void shaping_add(shaping_axis_t &a, const int16_t v) {
+        const int16_t e = a.error + v, n = (e + 128) >> 8;
+        a.pending += n;
+        a.error = e - n * 256;
+      }
+    #endif
+
     // Allow reset_stepper_drivers to access private set_directions
     friend void reset_stepper_drivers();
 
@@ -477,7 +567,35 @@ class Stepper {
       step_rate <<= scale;
 
       uint8_t multistep = 1;
-      #if DISABLED(DISABLE_MULTI_STEPPING)
+      #if ENABLED(FRACTIONAL_MULTISTEPPING)
+
+        // The stepping frequency limits for each group size
+        static const uint32_t limit[] PROGMEM = {
+          FMS_OCTAVE(0), FMS_OCTAVE(1), FMS_OCTAVE(2), FMS_OCTAVE(3),
+          FMS_OCTAVE(4), FMS_OCTAVE(5), FMS_OCTAVE(6), FMS_LIMIT(56)
+        };
+
+        // Group sizes the ladder may use within each doubling
+        constexpr uint8_t m_step = 8 >> (MULTISTEP_FRACTION_BITS);
+
+        // Select the doubling, then the smallest group in it that keeps up
+        uint8_t e = 0, m = 0;
+        while (e < 7 && step_rate > (uint32_t)pgm_read_dword(&limit[e * 8 + 8 - m_step])) ++e;
+        if (e < 7)
+          while (m < 8 - m_step && step_rate > (uint32_t)pgm_read_dword(&limit[e * 8 + m])) m += m_step;
+
+        step_group = (8 + m) << e;
+        multistep = step_group >> 3;
+
+        // The ISR rate is the step rate divided by the group size
+        step_rate >>= e;
+        if (m) {
+          // 32768 * 8 / (8 + m)
+          static const uint16_t inv_group[] PROGMEM = { 32768, 29127, 26214, 23831, 21845, 20165, 18725, 17476 };
+          step_rate = (step_rate * pgm_read_word(&inv_group[m])) >> 15;
+        }
+
+      #elif DISABLED(DISABLE_MULTI_STEPPING)
 
         // The stepping frequency limits for each multistepping rate
         static const uint32_t limit[] PROGMEM = {
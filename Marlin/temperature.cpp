@@ -51,6 +51,10 @@
   #include "emergency_parser.h"
 #endif
 
+#if ENABLED(I2C_POSITION_ENCODERS) && ENABLED(TWI_TRANSACTION_QUEUE)
+  #include "I2CPositionEncoder.h"
+#endif
+
 #if HOTEND_USES_THERMISTOR
   #if ENABLED(TEMP_SENSOR_1_AS_REDUNDANT)
     static void* heater_ttbl_map[2] = { (void*)HEATER_0_TEMPTABLE, (void*)HEATER_1_TEMPTABLE };
@@ -2294,6 +2298,10 @@ void Temperature::isr() {
     }
   #endif // BABYSTEPPING
 
+  #if ENABLED(I2C_POSITION_ENCODERS) && ENABLED(TWI_TRANSACTION_QUEUE)
+    I2CPositionEncodersMgr::tick();
+  #endif
+
   // Poll endstops state, if required
   endstops.poll();
 
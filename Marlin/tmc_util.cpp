@@ -30,10 +30,14 @@
 #include "duration_t.h"
 #include "stepper_indirection.h"
 
-#if ENABLED(TMC_DEBUG)
+#if ENABLED(TMC_DEBUG) || ENABLED(STALLGUARD_LOAD_LOG)
   #include "planner.h"
 #endif
 
+#if ENABLED(STALLGUARD_LOAD_LOG)
+  #include "stepper.h"
+#endif
+
 bool report_tmc_status = false;
 
 /**
@@ -93,7 +97,7 @@ bool report_tmc_status = false;
   #endif
 
   template<typename TMC>
-  void monitor_tmc_driver(TMC &st, const TMC_AxisEnum axis, uint8_t &otpw_cnt) {
+  TMC_driver_data monitor_tmc_driver(TMC &st, const TMC_AxisEnum axis, uint8_t &otpw_cnt) {
     TMC_driver_data data = get_driver_data(st);
 
     #if ENABLED(STOP_ON_ERROR)
@@ -155,10 +159,294 @@ bool report_tmc_status = false;
       else if (st.flag_otpw) SERIAL_CHAR('F');
       SERIAL_CHAR('\t');
     }
+
+    return data;
   }
 
   #define HAS_HW_COMMS(ST) AXIS_DRIVER_TYPE(ST, TMC2130) || (AXIS_DRIVER_TYPE(ST, TMC2208) && defined(ST##_HARDWARE_SERIAL))
 
+  #if ENABLED(TMC_ASYNC_MONITOR)
+
+    /**
+     * Poll the drivers a few at a time, one step per call, instead of all at once.
+     * A step reads every SPI driver in a row, since an SPI read takes a few µs,
+     * but at most one UART driver, since a UART read blocks until the reply.
+     * The readings are cached for M122 C.
+     */
+    enum TMC_MonitorSlot : uint8_t {
+      #if HAS_HW_COMMS(X)
+        TMC_SLOT_X,
+      #endif
+      #if HAS_HW_COMMS(Y)
+        TMC_SLOT_Y,
+      #endif
+      #if HAS_HW_COMMS(Z)
+        TMC_SLOT_Z,
+      #endif
+      #if HAS_HW_COMMS(X2)
+        TMC_SLOT_X2,
+      #endif
+      #if HAS_HW_COMMS(Y2)
+        TMC_SLOT_Y2,
+      #endif
+      #if HAS_HW_COMMS(Z2)
+        TMC_SLOT_Z2,
+      #endif
+      #if HAS_HW_COMMS(E0)
+        TMC_SLOT_E0,
+      #endif
+      #if HAS_HW_COMMS(E1)
+        TMC_SLOT_E1,
+      #endif
+      #if HAS_HW_COMMS(E2)
+        TMC_SLOT_E2,
+      #endif
+      #if HAS_HW_COMMS(E3)
+        TMC_SLOT_E3,
+      #endif
+      #if HAS_HW_COMMS(E4)
+        TMC_SLOT_E4,
+      #endif
+      TMC_SLOT_COUNT
+    };
+
+    struct TMC_cache_t {
+      millis_t read_ms;     // When the driver was last read, 0 if never
+      uint32_t drv_status;  // DRV_STATUS as read
+      uint16_t current;     // (mA) Set current at the time of the read
+      uint16_t sg_result;   // stallGuard2 load value (TMC2130 only)
+      uint8_t otpw_cnt;     // Consecutive readings with the prewarn flag set
+      TMC_AxisEnum axis;
+      bool is_otpw, is_ot, is_error, has_sg;
+    };
+
+    static TMC_cache_t tmc_cache[TMC_SLOT_COUNT];
+
+    #if HAS_DRIVER(TMC2130)
+      static bool tmc_poll_sg(TMC2130Stepper&, const uint32_t drv_status, uint16_t &sg) { sg = drv_status & 0x3FF; return true; }
+    #endif
+    #if HAS_DRIVER(TMC2208)
+      static bool tmc_poll_sg(TMC2208Stepper&, const uint32_t, uint16_t&) { return false; }
+    #endif
+
+    // Read and check one driver. Return true for an SPI driver.
+    template<typename TMC>
+    static bool tmc_poll(TMC &st, const TMC_AxisEnum axis, TMC_cache_t &c) {
+      const TMC_driver_data data = monitor_tmc_driver(st, axis, c.otpw_cnt);
+      c.read_ms = millis();
+      c.axis = axis;
+      c.drv_status = data.drv_status;
+      c.is_otpw = data.is_otpw;
+      c.is_ot = data.is_ot;
+      c.is_error = data.is_error;
+      c.current = st.getCurrent();
+      return (c.has_sg = tmc_poll_sg(st, data.drv_status, c.sg_result));
+    }
+
+    static bool tmc_poll(const uint8_t slot) {
+      switch (slot) {
+        #if HAS_HW_COMMS(X)
+          case TMC_SLOT_X: return tmc_poll(stepperX, TMC_X, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(Y)
+          case TMC_SLOT_Y: return tmc_poll(stepperY, TMC_Y, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(Z)
+          case TMC_SLOT_Z: return tmc_poll(stepperZ, TMC_Z, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(X2)
+          case TMC_SLOT_X2: return tmc_poll(stepperX2, TMC_X2, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(Y2)
+          case TMC_SLOT_Y2: return tmc_poll(stepperY2, TMC_Y2, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(Z2)
+          case TMC_SLOT_Z2: return tmc_poll(stepperZ2, TMC_Z2, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(E0)
+          case TMC_SLOT_E0: return tmc_poll(stepperE0, TMC_E0, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(E1)
+          case TMC_SLOT_E1: return tmc_poll(stepperE1, TMC_E1, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(E2)
+          case TMC_SLOT_E2: return tmc_poll(stepperE2, TMC_E2, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(E3)
+          case TMC_SLOT_E3: return tmc_poll(stepperE3, TMC_E3, tmc_cache[slot]);
+        #endif
+        #if HAS_HW_COMMS(E4)
+          case TMC_SLOT_E4: return tmc_poll(stepperE4, TMC_E4, tmc_cache[slot]);
+        #endif
+        default: return false;
+      }
+    }
+
+    #if ENABLED(STALLGUARD_LOAD_LOG)
+
+      /**
+       * Collect the stallGuard2 readings of the monitor sweeps while a print runs.
+       * Each reading of a moving axis goes into a histogram of SG_RESULT values.
+       * A stall flag on a moving axis means the motor has likely lost steps, so
+       * it's logged with the layer and the planned position at that moment.
+       * The flag isn't latched, so only stalls still going on at a sweep are seen.
+       */
+      typedef struct {
+        uint16_t layer;
+        uint8_t slot;
+        uint16_t sg_result;
+        float pos[XYZ];           // (mm) Planned position
+      } TMC_stall_t;
+
+      static uint16_t sg_hist[TMC_SLOT_COUNT][LOAD_LOG_BINS], sg_stalls[TMC_SLOT_COUNT];
+      static int32_t sg_last_pos[TMC_SLOT_COUNT];
+      static bool sg_was_stalled[TMC_SLOT_COUNT];
+      static TMC_stall_t sg_events[LOAD_LOG_EVENTS];
+      static uint8_t sg_event_head, sg_event_count;
+      static uint16_t sg_layer;
+      static int32_t sg_layer_z, sg_last_e;
+      static bool sg_printing;
+
+      void tmc_load_log_reset() {
+        ZERO(sg_hist);
+        ZERO(sg_stalls);
+        ZERO(sg_was_stalled);
+        sg_event_head = sg_event_count = 0;
+        sg_layer = 0;
+        sg_layer_z = sg_last_e = 0;
+      }
+
+      static AxisEnum tmc_slot_axis(const TMC_AxisEnum axis) {
+        switch (axis) {
+          case TMC_X: case TMC_X2: return X_AXIS;
+          case TMC_Y: case TMC_Y2: return Y_AXIS;
+          case TMC_Z: case TMC_Z2: return Z_AXIS;
+          default: return E_AXIS;
+        }
+      }
+
+      // Called at the start of each sweep. A new layer starts when
+      // extrusion resumes above the highest Z printed so far.
+      static void tmc_load_layer() {
+        const bool printing = print_job_timer.isRunning();
+        if (printing && !sg_printing) tmc_load_log_reset();
+        sg_printing = printing;
+        if (!printing) return;
+        const int32_t z = stepper.position(Z_AXIS), e = stepper.position(E_AXIS);
+        if (e > sg_last_e && z > sg_layer_z) {
+          if (sg_layer_z) sg_layer++;
+          sg_layer_z = z;
+        }
+        sg_last_e = e;
+      }
+
+      static void tmc_load_sample(const uint8_t slot) {
+        const TMC_cache_t &c = tmc_cache[slot];
+        if (!sg_printing || !c.has_sg) return;
+
+        const int32_t pos = stepper.position(tmc_slot_axis(c.axis));
+        const bool moving = pos != sg_last_pos[slot];
+        sg_last_pos[slot] = pos;
+        if (!moving) return;
+
+        uint16_t &bin = sg_hist[slot][((uint16_t)c.sg_result * (LOAD_LOG_BINS)) >> 10];
+        if (bin < 0xFFFF) bin++;
+
+        const bool stalled = TEST32(c.drv_status, 24);
+        if (stalled && !sg_was_stalled[slot]) {
+          if (sg_stalls[slot] < 0xFFFF) sg_stalls[slot]++;
+          TMC_stall_t &ev = sg_events[sg_event_head];
+          ev.layer = sg_layer;
+          ev.slot = slot;
+          ev.sg_result = c.sg_result;
+          LOOP_XYZ(i) ev.pos[i] = stepper.position((AxisEnum)i) * planner.steps_to_mm[i];
+          sg_event_head = (sg_event_head + 1) % (LOAD_LOG_EVENTS);
+          if (sg_event_count < LOAD_LOG_EVENTS) sg_event_count++;
+        }
+        sg_was_stalled[slot] = stalled;
+      }
+
+      /**
+       * M122 L: Report the load histograms and the latest stall events
+       */
+      void tmc_report_load_log() {
+        SERIAL_ECHOLNPAIR("SG load, layers:", sg_layer + 1);
+        for (uint8_t s = 0; s < TMC_SLOT_COUNT; s++) {
+          if (!tmc_cache[s].has_sg) continue;
+          _tmc_say_axis(tmc_cache[s].axis);
+          for (uint8_t b = 0; b < LOAD_LOG_BINS; b++) {
+            SERIAL_CHAR(' ');
+            SERIAL_ECHO(sg_hist[s][b]);
+          }
+          SERIAL_ECHOLNPAIR(" stalls:", sg_stalls[s]);
+        }
+        for (uint8_t i = 0; i < sg_event_count; i++) {
+          const TMC_stall_t &ev = sg_events[(sg_event_head + (LOAD_LOG_EVENTS) - sg_event_count + i) % (LOAD_LOG_EVENTS)];
+          SERIAL_ECHOPAIR("Stall L", ev.layer);
+          SERIAL_CHAR(' ');
+          _tmc_say_axis(tmc_cache[ev.slot].axis);
+          SERIAL_ECHOPAIR(" X", ev.pos[X_AXIS]);
+          SERIAL_ECHOPAIR(" Y", ev.pos[Y_AXIS]);
+          SERIAL_ECHOPAIR(" Z", ev.pos[Z_AXIS]);
+          SERIAL_ECHOLNPAIR(" SG", ev.sg_result);
+        }
+      }
+
+    #endif // STALLGUARD_LOAD_LOG
+
+    void monitor_tmc_driver() {
+      static millis_t next_cOT = 0;
+      static uint8_t slot = TMC_SLOT_COUNT; // Idle until the next sweep is due
+
+      if (slot >= TMC_SLOT_COUNT) {
+        if (!ELAPSED(millis(), next_cOT)) return;
+        next_cOT = millis() + (MONITOR_DRIVER_STATUS_INTERVAL_MS);
+        slot = 0;
+        #if ENABLED(STALLGUARD_LOAD_LOG)
+          tmc_load_layer();
+        #endif
+      }
+
+      for (;;) {
+        const uint8_t s = slot++;
+        const bool spi = tmc_poll(s);
+        #if ENABLED(STALLGUARD_LOAD_LOG)
+          tmc_load_sample(s);
+        #endif
+        if (!spi || slot >= TMC_SLOT_COUNT) break; // Only SPI reads share a step
+      }
+
+      if (slot >= TMC_SLOT_COUNT && report_tmc_status) SERIAL_EOL();
+    }
+
+    /**
+     * M122 C: Report the cached driver readings without touching the bus
+     */
+    void tmc_report_cached() {
+      SERIAL_ECHOLNPGM("Driver\tDRV_STATUS\tOTPW\tSG\tmA\tAge(ms)");
+      const millis_t ms = millis();
+      for (uint8_t i = 0; i < TMC_SLOT_COUNT; i++) {
+        const TMC_cache_t &c = tmc_cache[i];
+        if (!c.read_ms) continue;
+        _tmc_say_axis(c.axis);
+        SERIAL_ECHOPGM("\t0x");
+        for (int8_t b = 28; b >= 0; b -= 4) SERIAL_PRINT((c.drv_status >> b) & 0xF, HEX);
+        SERIAL_CHAR('\t');
+        if (c.is_error) SERIAL_CHAR('E');
+        else if (c.is_ot) SERIAL_CHAR('O');
+        else if (c.is_otpw) SERIAL_PRINT(c.otpw_cnt, DEC);
+        else SERIAL_CHAR('-');
+        SERIAL_CHAR('\t');
+        if (c.has_sg) SERIAL_ECHO(c.sg_result); else SERIAL_CHAR('-');
+        SERIAL_CHAR('\t');
+        SERIAL_ECHO(c.current);
+        SERIAL_CHAR('\t');
+        SERIAL_ECHOLN(ms - c.read_ms);
+      }
+    }
+
+  #else // !TMC_ASYNC_MONITOR
+
   void monitor_tmc_driver() {
     static millis_t next_cOT = 0;
     if (ELAPSED(millis(), next_cOT)) {
@@ -212,6 +500,8 @@ bool report_tmc_status = false;
     }
   }
 
+  #endif // !TMC_ASYNC_MONITOR
+
 #endif // MONITOR_DRIVER_STATUS
 
 void _tmc_say_axis(const TMC_AxisEnum axis) {
@@ -84,6 +84,15 @@ void tmc_set_sgt(TMC &st, const int8_t sgt_val) {
 
 void monitor_tmc_driver();
 
+#if ENABLED(TMC_ASYNC_MONITOR)
+  void tmc_report_cached();
+#endif
+
+#if ENABLED(STALLGUARD_LOAD_LOG)
+  void tmc_load_log_reset();
+  void tmc_report_load_log();
+#endif
+
 #if ENABLED(TMC_DEBUG)
   void tmc_set_report_status(const bool status);
   void tmc_report_all();
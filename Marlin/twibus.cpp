@@ -25,11 +25,33 @@
 #if ENABLED(EXPERIMENTAL_I2CBUS)
 
 #include "twibus.h"
-#include <Wire.h>
 #include "Marlin.h"
 
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+
+  // Data sent by the last send(), which may still be on the bus
+  static uint8_t tx_buffer[TWIBUS_BUFFER_SIZE];
+  static TWITransfer tx_transfer;
+
+  // Data read by the last request()
+  static uint8_t rx_buffer[TWIBUS_BUFFER_SIZE], rx_count, rx_index;
+
+  static inline bool bus_available() { return rx_index < rx_count; }
+  static inline uint8_t bus_read() { return rx_buffer[rx_index++]; }
+
+#else
+
+  #include <Wire.h>
+
+  static inline bool bus_available() { return Wire.available(); }
+  static inline uint8_t bus_read() { return Wire.read(); }
+
+#endif
+
 TWIBus::TWIBus() {
-  #if I2C_SLAVE_ADDRESS == 0
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    MarlinTWI::init();
+  #elif I2C_SLAVE_ADDRESS == 0
     Wire.begin();                  // No address joins the BUS as the master
   #else
     Wire.begin(I2C_SLAVE_ADDRESS); // Join the bus as a slave
@@ -82,9 +104,19 @@ void TWIBus::send() {
     debug(PSTR("send"), this->addr);
   #endif
 
-  Wire.beginTransmission(this->addr);
-  Wire.write(this->buffer, this->buffer_s);
-  Wire.endTransmission();
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    // Queue a copy of the buffer and return. Only wait for an earlier send.
+    MarlinTWI::wait(tx_transfer);
+    memcpy(tx_buffer, this->buffer, this->buffer_s);
+    tx_transfer.addr = this->addr;
+    tx_transfer.tx = tx_buffer;
+    tx_transfer.tx_len = this->buffer_s;
+    MarlinTWI::submit(tx_transfer);
+  #else
+    Wire.beginTransmission(this->addr);
+    Wire.write(this->buffer, this->buffer_s);
+    Wire.endTransmission();
+  #endif
 
   this->reset();
 }
@@ -101,7 +133,7 @@ void TWIBus::echoprefix(uint8_t bytes, const char prefix[], uint8_t adr) {
 // static
 void TWIBus::echodata(uint8_t bytes, const char prefix[], uint8_t adr) {
   echoprefix(bytes, prefix, adr);
-  while (bytes-- && Wire.available()) SERIAL_CHAR(Wire.read());
+  while (bytes-- && bus_available()) SERIAL_CHAR(bus_read());
   SERIAL_EOL();
 }
 
@@ -119,7 +151,14 @@ bool TWIBus::request(const uint8_t bytes) {
   #endif
 
   // requestFrom() is a blocking function
-  if (Wire.requestFrom(this->addr, bytes) == 0) {
+  #if ENABLED(TWI_TRANSACTION_QUEUE)
+    rx_index = 0;
+    rx_count = MarlinTWI::read(this->addr, rx_buffer, MIN(bytes, TWIBUS_BUFFER_SIZE));
+    const bool failed = rx_count == 0;
+  #else
+    const bool failed = Wire.requestFrom(this->addr, bytes) == 0;
+  #endif
+  if (failed) {
     #if ENABLED(DEBUG_TWIBUS)
       debug("request fail", this->addr);
     #endif
@@ -141,8 +180,8 @@ void TWIBus::relay(const uint8_t bytes) {
 uint8_t TWIBus::capture(byte *dst, const uint8_t bytes) {
   this->reset();
   uint8_t count = 0;
-  while (count < bytes && Wire.available())
-    dst[count++] = Wire.read();
+  while (count < bytes && bus_available())
+    dst[count++] = bus_read();
 
   #if ENABLED(DEBUG_TWIBUS)
     debug(PSTR("capture"), count);
@@ -153,7 +192,7 @@ uint8_t TWIBus::capture(byte *dst, const uint8_t bytes) {
 
 // static
 void TWIBus::flush() {
-  while (Wire.available()) Wire.read();
+  while (bus_available()) bus_read();
 }
 
 #if I2C_SLAVE_ADDRESS > 0
@@ -25,7 +25,11 @@
 
 #include "macros.h"
 
-#include <Wire.h>
+#if ENABLED(TWI_TRANSACTION_QUEUE)
+  #include "MarlinTWI.h"
+#else
+  #include <Wire.h>
+#endif
 
 // Print debug messages with M111 S2 (Uses 236 bytes of PROGMEM)
 //#define DEBUG_TWIBUS
@@ -118,6 +118,11 @@
 
   float unified_bed_leveling::z_values[GRID_MAX_POINTS_X][GRID_MAX_POINTS_Y];
 
+  #if ENABLED(UBL_CELL_GRADIENTS)
+    unified_bed_leveling::cell_gradient_t unified_bed_leveling::gradients[GRID_MAX_POINTS_X - 1][GRID_MAX_POINTS_Y - 1];
+    bool unified_bed_leveling::gradients_valid; // = false
+  #endif
+
   // 15 is the maximum nubmer of grid points supported + 1 safety margin for now,
   // until determinism prevails
   constexpr float unified_bed_leveling::_mesh_index_to_xpos[16],
@@ -142,6 +147,7 @@
       planner.set_z_fade_height(10.0);
     #endif
     ZERO(z_values);
+    mesh_changed();
     if (was_enabled) report_current_position();
   }
 
@@ -156,8 +162,37 @@
         z_values[x][y] = value;
       }
     }
+    mesh_changed();
   }
 
+  #if ENABLED(UBL_CELL_GRADIENTS)
+
+    /**
+     * Precompute the bilinear coefficients of every mesh cell so moves can get
+     * their Z correction with multiply-adds only. A cell with an undefined
+     * corner gets no correction, the same as get_z_correction gives it.
+     */
+    void unified_bed_leveling::update_gradients() {
+      for (uint8_t x = 0; x < GRID_MAX_POINTS_X - 1; x++) {
+        for (uint8_t y = 0; y < GRID_MAX_POINTS_Y - 1; y++) {
+          const float z00 = z_values[x][y], z10 = z_values[x + 1][y],
+                      z01 = z_values[x][y + 1], z11 = z_values[x + 1][y + 1];
+          cell_gradient_t &g = gradients[x][y];
+          if (isnan(z00) || isnan(z10) || isnan(z01) || isnan(z11))
+            g.z0 = g.dx = g.dy = g.dxy = 0;
+          else {
+            g.z0 = z00;
+            g.dx = (z10 - z00) * (1.0f / (MESH_X_DIST));
+            g.dy = (z01 - z00) * (1.0f / (MESH_Y_DIST));
+            g.dxy = (z11 - z10 - z01 + z00) * (1.0f / ((MESH_X_DIST) * (MESH_Y_DIST)));
+          }
+        }
+      }
+      gradients_valid = true;
+    }
+
+  #endif // UBL_CELL_GRADIENTS
+
   static void serial_echo_xy(const uint8_t sp, const int16_t x, const int16_t y) {
     SERIAL_ECHO_SP(sp);
     SERIAL_CHAR('(');
@@ -155,9 +155,49 @@ class unified_bed_leveling {
 
     static volatile int encoder_diff; // Volatile because it's changed at interrupt time.
 
+    #if ENABLED(UBL_CELL_GRADIENTS)
+
+      /**
+       * Bilinear coefficients of one mesh cell. With cx,cy measured from the
+       * cell's lower left corner the Z correction is z0 + dx*cx + (dy + dxy*cx)*cy.
+       */
+      typedef struct { float z0, dx, dy, dxy; } cell_gradient_t;
+
+      static cell_gradient_t gradients[GRID_MAX_POINTS_X - 1][GRID_MAX_POINTS_Y - 1];
+      static bool gradients_valid;
+
+      static void update_gradients();
+
+      // Call after any change to z_values[][] so the table is rebuilt before the next move
+      FORCE_INLINE static void mesh_changed() { gradients_valid = false; }
+
+      /**
+       * Z correction at rx,ry using the coefficients of cell cx,cy (as returned by
+       * get_cell_index_x/y). Past the last mesh line the edge height is held, the
+       * same as get_z_correction does.
+       */
+      FORCE_INLINE static float cell_z_correction(int8_t cx, int8_t cy, const float &rx, const float &ry) {
+        #ifdef UBL_Z_RAISE_WHEN_OFF_MESH
+          if (!WITHIN(rx, MESH_MIN_X, MESH_MAX_X) || !WITHIN(ry, MESH_MIN_Y, MESH_MAX_Y))
+            return UBL_Z_RAISE_WHEN_OFF_MESH;
+        #endif
+        float fx = rx - mesh_index_to_xpos(cx),
+              fy = ry - mesh_index_to_ypos(cy);
+        if (cx > (GRID_MAX_POINTS_X) - 2) { cx = (GRID_MAX_POINTS_X) - 2; fx = MESH_X_DIST; }
+        if (cy > (GRID_MAX_POINTS_Y) - 2) { cy = (GRID_MAX_POINTS_Y) - 2; fy = MESH_Y_DIST; }
+        const cell_gradient_t &g = gradients[cx][cy];
+        return g.z0 + g.dx * fx + (g.dy + g.dxy * fx) * fy;
+      }
+
+    #else
+
+      FORCE_INLINE static void mesh_changed() {}
+
+    #endif
+
     unified_bed_leveling();
 
-    FORCE_INLINE static void set_z(const int8_t px, const int8_t py, const float &z) { z_values[px][py] = z; }
+    FORCE_INLINE static void set_z(const int8_t px, const int8_t py, const float &z) { z_values[px][py] = z; mesh_changed(); }
 
     static int8_t get_cell_index_x(const float &x) {
       const int8_t cx = (x - (MESH_MIN_X)) * (1.0f / (MESH_X_DIST));
@@ -365,6 +405,6 @@ class unified_bed_leveling {
 
 extern unified_bed_leveling ubl;
 
-FORCE_INLINE void gcode_G29() { ubl.G29(); }
+FORCE_INLINE void gcode_G29() { ubl.G29(); ubl.mesh_changed(); }
 
 #endif // UNIFIED_BED_LEVELING_H
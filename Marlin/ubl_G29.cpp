@@ -661,11 +661,13 @@
     SERIAL_ECHO_F(sigma, 6);
     SERIAL_EOL();
 
-    if (cflag)
+    if (cflag) {
       for (uint8_t x = 0; x < GRID_MAX_POINTS_X; x++)
         for (uint8_t y = 0; y < GRID_MAX_POINTS_Y; y++)
           if (!isnan(z_values[x][y]))
             z_values[x][y] -= mean + value;
+      mesh_changed(); // Also reached from M420 C
+    }
   }
 
   void unified_bed_leveling::shift_mesh_height() {
@@ -673,6 +675,7 @@
       for (uint8_t y = 0; y < GRID_MAX_POINTS_Y; y++)
         if (!isnan(z_values[x][y]))
           z_values[x][y] += g29_constant;
+    mesh_changed();
   }
 
   #if ENABLED(NEWPANEL)
@@ -718,6 +721,10 @@
 
       uint16_t count = GRID_MAX_POINTS;
 
+      #if ENABLED(PROBE_SCAN)
+        if (!stow_probe) probe_scan_start();
+      #endif
+
       do {
         if (do_ubl_mesh_map) display_map(g29_map_type);
 
@@ -725,6 +732,9 @@
           if (is_lcd_clicked()) {
             SERIAL_PROTOCOLLNPGM("\nMesh only partially populated.\n");
             lcd_quick_feedback(false);
+            #if ENABLED(PROBE_SCAN)
+              probe_scan_end();
+            #endif
             STOW_PROBE();
             while (is_lcd_clicked()) idle();
             lcd_external_control = false;
@@ -737,8 +747,14 @@
 
         if (do_furthest)
           location = find_furthest_invalid_mesh_point();
-        else
-          location = find_closest_mesh_point_of_type(INVALID, rx, ry, USE_PROBE_AS_REFERENCE, NULL);
+        else {
+          #if ENABLED(PROBE_SCAN)
+            // Step to the nearest point from the probe's last one, tracing the rows
+            location = find_closest_mesh_point_of_type(INVALID, current_position[X_AXIS] + X_PROBE_OFFSET_FROM_EXTRUDER, current_position[Y_AXIS] + Y_PROBE_OFFSET_FROM_EXTRUDER, USE_PROBE_AS_REFERENCE, NULL);
+          #else
+            location = find_closest_mesh_point_of_type(INVALID, rx, ry, USE_PROBE_AS_REFERENCE, NULL);
+          #endif
+        }
 
         if (location.x_index >= 0) {    // mesh point found and is reachable by probe
           const float rawx = mesh_index_to_xpos(location.x_index),
@@ -750,6 +766,10 @@
         SERIAL_FLUSH(); // Prevent host M105 buffer overrun.
       } while (location.x_index >= 0 && --count);
 
+      #if ENABLED(PROBE_SCAN)
+        probe_scan_end();
+      #endif
+
       STOW_PROBE();
 
       #ifdef Z_AFTER_PROBING
@@ -36,7 +36,116 @@
     extern void set_current_from_destination();
   #endif
 
-  #if !UBL_SEGMENTED
+  #if !UBL_SEGMENTED && ENABLED(UBL_CELL_GRADIENTS)
+
+    /**
+     * Walk the move once, in the order it crosses the X and Y mesh lines, and end a
+     * segment at each crossing. The next crossing on each axis is kept as a fraction
+     * of the whole move and advanced by a constant step, and the Z correction comes
+     * from the cached cell coefficients, so each segment costs only multiply-adds.
+     */
+    void unified_bed_leveling::line_to_destination_cartesian(const float &feed_rate, const uint8_t extruder) {
+      #if ENABLED(SKEW_CORRECTION)
+        // For skew correction just adjust the destination point and we're done
+        float start[XYZE] = { current_position[X_AXIS], current_position[Y_AXIS], current_position[Z_AXIS], current_position[E_CART] },
+              end[XYZE] = { destination[X_AXIS], destination[Y_AXIS], destination[Z_AXIS], destination[E_CART] };
+        planner.skew(start[X_AXIS], start[Y_AXIS], start[Z_AXIS]);
+        planner.skew(end[X_AXIS], end[Y_AXIS], end[Z_AXIS]);
+      #else
+        const float (&start)[XYZE] = current_position,
+                      (&end)[XYZE] = destination;
+      #endif
+
+      if (g26_debug_flag) {
+        SERIAL_ECHOPAIR(" ubl.line_to_destination_cartesian(xe=", destination[X_AXIS]);
+        SERIAL_ECHOPAIR(", ye=", destination[Y_AXIS]);
+        SERIAL_ECHOPAIR(", ze=", destination[Z_AXIS]);
+        SERIAL_ECHOPAIR(", ee=", destination[E_CART]);
+        SERIAL_CHAR(')');
+        SERIAL_EOL();
+        debug_current_and_destination(PSTR("Start of ubl.line_to_destination_cartesian()"));
+      }
+
+      if (!gradients_valid) update_gradients();
+
+      int8_t cell_xi = get_cell_index_x(start[X_AXIS]),
+             cell_yi = get_cell_index_y(start[Y_AXIS]);
+
+      const int8_t cell_dest_xi = get_cell_index_x(end[X_AXIS]),
+                   cell_dest_yi = get_cell_index_y(end[Y_AXIS]);
+
+      const float fade_scaling_factor = planner.fade_scaling_factor_for_z(end[Z_AXIS]);
+
+      if (cell_xi != cell_dest_xi || cell_yi != cell_dest_yi) {
+
+        const float dx = end[X_AXIS] - start[X_AXIS],
+                    dy = end[Y_AXIS] - start[Y_AXIS],
+                    dz = end[Z_AXIS] - start[Z_AXIS],
+                    de = end[E_CART] - start[E_CART];
+
+        const bool right_flag = dx > 0, up_flag = dy > 0;
+        const int8_t dxi = right_flag ? 1 : -1,
+                     dyi = up_flag ? 1 : -1;
+
+        uint8_t xi_cnt = ABS(cell_dest_xi - cell_xi),
+                yi_cnt = ABS(cell_dest_yi - cell_yi);
+
+        // Fraction of the move at the next X and Y mesh line, and between successive lines.
+        // An axis with no lines to cross never divides, so a zero dx or dy is harmless.
+        float tx = 0, ty = 0, tx_step = 0, ty_step = 0;
+        if (xi_cnt) {
+          const float inv_dx = 1.0f / dx;
+          tx = (mesh_index_to_xpos(cell_xi + right_flag) - start[X_AXIS]) * inv_dx;
+          tx_step = (MESH_X_DIST) * dxi * inv_dx;
+        }
+        if (yi_cnt) {
+          const float inv_dy = 1.0f / dy;
+          ty = (mesh_index_to_ypos(cell_yi + up_flag) - start[Y_AXIS]) * inv_dy;
+          ty_step = (MESH_Y_DIST) * dyi * inv_dy;
+        }
+
+        while (xi_cnt || yi_cnt) {
+          // Interpolate within the cell being left. Both cells agree on the shared edge.
+          const int8_t xi = cell_xi, yi = cell_yi;
+          float t, rx, ry;
+          if (xi_cnt && (!yi_cnt || tx < ty)) {   // Crossing an X mesh line next
+            t = tx;
+            tx += tx_step;
+            rx = mesh_index_to_xpos(cell_xi + right_flag);
+            ry = start[Y_AXIS] + dy * t;
+            cell_xi += dxi;
+            xi_cnt--;
+          }
+          else {                                  // Crossing a Y mesh line next
+            t = ty;
+            ty += ty_step;
+            rx = start[X_AXIS] + dx * t;
+            ry = mesh_index_to_ypos(cell_yi + up_flag);
+            cell_yi += dyi;
+            yi_cnt--;
+          }
+
+          // A move starting exactly on a mesh line would give a zero length segment
+          if (t > 0 && !planner.buffer_segment(rx, ry,
+                start[Z_AXIS] + dz * t + cell_z_correction(xi, yi, rx, ry) * fade_scaling_factor,
+                start[E_CART] + de * t, feed_rate, extruder)
+          ) break;
+        }
+
+        if (g26_debug_flag)
+          debug_current_and_destination(PSTR("mesh line crossings done in ubl.line_to_destination_cartesian()"));
+      }
+
+      const float z0 = cell_z_correction(cell_dest_xi, cell_dest_yi, end[X_AXIS], end[Y_AXIS]) * fade_scaling_factor;
+      planner.buffer_segment(end[X_AXIS], end[Y_AXIS], end[Z_AXIS] + z0, end[E_CART], feed_rate, extruder);
+
+      if (g26_debug_flag)
+        debug_current_and_destination(PSTR("FINAL_MOVE in ubl.line_to_destination_cartesian()"));
+
+      set_current_from_destination();
+    }
+
+  #elif !UBL_SEGMENTED
 
     void unified_bed_leveling::line_to_destination_cartesian(const float &feed_rate, const uint8_t extruder) {
       /**
@@ -488,6 +597,10 @@
         const float fade_scaling_factor = planner.fade_scaling_factor_for_z(rtarget[Z_AXIS]);
       #endif
 
+      #if ENABLED(UBL_CELL_GRADIENTS)
+        if (!gradients_valid) update_gradients();
+      #endif
+
       // increment to first segment destination
       LOOP_XYZE(i) raw[i] += diff[i];
 
@@ -503,43 +616,74 @@
         int8_t cell_xi = (raw[X_AXIS] - (MESH_MIN_X)) * (1.0f / (MESH_X_DIST)),
                cell_yi = (raw[Y_AXIS] - (MESH_MIN_Y)) * (1.0f / (MESH_Y_DIST));
 
-        cell_xi = constrain(cell_xi, 0, (GRID_MAX_POINTS_X) - 1);
-        cell_yi = constrain(cell_yi, 0, (GRID_MAX_POINTS_Y) - 1);
+        #if ENABLED(UBL_CELL_GRADIENTS)
+
+          // The cached coefficients only cover whole cells, so the last row and
+          // column of the mesh use the cells next to them.
+          cell_xi = constrain(cell_xi, 0, (GRID_MAX_POINTS_X) - 2);
+          cell_yi = constrain(cell_yi, 0, (GRID_MAX_POINTS_Y) - 2);
+
+          const cell_gradient_t &g = gradients[cell_xi][cell_yi];
+
+          float cx = raw[X_AXIS] - mesh_index_to_xpos(cell_xi),   // cell-relative x and y
+                cy = raw[Y_AXIS] - mesh_index_to_ypos(cell_yi);
+
+          // Outside the cell the coefficients would extrapolate off the mesh.
+          // Hold the cell's edge height for this one segment instead, then
+          // look up the cell again for the next.
+          const bool off_cell = !WITHIN(cx, 0, MESH_X_DIST) || !WITHIN(cy, 0, MESH_Y_DIST);
+          if (off_cell) {
+            cx = constrain(cx, 0, MESH_X_DIST);
+            cy = constrain(cy, 0, MESH_Y_DIST);
+          }
+
+          float z_cxy0 = g.z0 + g.dx * cx,    // z height along y0 at cx (changes for each cx in cell)
+                z_cxym = g.dy + g.dxy * cx;   // z slope per y along cx from y0 to y1 (changes for each cx in cell)
+
+          const float z_sxy0 = g.dx * diff[X_AXIS],    // per-segment adjustment to z_cxy0
+                      z_sxym = g.dxy * diff[X_AXIS];   // per-segment adjustment to z_cxym
+
+        #else
 
-        const float x0 = mesh_index_to_xpos(cell_xi),   // 64 byte table lookup avoids mul+add
-                    y0 = mesh_index_to_ypos(cell_yi);
+          cell_xi = constrain(cell_xi, 0, (GRID_MAX_POINTS_X) - 1);
+          cell_yi = constrain(cell_yi, 0, (GRID_MAX_POINTS_Y) - 1);
 
-        float z_x0y0 = z_values[cell_xi  ][cell_yi  ],  // z at lower left corner
-              z_x1y0 = z_values[cell_xi+1][cell_yi  ],  // z at upper left corner
-              z_x0y1 = z_values[cell_xi  ][cell_yi+1],  // z at lower right corner
-              z_x1y1 = z_values[cell_xi+1][cell_yi+1];  // z at upper right corner
+          const float x0 = mesh_index_to_xpos(cell_xi),   // 64 byte table lookup avoids mul+add
+                      y0 = mesh_index_to_ypos(cell_yi);
 
-        if (isnan(z_x0y0)) z_x0y0 = 0;              // ideally activating planner.leveling_active (G29 A)
-        if (isnan(z_x1y0)) z_x1y0 = 0;              //   should refuse if any invalid mesh points
-        if (isnan(z_x0y1)) z_x0y1 = 0;              //   in order to avoid isnan tests per cell,
-        if (isnan(z_x1y1)) z_x1y1 = 0;              //   thus guessing zero for undefined points
+          float z_x0y0 = z_values[cell_xi  ][cell_yi  ],  // z at lower left corner
+                z_x1y0 = z_values[cell_xi+1][cell_yi  ],  // z at upper left corner
+                z_x0y1 = z_values[cell_xi  ][cell_yi+1],  // z at lower right corner
+                z_x1y1 = z_values[cell_xi+1][cell_yi+1];  // z at upper right corner
 
-        float cx = raw[X_AXIS] - x0,   // cell-relative x and y
-              cy = raw[Y_AXIS] - y0;
+          if (isnan(z_x0y0)) z_x0y0 = 0;              // ideally activating planner.leveling_active (G29 A)
+          if (isnan(z_x1y0)) z_x1y0 = 0;              //   should refuse if any invalid mesh points
+          if (isnan(z_x0y1)) z_x0y1 = 0;              //   in order to avoid isnan tests per cell,
+          if (isnan(z_x1y1)) z_x1y1 = 0;              //   thus guessing zero for undefined points
 
-        const float z_xmy0 = (z_x1y0 - z_x0y0) * (1.0f / (MESH_X_DIST)),   // z slope per x along y0 (lower left to lower right)
-                    z_xmy1 = (z_x1y1 - z_x0y1) * (1.0f / (MESH_X_DIST));   // z slope per x along y1 (upper left to upper right)
+          float cx = raw[X_AXIS] - x0,   // cell-relative x and y
+                cy = raw[Y_AXIS] - y0;
 
-              float z_cxy0 = z_x0y0 + z_xmy0 * cx;            // z height along y0 at cx (changes for each cx in cell)
+          const float z_xmy0 = (z_x1y0 - z_x0y0) * (1.0f / (MESH_X_DIST)),   // z slope per x along y0 (lower left to lower right)
+                      z_xmy1 = (z_x1y1 - z_x0y1) * (1.0f / (MESH_X_DIST));   // z slope per x along y1 (upper left to upper right)
 
-        const float z_cxy1 = z_x0y1 + z_xmy1 * cx,            // z height along y1 at cx
-                    z_cxyd = z_cxy1 - z_cxy0;                 // z height difference along cx from y0 to y1
+                float z_cxy0 = z_x0y0 + z_xmy0 * cx;            // z height along y0 at cx (changes for each cx in cell)
 
-              float z_cxym = z_cxyd * (1.0f / (MESH_Y_DIST));  // z slope per y along cx from y0 to y1 (changes for each cx in cell)
+          const float z_cxy1 = z_x0y1 + z_xmy1 * cx,            // z height along y1 at cx
+                      z_cxyd = z_cxy1 - z_cxy0;                 // z height difference along cx from y0 to y1
 
-        //    float z_cxcy = z_cxy0 + z_cxym * cy;            // interpolated mesh z height along cx at cy (do inside the segment loop)
+                float z_cxym = z_cxyd * (1.0f / (MESH_Y_DIST));  // z slope per y along cx from y0 to y1 (changes for each cx in cell)
 
-        // As subsequent segments step through this cell, the z_cxy0 intercept will change
-        // and the z_cxym slope will change, both as a function of cx within the cell, and
-        // each change by a constant for fixed segment lengths.
+          //    float z_cxcy = z_cxy0 + z_cxym * cy;            // interpolated mesh z height along cx at cy (do inside the segment loop)
 
-        const float z_sxy0 = z_xmy0 * diff[X_AXIS],                                     // per-segment adjustment to z_cxy0
-                    z_sxym = (z_xmy1 - z_xmy0) * (1.0f / (MESH_Y_DIST)) * diff[X_AXIS];  // per-segment adjustment to z_cxym
+          // As subsequent segments step through this cell, the z_cxy0 intercept will change
+          // and the z_cxym slope will change, both as a function of cx within the cell, and
+          // each change by a constant for fixed segment lengths.
+
+          const float z_sxy0 = z_xmy0 * diff[X_AXIS],                                     // per-segment adjustment to z_cxy0
+                      z_sxym = (z_xmy1 - z_xmy0) * (1.0f / (MESH_Y_DIST)) * diff[X_AXIS];  // per-segment adjustment to z_cxym
+
+        #endif // !UBL_CELL_GRADIENTS
 
         for (;;) {  // for all segments within this mesh cell
 
@@ -565,8 +709,12 @@
           cx += diff[X_AXIS];
           cy += diff[Y_AXIS];
 
-          if (!WITHIN(cx, 0, MESH_X_DIST) || !WITHIN(cy, 0, MESH_Y_DIST))    // done within this cell, break to next
-            break;
+          if (
+            #if ENABLED(UBL_CELL_GRADIENTS)
+              off_cell ||
+            #endif
+            !WITHIN(cx, 0, MESH_X_DIST) || !WITHIN(cy, 0, MESH_Y_DIST)       // done within this cell, break to next
+          ) break;
 
           // Next segment still within same mesh cell, adjust the per-segment
           // slope and intercept to compute next z height.
@@ -92,6 +92,11 @@ uint8_t lcd_status_update_delay = 1, // First update one loop delayed
   uint8_t progress_bar_percent;
 #endif
 
+#if ENABLED(LCD_DIRTY_REGIONS)
+  static uint8_t lcd_status_dirty = LCD_STATUS_ALL; // Status Screen fields changed since they were drawn
+  uint8_t lcd_status_redraw;                        // Status Screen fields drawn by the current refresh
+#endif
+
 #if ENABLED(DOGLCD)
   #include "ultralcd_impl_DOGM.h"
   #include <U8glib.h>
@@ -109,6 +114,110 @@ millis_t next_lcd_update_ms;
 uint8_t lcdDrawUpdate = LCDVIEW_CLEAR_CALL_REDRAW; // Set when the LCD needs to draw, decrements after every draw. Set to 2 in LCD routines so the LCD gets at least 1 full redraw (first redraw is partial)
 uint16_t max_display_update_time = 0;
 
+#if ENABLED(LCD_DIRTY_REGIONS)
+
+  // Time spent drawing, for comparing against a build without LCD_DIRTY_REGIONS
+  static struct { uint32_t refreshes, skipped, draw_us; } lcd_draw_stats;
+
+  void lcd_report_draw_stats(const bool reset) {
+    SERIAL_ECHOPAIR("LCD refreshes:", lcd_draw_stats.refreshes);
+    SERIAL_ECHOPAIR(" skipped:", lcd_draw_stats.skipped);
+    SERIAL_ECHOPAIR(" draw time (ms):", lcd_draw_stats.draw_us / 1000UL);
+    if (lcd_draw_stats.refreshes)
+      SERIAL_ECHOPAIR(" per refresh (us):", lcd_draw_stats.draw_us / lcd_draw_stats.refreshes);
+    SERIAL_EOL();
+    if (reset) lcd_draw_stats.refreshes = lcd_draw_stats.skipped = lcd_draw_stats.draw_us = 0;
+  }
+
+  FORCE_INLINE void status_sum(uint16_t &sum, const int16_t value) { sum = ((sum << 3) | (sum >> 13)) + value; }
+
+  static void status_sum(uint16_t &sum, const char *str) { while (*str) status_sum(sum, *str++); }
+
+  /**
+   * Get the Status Screen fields whose shown values changed since the last call.
+   * Each field is reduced to a checksum of what the display prints for it, in the
+   * way the lightweight ST7920 status screen tracks its fields.
+   */
+  static uint8_t lcd_status_changes() {
+    static uint16_t last_sum[LCD_STATUS_FIELDS];
+    uint16_t sum[LCD_STATUS_FIELDS] = { 0 };
+    const bool blink = lcd_blink();
+
+    uint16_t &temps = sum[LCD_STATUS_TEMPS];
+    HOTEND_LOOP() {
+      status_sum(temps, thermalManager.degHotend(e) + 0.5f);
+      status_sum(temps, thermalManager.degTargetHotend(e));
+      status_sum(temps, thermalManager.isHeatingHotend(e));
+      #if HEATER_IDLE_HANDLER
+        if (thermalManager.is_heater_idle(e)) status_sum(temps, blink + 2); // Idle targets blink
+      #endif
+    }
+    #if HAS_HEATED_BED
+      status_sum(temps, thermalManager.degBed() + 0.5f);
+      status_sum(temps, thermalManager.degTargetBed());
+      status_sum(temps, thermalManager.isHeatingBed());
+      #if HEATER_IDLE_HANDLER
+        if (thermalManager.is_bed_idle()) status_sum(temps, blink + 2);
+      #endif
+      #if HAS_LEVELING
+        status_sum(temps, planner.leveling_active && blink);                // HD44780 bed symbol blinks
+      #endif
+    #endif
+    #if HAS_FAN0
+      status_sum(temps, fanSpeeds[0]);
+      if (fanSpeeds[0]) status_sum(temps, blink);                           // Fan animation
+    #endif
+
+    uint16_t &position = sum[LCD_STATUS_POSITION];
+    status_sum(position, ftostr4sign(LOGICAL_X_POSITION(current_position[X_AXIS])));
+    status_sum(position, ftostr4sign(LOGICAL_Y_POSITION(current_position[Y_AXIS])));
+    status_sum(position, ftostr52sp(LOGICAL_Z_POSITION(current_position[Z_AXIS])));
+    status_sum(position, axis_homed | (axis_known_position << 4));
+    if (axis_homed != (_BV(X_AXIS) | _BV(Y_AXIS) | _BV(Z_AXIS)) || axis_known_position != axis_homed)
+      status_sum(position, blink);                                          // Unknown positions blink
+    #if HAS_LEVELING && !HAS_HEATED_BED
+      status_sum(position, planner.leveling_active || blink);
+    #endif
+
+    uint16_t &progress = sum[LCD_STATUS_PROGRESS];
+    status_sum(progress, feedrate_percentage);
+    status_sum(progress, print_job_timer.duration() / 60);                  // Elapsed time shows minutes
+    #if ENABLED(SDSUPPORT)
+      status_sum(progress, card.percentDone() | (card.isFileOpen() << 8) | (IS_SD_PRINTING() << 9));
+    #endif
+    #if ENABLED(LCD_SET_PROGRESS_MANUALLY)
+      status_sum(progress, progress_bar_percent);
+    #endif
+    #if ENABLED(FILAMENT_LCD_DISPLAY)
+      status_sum(progress, ftostr12ns(filament_width_meas));
+      status_sum(progress, planner.volumetric_multiplier[FILAMENT_SENSOR_EXTRUDER_NUM] * 100);
+    #endif
+
+    uint16_t &message = sum[LCD_STATUS_MESSAGE];
+    status_sum(message, lcd_status_message);
+    #if ENABLED(STATUS_MESSAGE_SCROLLING)
+      if (utf8_strlen(lcd_status_message) > LCD_WIDTH) status_sum(message, blink); // Scrolls on blink
+    #endif
+    #if ENABLED(LCD_PROGRESS_BAR)
+      status_sum(message, ELAPSED(millis(), progress_bar_ms + PROGRESS_BAR_MSG_TIME));
+      message += progress;                                                  // The bar shares the status line
+    #endif
+    #if ENABLED(FILAMENT_LCD_DISPLAY) && ENABLED(SDSUPPORT)
+      status_sum(message, ELAPSED(millis(), previous_lcd_status_ms + 5000UL));
+      message += progress;
+    #endif
+
+    uint8_t changed = 0;
+    for (uint8_t i = 0; i < LCD_STATUS_FIELDS; i++)
+      if (sum[i] != last_sum[i]) {
+        last_sum[i] = sum[i];
+        SBI(changed, i);
+      }
+    return changed;
+  }
+
+#endif // LCD_DIRTY_REGIONS
+
 #if ENABLED(ULTIPANEL)
 
   #define DEFINE_LCD_IMPLEMENTATION_DRAWMENU_SETTING_EDIT_TYPE(_type, _name, _strFunc) \
@@ -741,6 +850,21 @@ void lcd_status_screen() {
 
   #endif // ULTIPANEL
 
+  #if ENABLED(LCD_DIRTY_REGIONS)
+    // Take the changed fields at the start of each refresh and draw only those.
+    // A graphical display also stops after the last page holding one of them.
+    if (first_page) {
+      lcd_status_redraw = lcd_status_dirty | lcd_status_changes();
+      lcd_status_dirty = 0;
+    }
+    if (!lcd_implementation_status_pages(first_page)) {
+      #if ENABLED(DOGLCD)
+        drawing_screen = false;
+      #endif
+      return;
+    }
+  #endif
+
   lcd_implementation_status_screen();
 }
 
@@ -5285,7 +5409,13 @@ void lcd_update() {
         #endif
       ;
       max_display_update_time--;
-      lcdDrawUpdate = LCDVIEW_REDRAW_NOW;
+      #if ENABLED(LCD_DIRTY_REGIONS)
+        lcd_status_dirty |= lcd_status_changes();
+        if (!lcd_status_dirty)
+          lcd_draw_stats.skipped++;
+        else
+      #endif
+          lcdDrawUpdate = LCDVIEW_REDRAW_NOW;
     }
 
     #if ENABLED(ULTIPANEL) && ENABLED(SCROLL_LONG_FILENAMES)
@@ -5310,6 +5440,10 @@ void lcd_update() {
 
     if ((lcdDrawUpdate || IS_DRAWING) && (!bbr2 || bbr2 > max_display_update_time)) {
 
+      #if ENABLED(LCD_DIRTY_REGIONS)
+        const uint32_t draw_start_us = micros();
+      #endif
+
       // Change state of drawing flag between screen updates
       if (!IS_DRAWING) switch (lcdDrawUpdate) {
         case LCDVIEW_CALL_NO_REDRAW:
@@ -5361,6 +5495,9 @@ void lcd_update() {
           // The nextPage will already be set up on the next call.
           if (drawing_screen && (drawing_screen = u8g.nextPage())) {
             NOLESS(max_display_update_time, millis() - ms);
+            #if ENABLED(LCD_DIRTY_REGIONS)
+              lcd_draw_stats.draw_us += micros() - draw_start_us;
+            #endif
             return;
           }
         }
@@ -5375,6 +5512,15 @@ void lcd_update() {
       // Keeping track of the longest time for an individual LCD update.
       // Used to do screen throttling when the planner starts to fill up.
       NOLESS(max_display_update_time, millis() - ms);
+
+      #if ENABLED(LCD_DIRTY_REGIONS)
+        lcd_draw_stats.draw_us += micros() - draw_start_us;
+        lcd_draw_stats.refreshes++;
+        #if ENABLED(ULTIPANEL)
+          // Any other screen overwrites the whole Status Screen
+          if (currentScreen != lcd_status_screen) lcd_status_dirty = LCD_STATUS_ALL;
+        #endif
+      #endif
     }
 
     #if ENABLED(ULTIPANEL)
@@ -5390,7 +5536,11 @@ void lcd_update() {
     // Change state of drawing flag between screen updates
     if (!IS_DRAWING) switch (lcdDrawUpdate) {
       case LCDVIEW_CLEAR_CALL_REDRAW:
-        lcd_implementation_clear(); break;
+        lcd_implementation_clear();
+        #if ENABLED(LCD_DIRTY_REGIONS)
+          lcd_status_dirty = LCD_STATUS_ALL;
+        #endif
+        break;
       case LCDVIEW_REDRAW_NOW:
         lcdDrawUpdate = LCDVIEW_NONE;
       case LCDVIEW_NONE:
@@ -5691,7 +5841,7 @@ void lcd_reset_alert_level() { lcd_status_message_level = 0; }
     }
   #endif
 
-  #if ENABLED(AUTO_BED_LEVELING_UBL) || ENABLED(G26_MESH_VALIDATION)
+  #if ENABLED(AUTO_BED_LEVELING_UBL) || ENABLED(G26_MESH_VALIDATION) || ENABLED(LA_CALIBRATION_PATTERN)
     bool is_lcd_clicked() { return LCD_CLICKED; }
     void wait_for_release() {
       while (is_lcd_clicked()) safe_delay(50);
@@ -56,6 +56,22 @@
   extern uint8_t lcdDrawUpdate;
   inline void lcd_refresh() { lcdDrawUpdate = LCDVIEW_CLEAR_CALL_REDRAW; }
 
+  #if ENABLED(LCD_DIRTY_REGIONS)
+    enum LCDStatusField : char {
+      LCD_STATUS_TEMPS,     // Temperatures, heater and fan states
+      LCD_STATUS_POSITION,  // XYZ position
+      LCD_STATUS_PROGRESS,  // Feedrate, SD progress, elapsed time
+      LCD_STATUS_MESSAGE,   // Status line
+      LCD_STATUS_FIELDS
+    };
+    #define LCD_STATUS_ALL (_BV(LCD_STATUS_FIELDS) - 1)
+    #define LCD_STATUS_DIRTY(F) TEST(lcd_status_redraw, LCD_STATUS_##F)
+    extern uint8_t lcd_status_redraw;  // Status Screen fields drawn by the current refresh
+    void lcd_report_draw_stats(const bool reset);
+  #else
+    #define LCD_STATUS_DIRTY(F) true
+  #endif
+
   #if HAS_BUZZER
     void lcd_buzz(const long duration, const uint16_t freq);
   #endif
@@ -191,7 +207,7 @@
 
   #endif
 
-  #if ENABLED(AUTO_BED_LEVELING_UBL) || ENABLED(G26_MESH_VALIDATION)
+  #if ENABLED(AUTO_BED_LEVELING_UBL) || ENABLED(G26_MESH_VALIDATION) || ENABLED(LA_CALIBRATION_PATTERN)
     bool is_lcd_clicked();
     void wait_for_release();
   #endif
@@ -382,6 +382,10 @@ static void lcd_implementation_init() {
   #elif ENABLED(LCD_SCREEN_ROT_270)
     u8g.setRot270();  // Rotate screen by 270°
   #endif
+
+  #if ENABLED(LCD_DIRTY_REGIONS)
+    lcd_status_dirty = LCD_STATUS_ALL;
+  #endif
 }
 
 // The kill screen is displayed for unrecoverable conditions
@@ -464,9 +464,24 @@ static void lcd_implementation_init(
   );
 
   lcd.clear();
+
+  #if ENABLED(LCD_DIRTY_REGIONS)
+    lcd_status_dirty = LCD_STATUS_ALL;
+  #endif
+}
+
+void lcd_implementation_clear() {
+  lcd.clear();
+  #if ENABLED(LCD_DIRTY_REGIONS)
+    lcd_status_dirty = LCD_STATUS_ALL;
+  #endif
 }
 
-void lcd_implementation_clear() { lcd.clear(); }
+#if ENABLED(LCD_DIRTY_REGIONS)
+  // Characters stay on the display, so only the changed fields need redrawing
+  inline bool lcd_implementation_status_pages(const bool) { return lcd_status_redraw; }
+#endif
+
 void lcd_print(const char c) { charset_mapper(c); }
 void lcd_print(const char *str) { while (*str) lcd.print(*str++); }
 void lcd_printPGM(const char *str) { while (const char c = pgm_read_byte(str)) lcd.print(c), ++str; }
@@ -740,57 +755,61 @@ static void lcd_implementation_status_screen() {
   // Line 1
   //
 
-  lcd.setCursor(0, 0);
+  if (LCD_STATUS_DIRTY(TEMPS)) {
 
-  #if LCD_WIDTH < 20
+    lcd.setCursor(0, 0);
 
-    //
-    // Hotend 0 Temperature
-    //
-    _draw_heater_status(0, -1, blink);
+    #if LCD_WIDTH < 20
 
-    //
-    // Hotend 1 or Bed Temperature
-    //
-    #if HOTENDS > 1 || HAS_HEATED_BED
+      //
+      // Hotend 0 Temperature
+      //
+      _draw_heater_status(0, -1, blink);
 
-      lcd.setCursor(8, 0);
-      #if HOTENDS > 1
-        lcd.print((char)LCD_STR_THERMOMETER[0]);
-        _draw_heater_status(1, -1, blink);
-      #else
-        lcd.print((char)LCD_BEDTEMP_CHAR);
-        _draw_heater_status(-1, -1, blink);
-      #endif
+      //
+      // Hotend 1 or Bed Temperature
+      //
+      #if HOTENDS > 1 || HAS_HEATED_BED
 
-    #endif // HOTENDS > 1 || HAS_HEATED_BED
+        lcd.setCursor(8, 0);
+        #if HOTENDS > 1
+          lcd.print((char)LCD_STR_THERMOMETER[0]);
+          _draw_heater_status(1, -1, blink);
+        #else
+          lcd.print((char)LCD_BEDTEMP_CHAR);
+          _draw_heater_status(-1, -1, blink);
+        #endif
 
-  #else // LCD_WIDTH >= 20
+      #endif // HOTENDS > 1 || HAS_HEATED_BED
 
-    //
-    // Hotend 0 Temperature
-    //
-    _draw_heater_status(0, LCD_STR_THERMOMETER[0], blink);
+    #else // LCD_WIDTH >= 20
 
-    //
-    // Hotend 1 or Bed Temperature
-    //
-    #if HOTENDS > 1 || HAS_HEATED_BED
-      lcd.setCursor(10, 0);
-      #if HOTENDS > 1
-        _draw_heater_status(1, LCD_STR_THERMOMETER[0], blink);
-      #else
-        _draw_heater_status(-1, (
-          #if HAS_LEVELING
-            planner.leveling_active && blink ? '_' :
-          #endif
-          LCD_BEDTEMP_CHAR
-        ), blink);
-      #endif
+      //
+      // Hotend 0 Temperature
+      //
+      _draw_heater_status(0, LCD_STR_THERMOMETER[0], blink);
+
+      //
+      // Hotend 1 or Bed Temperature
+      //
+      #if HOTENDS > 1 || HAS_HEATED_BED
+        lcd.setCursor(10, 0);
+        #if HOTENDS > 1
+          _draw_heater_status(1, LCD_STR_THERMOMETER[0], blink);
+        #else
+          _draw_heater_status(-1, (
+            #if HAS_LEVELING
+              planner.leveling_active && blink ? '_' :
+            #endif
+            LCD_BEDTEMP_CHAR
+          ), blink);
+        #endif
 
-    #endif // HOTENDS > 1 || HAS_HEATED_BED
+      #endif // HOTENDS > 1 || HAS_HEATED_BED
 
-  #endif // LCD_WIDTH >= 20
+    #endif // LCD_WIDTH >= 20
+
+  }
 
   //
   // Line 2
@@ -801,54 +820,63 @@ static void lcd_implementation_status_screen() {
     #if LCD_WIDTH < 20
 
       #if ENABLED(SDSUPPORT)
-        lcd.setCursor(0, 2);
-        lcd_printPGM(PSTR("SD"));
-        if (IS_SD_PRINTING())
-          lcd.print(itostr3(card.percentDone()));
-        else
-          lcd_printPGM(PSTR("---"));
-          lcd.write('%');
+        if (LCD_STATUS_DIRTY(PROGRESS)) {
+          lcd.setCursor(0, 2);
+          lcd_printPGM(PSTR("SD"));
+          if (IS_SD_PRINTING())
+            lcd.print(itostr3(card.percentDone()));
+          else
+            lcd_printPGM(PSTR("---"));
+            lcd.write('%');
+        }
       #endif // SDSUPPORT
 
     #else // LCD_WIDTH >= 20
 
-      lcd.setCursor(0, 1);
-
       // If the first line has two extruder temps,
       // show more temperatures on the next line
 
       #if HOTENDS > 2 || (HOTENDS > 1 && HAS_HEATED_BED)
 
-        #if HOTENDS > 2
-          _draw_heater_status(2, LCD_STR_THERMOMETER[0], blink);
-          lcd.setCursor(10, 1);
-        #endif
+        if (LCD_STATUS_DIRTY(TEMPS)) {
+          lcd.setCursor(0, 1);
 
-        _draw_heater_status(-1, (
-          #if HAS_LEVELING
-            planner.leveling_active && blink ? '_' :
+          #if HOTENDS > 2
+            _draw_heater_status(2, LCD_STR_THERMOMETER[0], blink);
+            lcd.setCursor(10, 1);
           #endif
-          LCD_BEDTEMP_CHAR
-        ), blink);
+
+          _draw_heater_status(-1, (
+            #if HAS_LEVELING
+              planner.leveling_active && blink ? '_' :
+            #endif
+            LCD_BEDTEMP_CHAR
+          ), blink);
+        }
 
       #else // HOTENDS <= 2 && (HOTENDS <= 1 || !HAS_HEATED_BED)
 
-        _draw_axis_value(X_AXIS, ftostr4sign(LOGICAL_X_POSITION(current_position[X_AXIS])), blink);
+        if (LCD_STATUS_DIRTY(POSITION)) {
+          lcd.setCursor(0, 1);
+          _draw_axis_value(X_AXIS, ftostr4sign(LOGICAL_X_POSITION(current_position[X_AXIS])), blink);
 
-        lcd.write(' ');
+          lcd.write(' ');
 
-        _draw_axis_value(Y_AXIS, ftostr4sign(LOGICAL_Y_POSITION(current_position[Y_AXIS])), blink);
+          _draw_axis_value(Y_AXIS, ftostr4sign(LOGICAL_Y_POSITION(current_position[Y_AXIS])), blink);
+        }
 
       #endif // HOTENDS <= 2 && (HOTENDS <= 1 || !HAS_HEATED_BED)
 
     #endif // LCD_WIDTH >= 20
 
-    lcd.setCursor(LCD_WIDTH - 8, 1);
-    _draw_axis_value(Z_AXIS, ftostr52sp(LOGICAL_Z_POSITION(current_position[Z_AXIS])), blink);
+    if (LCD_STATUS_DIRTY(POSITION)) {
+      lcd.setCursor(LCD_WIDTH - 8, 1);
+      _draw_axis_value(Z_AXIS, ftostr52sp(LOGICAL_Z_POSITION(current_position[Z_AXIS])), blink);
 
-    #if HAS_LEVELING && !HAS_HEATED_BED
-      lcd.write(planner.leveling_active || blink ? '_' : ' ');
-    #endif
+      #if HAS_LEVELING && !HAS_HEATED_BED
+        lcd.write(planner.leveling_active || blink ? '_' : ' ');
+      #endif
+    }
 
   #endif // LCD_HEIGHT > 2
 
@@ -858,30 +886,34 @@ static void lcd_implementation_status_screen() {
 
   #if LCD_HEIGHT > 3
 
-    lcd.setCursor(0, 2);
-    lcd.print((char)LCD_FEEDRATE_CHAR);
-    lcd.print(itostr3(feedrate_percentage));
-    lcd.write('%');
-
-    #if LCD_WIDTH >= 20 && ENABLED(SDSUPPORT)
-
-      lcd.setCursor(7, 2);
-      lcd_printPGM(PSTR("SD"));
-      if (IS_SD_PRINTING())
-        lcd.print(itostr3(card.percentDone()));
-      else
-        lcd_printPGM(PSTR("---"));
+    if (LCD_STATUS_DIRTY(PROGRESS)) {
+
+      lcd.setCursor(0, 2);
+      lcd.print((char)LCD_FEEDRATE_CHAR);
+      lcd.print(itostr3(feedrate_percentage));
       lcd.write('%');
 
-    #endif // LCD_WIDTH >= 20 && SDSUPPORT
+      #if LCD_WIDTH >= 20 && ENABLED(SDSUPPORT)
 
-    char buffer[10];
-    duration_t elapsed = print_job_timer.duration();
-    uint8_t len = elapsed.toDigital(buffer);
+        lcd.setCursor(7, 2);
+        lcd_printPGM(PSTR("SD"));
+        if (IS_SD_PRINTING())
+          lcd.print(itostr3(card.percentDone()));
+        else
+          lcd_printPGM(PSTR("---"));
+        lcd.write('%');
+
+      #endif // LCD_WIDTH >= 20 && SDSUPPORT
+
+      char buffer[10];
+      duration_t elapsed = print_job_timer.duration();
+      uint8_t len = elapsed.toDigital(buffer);
 
-    lcd.setCursor(LCD_WIDTH - len - 1, 2);
-    lcd.print((char)LCD_CLOCK_CHAR);
-    lcd_print(buffer);
+      lcd.setCursor(LCD_WIDTH - len - 1, 2);
+      lcd.print((char)LCD_CLOCK_CHAR);
+      lcd_print(buffer);
+
+    }
 
   #endif // LCD_HEIGHT > 3
 
@@ -890,6 +922,8 @@ static void lcd_implementation_status_screen() {
   // Status Message (which may be a Progress Bar or Filament display)
   //
 
+  if (!LCD_STATUS_DIRTY(MESSAGE)) return;
+
   lcd.setCursor(0, LCD_HEIGHT - 1);
 
   #if ENABLED(LCD_PROGRESS_BAR)
@@ -34,7 +34,7 @@ void safe_delay(millis_t ms) {
   thermalManager.manage_heater(); // This keeps us safe if too many small safe_delay() calls are made
 }
 
-#if ENABLED(EEPROM_SETTINGS)
+#if ENABLED(EEPROM_SETTINGS) || ENABLED(BINARY_FILE_UPLOAD)
 
   void crc16(uint16_t *crc, const void * const data, uint16_t cnt) {
     uint8_t *ptr = (uint8_t *)data;
@@ -45,7 +45,7 @@ void safe_delay(millis_t ms) {
     }
   }
 
-#endif // EEPROM_SETTINGS
+#endif // EEPROM_SETTINGS || BINARY_FILE_UPLOAD
 
 #if ENABLED(ULTRA_LCD) || (ENABLED(DEBUG_LEVELING_FEATURE) && (ENABLED(MESH_BED_LEVELING) || (HAS_ABL && !ABL_PLANAR)))
 
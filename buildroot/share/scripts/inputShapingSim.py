@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+
+"""
+Show the residual vibration left by the INPUT_SHAPING shapers.
+
+Computes the shaper impulses the same way as Marlin (weights quantized
+to 1/256 step, delays to whole slots of the stepper's shaping clock) and
+prints the vibration that remains at each frequency, as a percentage of
+the vibration of an unshaped move. The shaper is tuned to --freq, so the
+table shows how well it copes when the real resonance is elsewhere.
+
+Example:
+  inputShapingSim.py --freq 42 --zeta 0.1 --shaper all --min 20 --max 80
+"""
+
+import argparse
+import math
+
+SHAPERS = ('zv', 'mzv', 'ei')
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('-f', '--freq', type=float, default=40.0, help='Shaper frequency in Hz, as M593 F (default=40)')
+parser.add_argument('-d', '--zeta', type=float, default=0.1, help='Shaper damping ratio, as M593 D (default=0.1)')
+parser.add_argument('-s', '--shaper', choices=SHAPERS + ('all',), default='mzv', help='Shaper type (default=mzv)')
+parser.add_argument('--damping', type=float, default=None, help='Damping ratio of the machine (default=same as --zeta)')
+parser.add_argument('--min', type=float, default=None, help='Lowest frequency shown (default=freq/2)')
+parser.add_argument('--max', type=float, default=None, help='Highest frequency shown (default=freq*2)')
+parser.add_argument('--step', type=float, default=None, help='Frequency step (default=range/40)')
+parser.add_argument('--timer-rate', type=int, default=2000000, help='Stepper timer rate in Hz (default=2000000, AVR)')
+parser.add_argument('--slot-ticks', type=int, default=1024, help='SHAPING_SLOT_TICKS (default=1024)')
+parser.add_argument('--ideal', action='store_true', help='Use exact impulses, without the firmware quantization')
+args = parser.parse_args()
+
+def impulses(shaper, freq, zeta):
+  """ Return the (weight, time) impulses of a shaper, as in InputShaping::impulses() """
+  zeta = min(max(zeta, 0.0), 0.5)
+  df = math.sqrt(1 - zeta ** 2)
+  K = math.exp(-zeta * math.pi / df)
+  td = 1 / (freq * df)
+  if shaper == 'zv':
+    a = [1, K]
+    t = [0, 0.5 * td]
+  elif shaper == 'mzv':
+    Km = math.exp(-0.75 * zeta * math.pi / df)
+    a1 = 1 - 1 / math.sqrt(2)
+    a = [a1, (math.sqrt(2) - 1) * Km, a1 * Km ** 2]
+    t = [0, 0.375 * td, 0.75 * td]
+  else:
+    v = 0.05
+    a1 = 0.25 * (1 + v)
+    a = [a1, 0.5 * (1 - v) * K, a1 * K ** 2]
+    t = [0, 0.5 * td, td]
+
+  total = sum(a)
+  if args.ideal:
+    return [(ai / total, ti) for ai, ti in zip(a, t)]
+
+  slot = args.slot_ticks / float(args.timer_rate)
+  w = [int(round(256 * ai / total)) for ai in a[1:]]
+  d = [max(1, int(round(ti / slot))) for ti in t[1:]]
+  return [((256 - sum(w)) / 256.0, 0.0)] + [(wi / 256.0, di * slot) for wi, di in zip(w, d)]
+
+def residual(imp, freq, zeta):
+  """ Vibration left at the given frequency, relative to a single impulse """
+  w = 2 * math.pi * freq
+  wd = w * math.sqrt(1 - zeta ** 2)
+  tn = imp[-1][1]
+  c = sum(a * math.exp(zeta * w * (t - tn)) * math.cos(wd * t) for a, t in imp)
+  s = sum(a * math.exp(zeta * w * (t - tn)) * math.sin(wd * t) for a, t in imp)
+  return math.hypot(c, s)
+
+shapers = SHAPERS if args.shaper == 'all' else (args.shaper,)
+damping = args.zeta if args.damping is None else args.damping
+fmin = args.min if args.min is not None else args.freq / 2
+fmax = args.max if args.max is not None else args.freq * 2
+step = args.step if args.step is not None else (fmax - fmin) / 40
+
+for name in shapers:
+  imp = impulses(name, args.freq, args.zeta)
+  print('%-4s' % name.upper() + '  '.join('%.3f@%.2fms' % (a, t * 1000) for a, t in imp))
+print()
+
+BAR = 30
+print('   Hz  ' + ''.join('%9s ' % n.upper() for n in shapers) + '  ' + shapers[-1].upper() + ' 0-100%')
+f = fmin
+while f <= fmax + step / 2:
+  v = [100 * residual(impulses(n, args.freq, args.zeta), f, damping) for n in shapers]
+  bar = '#' * int(round(min(v[-1], 100) * BAR / 100))
+  print('%6.1f ' % f + ''.join('%8.1f%% ' % x for x in v) + '  |' + bar)
+  f += step
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+
+"""
+Pick the Linear Advance K from a G25 calibration print.
+
+G25 prints one slow-fast-slow line per K value. With K too low, a line
+thins out where it speeds up and bulges where it slows down. With K too
+high it's the other way around. This tool scores each line as
+
+  score = (width change where it slows down) - (width change where it speeds up)
+
+fits a straight line through the scores and reports the K where the score
+is zero. The K of each line comes from the G25 log (--log) or from
+--start/--step, in the same way as the G25 A and I parameters.
+
+The line widths are taken from one of:
+
+  --measure FILE  A CSV with one row per line, front line first:
+                  line,accel,decel
+                  where accel and decel are the width change (mm, or any
+                  unit used for all rows) right after the speed-up and the
+                  slow-down, positive for a bulge and negative for a thin spot.
+
+  --image FILE    A top-down photo of the pattern, cropped to the lines and
+                  rotated so they run left to right, front line at the bottom.
+                  Needs Pillow. Use --invert if the filament is darker than
+                  the bed.
+
+Example:
+  laCalibration.py --log g25.log --measure widths.csv
+  laCalibration.py --log g25.log --image pattern.jpg --invert
+  laCalibration.py --start 0 --step 0.1 --measure widths.csv
+"""
+
+import argparse
+import re
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('--log', help='Serial log of the G25 run ("G25 line:N K:x ms:t" lines)')
+parser.add_argument('--start', type=float, default=0.0, help='K of the first line, if no log (default=0)')
+parser.add_argument('--step', type=float, default=0.1, help='K increment, if no log (default=0.1)')
+parser.add_argument('--measure', help='CSV of measured width changes (line,accel,decel)')
+parser.add_argument('--image', help='Photo of the pattern, cropped to the lines')
+parser.add_argument('--invert', action='store_true', help='Filament is darker than the bed in the photo')
+parser.add_argument('--slow', type=float, default=20, help='LA_CAL_SLOW_LENGTH in mm (default=20)')
+parser.add_argument('--fast', type=float, default=40, help='LA_CAL_FAST_LENGTH in mm (default=40)')
+args = parser.parse_args()
+
+if not args.measure and not args.image:
+  parser.error('one of --measure or --image is required')
+
+def read_log(path):
+  """ K and print time (ms) of each line, by line number """
+  lines = {}
+  with open(path) as f:
+    for l in f:
+      m = re.search(r'G25 line:\s*(\d+)\s+K:\s*([-\d.]+)\s+ms:\s*(\d+)', l)
+      if m: lines[int(m.group(1))] = (float(m.group(2)), int(m.group(3)))
+  return lines
+
+def read_measure(path):
+  """ (accel, decel) width changes by line number """
+  rows = {}
+  with open(path) as f:
+    for l in f:
+      p = [x.strip() for x in l.split(',')]
+      if len(p) < 3 or not p[0].lstrip('-').isdigit(): continue
+      rows[int(p[0])] = (float(p[1]), float(p[2]))
+  return rows
+
+def read_image(path, count):
+  """ (accel, decel) width changes, in pixels, of the lines found in a photo """
+  from PIL import Image
+  img = Image.open(path).convert('L')
+  w, h = img.size
+  px = img.load()
+  # Threshold halfway between the darkest and brightest tenth of the pixels
+  values = sorted(img.getdata())
+  lo, hi = values[len(values) // 10], values[-len(values) // 10]
+  thr = (lo + hi) / 2.0
+  filament = (lambda v: v < thr) if args.invert else (lambda v: v > thr)
+
+  total = 2 * args.slow + args.fast
+  t1, t2 = int(w * args.slow / total), int(w * (args.slow + args.fast) / total)
+  win = max(2, int(w * 3 / total))  # 3mm after each speed change
+
+  def width(band, x0, x1):
+    """ Mean count of filament pixels per column in a band of rows """
+    cols = range(max(0, x0), min(w, x1))
+    return sum(sum(1 for y in band if filament(px[x, y])) for x in cols) / float(max(1, len(cols)))
+
+  rows, band_h = {}, h / float(count)
+  for i in range(count):
+    # Line 0 is the front line, at the bottom of the photo
+    band = range(int(h - (i + 1) * band_h), int(h - i * band_h))
+    fast = width(band, t1 + 3 * win, t2 - 3 * win)
+    slow = width(band, t2 + 3 * win, w - win)
+    rows[i] = (width(band, t1, t1 + win) - fast, width(band, t2, t2 + win) - slow)
+  return rows
+
+log = read_log(args.log) if args.log else {}
+if args.measure:
+  widths = read_measure(args.measure)
+else:
+  count = len(log) if log else None
+  if not count:
+    parser.error('--image needs --log to know the number of lines')
+  widths = read_image(args.image, count)
+
+points = []
+print(' line      K   print ms    accel    decel    score')
+for i in sorted(widths):
+  k, ms = log.get(i, (args.start + i * args.step, None))
+  accel, decel = widths[i]
+  score = decel - accel
+  points.append((k, score))
+  print('%5d %6.3f %10s %8.3f %8.3f %8.3f' % (i, k, ms if ms is not None else '-', accel, decel, score))
+
+if len(points) < 2:
+  raise SystemExit('Need at least two lines to pick K')
+
+# Least squares fit of the score against K
+n = float(len(points))
+mk = sum(k for k, _ in points) / n
+ms = sum(s for _, s in points) / n
+skk = sum((k - mk) ** 2 for k, _ in points)
+slope = sum((k - mk) * (s - ms) for k, s in points) / skk if skk else 0
+best = min(points, key=lambda p: abs(p[1]))[0]
+
+print()
+pick = best
+if slope < 0:
+  kz = mk - ms / slope
+  if min(k for k, _ in points) <= kz <= max(k for k, _ in points):
+    pick = kz
+    print('Best K: %.3f (fit), closest line K=%.3f' % (kz, best))
+  else:
+    print('Fit K %.3f is outside the printed range. Closest line K=%.3f. Widen the G25 K range.' % (kz, best))
+else:
+  # The score should fall as K rises. If it doesn't, the measurements are too noisy to fit.
+  print('No clear trend in the scores. Closest line K=%.3f' % best)
+print('Set it with M900 K%.3f' % pick)
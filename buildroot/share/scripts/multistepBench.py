@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+
+"""
+Compare the step pulse spacing of power-of-2 and fractional multistepping.
+
+Without --trace, builds a step pulse trace for each step rate using the
+Stepper ISR scheduling (timer ticks, steps per ISR, time between pulses
+in a group) and prints the pulse interval variation per step rate:
+
+  cv   - standard deviation of the pulse interval, in % of the mean
+  err  - largest distance of a pulse from its ideal time, in µs
+
+With --trace, reads a captured trace instead (one STEP rising edge time
+per line, in seconds, as exported by most logic analyzers) and prints
+the same figures for each step rate found in it.
+
+The cycle counts default to the Stepper ISR estimates in stepper.h for
+an AVR at 16MHz with S_CURVE_ACCELERATION and LIN_ADVANCE.
+"""
+
+import argparse
+import math
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('--min', type=float, default=2000, help='Lowest step rate in steps/s (default=2000)')
+parser.add_argument('--max', type=float, default=40000, help='Highest step rate in steps/s (default=40000)')
+parser.add_argument('--step', type=float, default=1000, help='Step rate increment (default=1000)')
+parser.add_argument('--bits', type=int, default=2, choices=(1, 2, 3), help='MULTISTEP_FRACTION_BITS (default=2)')
+parser.add_argument('--cpu', type=float, default=16e6, help='F_CPU in Hz (default=16000000)')
+parser.add_argument('--timer', type=float, default=2e6, help='Stepper timer rate in Hz (default=2000000)')
+parser.add_argument('--fixed-cycles', type=int, default=1032, help='ISR_FIXED_CYCLES (default=1032)')
+parser.add_argument('--loop-cycles', type=int, default=384, help='ISR_LOOP_CYCLES (default=384)')
+parser.add_argument('--steps', type=int, default=2000, help='Steps simulated per step rate (default=2000)')
+parser.add_argument('--trace', help='File of captured step times to analyze instead')
+args = parser.parse_args()
+
+def limit(group8):
+  """ Maximum step rate when stepping group8/8 steps per ISR """
+  return args.cpu * group8 / (args.fixed_cycles * 8 + args.loop_cycles * group8)
+
+def pow2_group(rate):
+  """ Steps per ISR, in 1/8 step, as chosen by calc_timer_interval() """
+  n = 1
+  while n < 128 and rate > limit(n * 8): n *= 2
+  return n * 8
+
+def fractional_group(rate):
+  """ Steps per ISR, in 1/8 step, as chosen with FRACTIONAL_MULTISTEPPING """
+  m_step = 8 >> args.bits
+  e = 0
+  while e < 7 and rate > limit((16 - m_step) << e): e += 1
+  m = 0
+  if e < 7:
+    while m < 8 - m_step and rate > limit((8 + m) << e): m += m_step
+  return (8 + m) << e
+
+def pulses(rate, group8):
+  """ Rising edge times of a run of steps at a constant rate """
+  ticks = max(1, round(args.timer * group8 / 8 / rate))
+  gap = args.loop_cycles / args.cpu
+  times, t, frac = [], 0.0, 0
+  while len(times) < args.steps:
+    frac += group8
+    n, frac = frac >> 3, frac & 7
+    times += [t + i * gap for i in range(n)]
+    t += ticks / args.timer
+  return times[:args.steps]
+
+def figures(times, rate):
+  """ Interval variation (%) and worst pulse time error (µs) """
+  iv = [b - a for a, b in zip(times, times[1:])]
+  mean = sum(iv) / len(iv)
+  sd = math.sqrt(sum((x - mean) ** 2 for x in iv) / len(iv))
+  err = max(abs(t - times[0] - i * mean) for i, t in enumerate(times))
+  return 100 * sd / mean, err * 1e6, 1 / mean
+
+if args.trace:
+  with open(args.trace) as f:
+    times = sorted(float(l.split(',')[0]) for l in f if l.strip() and not l[0].isalpha())
+  # Split the trace wherever the step rate changes by more than 10% over 64 steps
+  runs, start = [], 0
+  for i in range(64, len(times), 64):
+    a = (times[i] - times[i - 64]) / 64
+    b = (times[start + 64] - times[start]) / 64 if start + 64 < len(times) else a
+    if abs(a - b) > 0.1 * b:
+      runs.append(times[start:i - 64])
+      start = i - 64
+  runs.append(times[start:])
+  print('  steps/s   pulses     cv%   err µs')
+  for r in runs:
+    if len(r) < 32: continue
+    cv, err, rate = figures(r, 0)
+    print('%9.0f %8d %7.1f %8.1f' % (rate, len(r), cv, err))
+else:
+  print('  steps/s | power of 2: group  cv%   err µs | fractional: group  cv%   err µs')
+  rate = args.min
+  while rate <= args.max + args.step / 2:
+    row = '%9.0f |' % rate
+    for chooser in (pow2_group, fractional_group):
+      g = chooser(rate)
+      cv, err, _ = figures(pulses(rate, g), rate)
+      row += '  %17.3f %5.1f %8.1f |' % (g / 8.0, cv, err)
+    print(row)
+    rate += args.step
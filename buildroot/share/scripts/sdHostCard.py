@@ -0,0 +1,426 @@
+#!/usr/bin/env python3
+
+"""
+Host side SD card for the SD library scripts (sdLogTest.py, sdStreamBench.py).
+
+Builds Marlin's Sd2Card, SdVolume and SdBaseFile for the host. Their SPI
+registers are stubbed and connected to a card emulator, which answers the
+SPI mode commands Sd2Card sends and keeps its blocks in a card image file.
+The emulator also keeps a clock. The clock advances by one SPI byte time
+for every byte sent, at the rate set by SPCR/SPSR (1us at full speed with
+a 16MHz AVR), plus the card's delays:
+
+  access_us  from a read command to its first data block
+  gap_us     between the blocks of a multiple block read
+  busy_us    programming time after each written block
+  error_every  send an error token instead of every Nth streamed block
+
+millis() reads this clock, so Sd2Card's timeouts run on it too. AVR CPU
+time outside the SPI transfers isn't counted.
+
+make_image() writes a FAT16 card image with the given files and
+read_file() reads a file back from one.
+"""
+
+import os
+import shutil
+import struct
+import subprocess
+
+SD_SOURCES = ('Sd2Card.cpp', 'SdVolume.cpp', 'SdBaseFile.cpp')
+SD_HEADERS = ('Sd2Card.h', 'SdVolume.h', 'SdBaseFile.h', 'SdFatConfig.h', 'SdFatStructs.h', 'SdInfo.h')
+
+# Stands in for MarlinConfig.h. The SD library only needs a few macros,
+# the SPI registers and the pin functions.
+HOST_H = r"""
+#ifndef SDHOST_H
+#define SDHOST_H
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _CAT(a, ...) a ## __VA_ARGS__
+#define SWITCH_ENABLED_ 1
+#define SWITCH_ENABLED_1 1
+#define SWITCH_ENABLED_true 1
+#define ENABLED(b) _CAT(SWITCH_ENABLED_, b)
+#define DISABLED(b) !ENABLED(b)
+#define SDSUPPORT
+#define MAX_VFAT_ENTRIES (2)
+
+#define NOOP do{}while(0)
+#define _BV(b) (1 << (b))
+#define TEST(n, b) (((n) >> (b)) & 0x1)
+#define NOLESS(v, n) do{ if (v < n) v = n; }while(0)
+#define NOMORE(v, n) do{ if (v > n) v = n; }while(0)
+#define UNUSED(x) ((void)(x))
+#define WITHIN(V, L, H) ((V) >= (L) && (V) <= (H))
+#define FORCE_INLINE inline __attribute__((always_inline))
+#define PROGMEM
+#define PSTR(s) (s)
+#define PGM_P const char*
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define PENDING(NOW, SOON) (int32_t((NOW) - (SOON)) < 0) // long is 32 bits on the AVR
+#define ELAPSED(NOW, SOON) (!PENDING(NOW, SOON))
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define SET_INPUT(p) NOOP
+#define SET_OUTPUT(p) NOOP
+#define WRITE(p, v) NOOP
+#define SS_PIN 53
+#define SCK_PIN 52
+#define MOSI_PIN 51
+#define MISO_PIN 50
+#define SPR0 0
+#define SPR1 1
+#define SPI2X 0
+#define MSTR 4
+#define SPE 6
+#define SPIF 7
+
+typedef int8_t pin_t;
+typedef uint32_t millis_t;
+
+uint32_t millis();
+void pinMode(const pin_t pin, const uint8_t mode);
+void digitalWrite(const pin_t pin, const uint8_t value);
+
+// Writing SPDR clocks a byte out to the card and the card's byte in
+struct HostSpdr {
+  uint8_t rx;
+  HostSpdr& operator=(const uint8_t b);
+  operator uint8_t() const { return rx; }
+};
+struct HostReg {
+  uint8_t v;
+  HostReg& operator=(const uint8_t b) { v = b; return *this; }
+  operator uint8_t() const { return v; }
+};
+struct HostSpsr : HostReg {
+  using HostReg::operator=;
+  operator uint8_t() const { return v | _BV(SPIF); } // each transfer is done at once
+};
+extern HostSpdr SPDR;
+extern HostReg SPCR;
+extern HostSpsr SPSR;
+
+struct SdHost {
+  double access_us, gap_us, busy_us;  // Card delays, see sdHostCard.py
+  unsigned long error_every;          // Error token instead of every Nth streamed block
+  uint64_t ns;                        // Card clock
+  uint32_t ms_offset;                 // Added to millis(), to let time pass without SPI traffic
+  unsigned long commands[64],         // Commands received, by number
+                streamed, errors;     // Blocks sent by multiple block reads, error tokens sent
+};
+extern SdHost sd_host;
+
+bool sd_host_open(const char * const image);
+
+#endif
+"""
+
+MARLIN_H = r"""
+#include "MarlinConfig.h"
+#define DEC 10
+#define SERIAL_CHAR(x) NOOP
+#define SERIAL_ECHO(x) NOOP
+#define SERIAL_ECHO_F(x, y) NOOP
+#define SERIAL_EOL() NOOP
+"""
+
+HOST_CPP = r"""
+#include "MarlinConfig.h"
+#include <deque>
+
+SdHost sd_host = { 500, 50, 1500, 0 };
+HostSpdr SPDR;
+HostReg SPCR;
+HostSpsr SPSR;
+
+namespace {
+
+  FILE *image;
+  uint32_t image_blocks;
+  bool selected;
+
+  // Bytes for the card to send. A byte with a time is repeated for that long.
+  struct Item { uint8_t b; uint32_t ns; };
+  std::deque<Item> out;
+  const uint64_t NO_HOLD = ~0ULL;
+  uint64_t hold_start = NO_HOLD;
+
+  enum { CMD, WAIT_TOKEN, DATA } mode;
+  uint8_t cmd[6];
+  int8_t cmd_len = -1;
+  bool app_cmd, ready, multi_write, streaming, stream_first;
+  uint32_t block;
+  uint8_t data[514];
+  uint16_t data_len;
+
+  uint16_t crc16(const uint8_t *p, const uint16_t n) {
+    uint16_t crc = 0;
+    for (uint16_t i = 0; i < n; i++) {
+      crc ^= uint16_t(p[i]) << 8;
+      for (uint8_t b = 0; b < 8; b++) crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+  }
+
+  bool image_io(const uint32_t blk, uint8_t * const d, const bool write) {
+    if (blk >= image_blocks || fseek(image, long(blk) * 512, SEEK_SET)) return false;
+    return (write ? fwrite(d, 512, 1, image) : fread(d, 512, 1, image)) == 1;
+  }
+
+  void put(const uint8_t b) { out.push_back({ b, 0 }); }
+  void hold(const uint8_t b, const double us) { if (us > 0) out.push_back({ b, uint32_t(us * 1000) }); }
+  void r1(const uint8_t status) { put(0xFF); put(status); } // one byte of response delay, then R1
+
+  void put_data(const uint8_t *d, const uint16_t n) {
+    put(0xFE);
+    for (uint16_t i = 0; i < n; i++) put(d[i]);
+    const uint16_t crc = crc16(d, n);
+    put(crc >> 8);
+    put(crc & 0xFF);
+  }
+
+  void put_block(const uint32_t blk) {
+    uint8_t d[512];
+    if (image_io(blk, d, false)) put_data(d, 512); else put(0x08); // out of range error token
+  }
+
+  void next_stream_block() {
+    if (stream_first) stream_first = false; else hold(0xFF, sd_host.gap_us);
+    if (sd_host.error_every && ++sd_host.streamed % sd_host.error_every == 0) {
+      put(0x01); // error token ends the transfer
+      sd_host.errors++;
+      streaming = false;
+      return;
+    }
+    put_block(block++);
+  }
+
+  void command() {
+    const uint8_t c = cmd[0] & 0x3F;
+    const uint32_t arg = uint32_t(cmd[1]) << 24 | uint32_t(cmd[2]) << 16 | uint32_t(cmd[3]) << 8 | cmd[4];
+    const bool acmd = app_cmd;
+    app_cmd = false;
+    sd_host.commands[c]++;
+    out.clear();
+    hold_start = NO_HOLD;
+
+    if (c == 12) {  // STOP_TRANSMISSION: a stuff byte, R1, then a short busy
+      streaming = false;
+      put(0xFF);
+      r1(0);
+      hold(0x00, sd_host.gap_us);
+      return;
+    }
+    streaming = false;
+
+    const uint8_t idle = ready ? 0 : 1;
+    if (acmd) switch (c) {
+      case 41: ready = true; r1(0); return;
+      case 23: r1(0); return;
+      default: r1(0x04); return;
+    }
+    switch (c) {
+      case 0: ready = false; r1(1); break;
+      case 8: r1(idle); put(0); put(0); put((arg >> 8) & 0xF); put(arg & 0xFF); break;
+      case 55: app_cmd = true; r1(idle); break;
+      case 58: r1(idle); put(0xC0); put(0xFF); put(0x80); put(0x00); break; // SDHC, powered up
+      case 9: {                                                              // CSD version 2
+        uint8_t csd[16] = { 0x40 };
+        const uint32_t c_size = image_blocks / 1024 - 1;
+        csd[7] = (c_size >> 16) & 0x3F; csd[8] = c_size >> 8; csd[9] = c_size;
+        csd[10] = 0x40;                                                       // erase_blk_en
+        r1(0); hold(0xFF, sd_host.access_us); put_data(csd, 16);
+      } break;
+      case 10: { uint8_t cid[16] = { 0 }; r1(0); hold(0xFF, sd_host.access_us); put_data(cid, 16); } break;
+      case 13: r1(0); put(0); break;
+      case 17: r1(0); hold(0xFF, sd_host.access_us); put_block(arg); break;
+      case 18: r1(0); hold(0xFF, sd_host.access_us); block = arg; streaming = stream_first = true; break;
+      case 24: case 25: r1(0); block = arg; multi_write = c == 25; mode = WAIT_TOKEN; break;
+      case 32: case 33: r1(0); break;
+      case 38: r1(0); hold(0x00, sd_host.busy_us); break;
+      default: r1(0x04); break; // illegal command
+    }
+  }
+
+  void receive(const uint8_t b) {
+    if (mode == WAIT_TOKEN) {
+      if (b == (multi_write ? 0xFC : 0xFE)) { mode = DATA; data_len = 0; return; }
+      if (multi_write && b == 0xFD) { mode = CMD; put(0xFF); hold(0x00, sd_host.busy_us); return; }
+      if ((b & 0xC0) != 0x40) return;
+      mode = CMD; // a command ends the write
+    }
+    else if (mode == DATA) {
+      data[data_len++] = b;
+      if (data_len == sizeof(data)) {
+        put(image_io(block++, data, true) ? 0xE5 : 0xED); // accepted / write error. Sd2Card sends no CRC.
+        hold(0x00, sd_host.busy_us);
+        mode = multi_write ? WAIT_TOKEN : CMD;
+      }
+      return;
+    }
+    if (cmd_len < 0) {
+      if ((b & 0xC0) == 0x40) { cmd[0] = b; cmd_len = 1; }
+      return;
+    }
+    cmd[cmd_len++] = b;
+    if (cmd_len == 6) { cmd_len = -1; command(); }
+  }
+
+  uint8_t send() {
+    for (;;) {
+      if (out.empty()) {
+        if (!streaming) return 0xFF;
+        next_stream_block();
+        continue;
+      }
+      const Item &f = out.front();
+      if (!f.ns) { const uint8_t b = f.b; out.pop_front(); return b; }
+      if (hold_start == NO_HOLD) hold_start = sd_host.ns;
+      if (sd_host.ns - hold_start < f.ns) return f.b;
+      out.pop_front();
+      hold_start = NO_HOLD;
+    }
+  }
+
+}
+
+HostSpdr& HostSpdr::operator=(const uint8_t b) {
+  static const uint16_t divisor[] = { 4, 16, 64, 128 };
+  sd_host.ns += uint32_t(divisor[SPCR.v & 3] >> (SPSR.v & 1)) * 500; // 8 bits at 16MHz / divisor
+  if (!selected) { rx = 0xFF; return *this; }
+  rx = send();
+  receive(b);
+  return *this;
+}
+
+uint32_t millis() { return uint32_t(sd_host.ns / 1000000) + sd_host.ms_offset; }
+void pinMode(const pin_t, const uint8_t) {}
+void digitalWrite(const pin_t pin, const uint8_t value) {
+  if (pin != SS_PIN) return;
+  selected = !value;
+  if (!selected) cmd_len = -1;
+}
+
+bool sd_host_open(const char * const path) {
+  image = fopen(path, "r+b");
+  if (!image) return false;
+  fseek(image, 0, SEEK_END);
+  image_blocks = ftell(image) / 512;
+  return true;
+}
+"""
+
+
+def build(marlin, main_src, name, tmp, defines=(), cxx='g++'):
+  """Build the SD library and the emulator with main_src. Returns the program path."""
+  for f in SD_SOURCES + SD_HEADERS:
+    shutil.copy(os.path.join(marlin, f), tmp)
+  # The copies include these instead of Marlin's own
+  for f, text in (('MarlinConfig.h', HOST_H), ('Marlin.h', MARLIN_H), ('sdhost.cpp', HOST_CPP), (name + '.cpp', main_src)):
+    with open(os.path.join(tmp, f), 'w') as out:
+      out.write(text)
+  exe = os.path.join(tmp, name)
+  subprocess.check_call([cxx, '-O2', '-std=gnu++11', '-w', '-o', exe] + ['-D' + d for d in defines]
+                        + [os.path.join(tmp, f) for f in SD_SOURCES + ('sdhost.cpp', name + '.cpp')])
+  return exe
+
+
+def extract(src, name):
+  """A CardReader method definition from cardreader.cpp, found by brace matching."""
+  at = src.index('CardReader::%s(' % name)
+  start = src.rindex('\n', 0, at) + 1
+  depth, i = 0, src.index('{', at)
+  while True:
+    if src[i] == '{': depth += 1
+    elif src[i] == '}':
+      depth -= 1
+      if not depth: return src[start:i + 1] + '\n'
+    i += 1
+
+
+def short_name(name):
+  base, _, ext = name.upper().partition('.')
+  return base.ljust(8)[:8].encode() + ext.ljust(3)[:3].encode()
+
+
+def make_image(path, files, cluster_blocks=8):
+  """
+  Write a FAT16 image with no partition table. files is a list of
+  (name, data, fragmented). A fragmented file leaves a free cluster
+  after each of its clusters.
+  """
+  csize = cluster_blocks * 512
+  need = sum((len(d) + csize - 1) // csize * (2 if frag else 1) for _, d, frag in files)
+  clusters = max(4200, need + 64)                 # 4085 or more makes it FAT16
+  fat_blocks = ((clusters + 2) * 2 + 511) // 512
+  root_blocks = 32                                # 512 entries
+  data_start = 1 + 2 * fat_blocks + root_blocks
+  total = data_start + clusters * cluster_blocks
+
+  boot = bytearray(512)
+  boot[0:3] = b'\xEB\x3C\x90'
+  boot[3:11] = b'MARLIN  '
+  struct.pack_into('<HBHBHHBHHHII', boot, 11, 512, cluster_blocks, 1, 2, 512, 0, 0xF8, fat_blocks, 32, 64, 0, total)
+  struct.pack_into('<BBBI11s8s', boot, 36, 0x80, 0, 0x29, 0x12345678, b'NO NAME    ', b'FAT16   ')
+  boot[510:512] = b'\x55\xAA'
+
+  fat = [0] * (clusters + 2)
+  fat[0], fat[1] = 0xFFF8, 0xFFFF
+  root = bytearray(root_blocks * 512)
+  image = {}
+  nxt = 2
+  for n, (name, data, frag) in enumerate(files):
+    chain = []
+    for off in range(0, len(data), csize):
+      chain.append(nxt)
+      image[nxt] = data[off:off + csize]
+      nxt += 2 if frag else 1
+    for a, b in zip(chain, chain[1:] + [0xFFFF]): fat[a] = b
+    struct.pack_into('<11sB10xHHHI', root, n * 32, short_name(name), 0x20, 0, 0x21, chain[0] if chain else 0, len(data))
+
+  fat_bytes = struct.pack('<%dH' % len(fat), *fat)
+  with open(path, 'wb') as f:
+    f.truncate(total * 512)
+    f.write(boot)
+    for i in range(2):
+      f.seek((1 + i * fat_blocks) * 512)
+      f.write(fat_bytes)
+    f.seek((1 + 2 * fat_blocks) * 512)
+    f.write(root)
+    for c, data in image.items():
+      f.seek((data_start + (c - 2) * cluster_blocks) * 512)
+      f.write(data)
+
+
+def read_file(path, name):
+  """A file's contents, from the root directory of a FAT16 image, or None."""
+  with open(path, 'rb') as f:
+    img = f.read()
+  bps, spc, reserved, nfats, root_entries = struct.unpack_from('<HBHBH', img, 11)
+  fat_blocks = struct.unpack_from('<H', img, 22)[0]
+  fat = reserved * bps
+  root = fat + nfats * fat_blocks * bps
+  data_start = root + root_entries * 32
+  for e in range(root_entries):
+    entry = img[root + e * 32:root + e * 32 + 32]
+    if entry[0] == 0: break
+    if entry[0] == 0xE5 or entry[11] & 0x18 or entry[:11] != short_name(name): continue
+    cluster, size = struct.unpack_from('<HI', entry, 26)
+    data = bytearray()
+    while 2 <= cluster < 0xFFF8 and len(data) < size:
+      off = data_start + (cluster - 2) * spc * bps
+      data += img[off:off + spc * bps]
+      cluster = struct.unpack_from('<H', img, fat + cluster * 2)[0]
+    return bytes(data[:size])
+  return None
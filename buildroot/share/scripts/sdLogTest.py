@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+
+"""
+Test the SD_LOG_BUFFER M928 log against a card image.
+
+Builds CardReader's openLogFile, write_command, bufferedWrite,
+flushWriteBuffer, manageLog and closefile from Marlin/cardreader.cpp, with
+the open flags of openFile's write branch, over the SD library and the
+card emulator in sdHostCard.py. The program logs random lines, some with
+line numbers and checksums, and calls manageLog() after each line as
+idle() does. Most lines come with pauses now and then. One long run has
+no pauses, so only SD_LOG_SYNC_INTERVAL writes it out. Each time
+manageLog() writes the log out, the file is read back from the card and
+compared with the lines logged so far. At the end the log is closed and
+the image is checked again from here, byte for byte.
+
+Needs a host C++ compiler.
+
+Example:
+  sdLogTest.py
+  sdLogTest.py --lines 20000 --seed 7
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+import sdHostCard
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('--marlin', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', '..', 'Marlin'),
+                    help='Marlin source folder (default=the one in this repository)')
+parser.add_argument('--lines', type=int, default=5000, help='Lines to log (default=5000)')
+parser.add_argument('--seed', type=int, default=1, help='Random seed (default=1)')
+parser.add_argument('--cxx', default='g++', help='Host C++ compiler (default=g++)')
+args = parser.parse_args()
+
+# The CardReader members the log code uses
+PRE = r"""
+#include "SdBaseFile.h"
+#include <string>
+
+#define SERIAL_PROTOCOLPAIR(a, b) NOOP
+#define SERIAL_PROTOCOLCHAR(a) NOOP
+#define SERIAL_PROTOCOLLNPAIR(a, b) NOOP
+#define SERIAL_EOL() NOOP
+#define SERIAL_ERROR_START() NOOP
+#define SERIAL_ERRORLNPGM(s) (errors++)
+#define MSG_SD_ERR_WRITE_TO_FILE ""
+#define lcd_setstatus(s) NOOP
+
+static unsigned errors;
+static SdBaseFile root;
+
+struct HostFile : SdBaseFile {
+  using SdBaseFile::write;
+  int16_t write(const char *s) { return write(s, strlen(s)); }
+};
+
+class CardReader {
+public:
+  HostFile file;
+  bool saving, logging;
+  uint8_t write_buffer[512];
+  uint16_t write_buffer_count;
+  bool log_pending;
+  millis_t log_pending_ms, log_write_ms;
+
+  void openFile(char * const path, const bool read);
+  void openLogFile(char * const path);
+  void write_command(char *buf);
+  void closefile(const bool store_location=false);
+  bool bufferedWrite(const uint8_t *data, const uint16_t len);
+  bool flushWriteBuffer(const bool keep_partial=false);
+  void manageLog();
+};
+
+// openFile's write branch
+void CardReader::openFile(char * const path, const bool) {
+  if (file.open(&root, path, OPEN_FLAGS)) saving = true; else errors++;
+}
+"""
+
+MAIN = r"""
+static std::string logged;
+
+// Compare the file on the card with the lines logged so far
+static bool check(const char * const when) {
+  SdBaseFile f;
+  if (!f.open(&root, "LOG.TXT", O_READ)) { printf("%s: can't open the log\n", when); return false; }
+  std::string got;
+  char buf[512];
+  for (int16_t n; (n = f.read(buf, sizeof(buf))) > 0;) got.append(buf, n);
+  f.close();
+  if (got == logged) return true;
+  size_t i = 0;
+  while (i < got.size() && i < logged.size() && got[i] == logged[i]) i++;
+  printf("%s: the card has %u bytes, %u were logged, first difference at %u\n", when, unsigned(got.size()), unsigned(logged.size()), unsigned(i));
+  return false;
+}
+
+int main(int argc, char **argv) {
+  const unsigned lines = atoi(argv[2]);
+  srand(atoi(argv[3]));
+
+  Sd2Card sd;
+  SdVolume volume;
+  if (!sd_host_open(argv[1]) || !sd.init() || !volume.init(&sd) || !root.openRoot(&volume)) {
+    puts("Card init failed");
+    return 1;
+  }
+
+  CardReader card;
+  char name[] = "LOG.TXT";
+  card.openLogFile(name);
+  if (!card.logging || !card.saving) return 1;
+
+  unsigned flushes = 0;
+  for (unsigned i = 0; i < lines; i++) {
+    char cmd[128], line[128];
+    const int len = rand() % 90;
+    for (int j = 0; j < len; j++) cmd[j] = " GMXYZE0123456789."[rand() % 18];
+    cmd[len] = '\0';
+    if (rand() % 4)
+      strcpy(line, cmd);
+    else {
+      uint8_t sum = 0;
+      sprintf(line, "N%u %s", i, cmd);
+      for (char *c = line; *c; c++) sum ^= *c;
+      sprintf(line + strlen(line), "*%u", sum);
+    }
+    logged += cmd;
+    logged += "\r\n";
+    card.write_command(line);
+
+    // Time between lines, with a pause now and then. The third quarter has
+    // no pauses, so only SD_LOG_SYNC_INTERVAL writes it out.
+    const bool steady = i >= lines / 2 && i < lines * 3 / 4;
+    sd_host.ms_offset += steady || rand() % 20 ? rand() % 200 : SD_LOG_FLUSH_DELAY + rand() % 2000;
+    const bool pending = card.log_pending;
+    card.manageLog();
+    if (pending && !card.log_pending) {
+      flushes++;
+      char when[40];
+      sprintf(when, "After line %u", i + 1);
+      if (!check(when)) return 1;
+    }
+  }
+  card.closefile();
+  if (!check("After closing")) return 1;
+  if (errors) { printf("%u write errors\n", errors); return 1; }
+  printf("%u lines, %u bytes, written out %u times, all read back\n", lines, unsigned(logged.size()), flushes);
+
+  FILE *f = fopen(argv[4], "wb");
+  fwrite(logged.data(), 1, logged.size(), f);
+  fclose(f);
+  return 0;
+}
+"""
+
+with open(os.path.join(args.marlin, 'cardreader.cpp')) as f:
+  cardreader = f.read()
+with open(os.path.join(args.marlin, 'Configuration_adv.h')) as f:
+  adv = f.read()
+
+flags = re.search(r'else { //write\s+if \(!file\.open\(curDir, fname, ([^)]+)\)\)', cardreader).group(1)
+defines = ['SD_LOG_BUFFER', 'OPEN_FLAGS=' + flags.replace(' ', '')]
+for name in ('SD_LOG_FLUSH_DELAY', 'SD_LOG_SYNC_INTERVAL'):
+  defines.append('%s=%s' % (name, re.search(r'#define %s\s+(\d+)' % name, adv).group(1)))
+
+source = '\n'.join([PRE] + [sdHostCard.extract(cardreader, n) for n in
+  ('openLogFile', 'write_command', 'closefile', 'bufferedWrite', 'flushWriteBuffer', 'manageLog')] + [MAIN])
+
+with tempfile.TemporaryDirectory() as tmp:
+  image, expect = os.path.join(tmp, 'card.img'), os.path.join(tmp, 'expect.txt')
+  sdHostCard.make_image(image, [])
+  exe = sdHostCard.build(args.marlin, source, 'logtest', tmp, defines, args.cxx)
+  print('Open flags: ' + flags)
+  if subprocess.call([exe, image, str(args.lines), str(args.seed), expect]): sys.exit('FAIL')
+
+  # Check the closed image independently of the SD library
+  with open(expect, 'rb') as f:
+    logged = f.read()
+  got = sdHostCard.read_file(image, 'LOG.TXT')
+  if got != logged: sys.exit('FAIL: LOG.TXT in the image differs from the lines logged')
+  print('PASS')
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+
+"""
+Benchmark SD_STREAMING_READS against single block reads on a card image.
+
+Writes a FAT16 card image with the same G-code file stored twice, once in
+contiguous clusters and once with a free cluster after each of its
+clusters. Then builds Marlin's SD library over the card emulator in
+sdHostCard.py, once with single block reads (CMD17) and once with
+SD_STREAMING_READS (CMD18), and reads each file a byte at a time with
+SdBaseFile::read(), as CardReader::get() does. The streaming build is run
+again with error tokens in place of some streamed blocks, so the fallback
+to a single block read is timed too.
+
+For each run it prints the throughput, the longest single read() call and
+the card commands sent. Times are on the emulator's clock: SPI transfers
+at full speed plus the card delays given below. The data read is checked
+against the file.
+
+Needs a host C++ compiler.
+
+Example:
+  sdStreamBench.py
+  sdStreamBench.py --size 4096 --access-us 1500 --cluster-blocks 8
+"""
+
+import argparse
+import os
+import random
+import subprocess
+import tempfile
+
+import sdHostCard
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('--marlin', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', '..', 'Marlin'),
+                    help='Marlin source folder (default=the one in this repository)')
+parser.add_argument('--size', type=int, default=1024, help='File size in KB (default=1024)')
+parser.add_argument('--cluster-blocks', type=int, default=64, help='Blocks per cluster (default=64, 32KB)')
+parser.add_argument('--access-us', type=float, default=500, help='Read command to first data block, us (default=500)')
+parser.add_argument('--gap-us', type=float, default=50, help='Between streamed blocks, us (default=50)')
+parser.add_argument('--error-every', type=int, default=100, help='Streamed blocks per error token in the error runs (default=100)')
+parser.add_argument('--cxx', default='g++', help='Host C++ compiler (default=g++)')
+args = parser.parse_args()
+
+MAIN = r"""
+#include "SdBaseFile.h"
+
+int main(int argc, char **argv) {
+  sd_host.access_us = atof(argv[2]);
+  sd_host.gap_us = atof(argv[3]);
+  sd_host.error_every = atol(argv[4]);
+
+  Sd2Card sd;
+  SdVolume volume;
+  SdBaseFile root;
+  if (!sd_host_open(argv[1]) || !sd.init() || !volume.init(&sd) || !root.openRoot(&volume)) {
+    puts("Card init failed");
+    return 1;
+  }
+
+  for (int i = 5; i + 1 < argc; i += 2) {
+    FILE *f = fopen(argv[i + 1], "rb");
+    SdBaseFile file;
+    if (!f || !file.open(&root, argv[i], O_READ)) return 1;
+    #if ENABLED(SD_STREAMING_READS)
+      file.stream(true);
+    #endif
+
+    memset(sd_host.commands, 0, sizeof(sd_host.commands));
+    sd_host.errors = 0;
+    const uint64_t start = sd_host.ns;
+    uint64_t worst = 0;
+    uint32_t bytes = 0;
+    for (;;) {
+      const uint64_t t = sd_host.ns;
+      const int16_t c = file.read();
+      NOLESS(worst, sd_host.ns - t);
+      if (c != getc(f)) { printf("%s: wrong data at %lu\n", argv[i], (unsigned long)bytes); return 1; }
+      if (c < 0) break;
+      bytes++;
+    }
+    const double secs = (sd_host.ns - start) * 1e-9;
+    printf("%-10s %9.1f %9.0f %7lu %7lu %7lu %7lu\n", argv[i], bytes / secs / 1024, worst * 1e-3,
+      sd_host.commands[17], sd_host.commands[18], sd_host.commands[12], sd_host.errors);
+    file.close();
+    fclose(f);
+  }
+  return 0;
+}
+"""
+
+# G-code-like text
+random.seed(1)
+lines, size = [], 0
+while size < args.size * 1024:
+  line = 'G1 X%.3f Y%.3f E%.5f\n' % (random.uniform(0, 200), random.uniform(0, 200), random.uniform(0, 1))
+  lines.append(line)
+  size += len(line)
+gcode = ''.join(lines).encode()[:args.size * 1024]
+
+with tempfile.TemporaryDirectory() as tmp:
+  image, data = os.path.join(tmp, 'card.img'), os.path.join(tmp, 'data.gco')
+  sdHostCard.make_image(image, [('CONTIG.GCO', gcode, False), ('FRAG.GCO', gcode, True)], args.cluster_blocks)
+  with open(data, 'wb') as f:
+    f.write(gcode)
+
+  print('%d KB file, %d KB clusters, %.0fus access, %.0fus between streamed blocks'
+        % (args.size, args.cluster_blocks // 2, args.access_us, args.gap_us))
+  print('%-26s %-10s %9s %9s %7s %7s %7s %7s' % ('', 'file', 'KB/s', 'worst us', 'CMD17', 'CMD18', 'CMD12', 'errors'))
+  for label, defines, errors in (('single block reads', [], 0),
+                                 ('SD_STREAMING_READS', ['SD_STREAMING_READS'], 0),
+                                 ('  error every %d blocks' % args.error_every, ['SD_STREAMING_READS'], args.error_every)):
+    build = os.path.join(tmp, 'stream' if defines else 'single')
+    exe = build if os.path.exists(build) else sdHostCard.build(args.marlin, MAIN, os.path.basename(build), tmp, defines, args.cxx)
+    out = subprocess.check_output([exe, image, str(args.access_us), str(args.gap_us), str(errors),
+                                   'CONTIG.GCO', data, 'FRAG.GCO', data]).decode()
+    for i, row in enumerate(out.splitlines()):
+      print('%-26s %s' % ('' if i else label, row))
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+
+"""
+Benchmark the UBL_CELL_GRADIENTS move splitter against the original one.
+
+Takes both versions of unified_bed_leveling::line_to_destination_cartesian
+from Marlin/ubl_motion.cpp (the original is the #else branch), with the
+helpers they use from ubl.h and ubl.cpp, and builds them into a host
+program with stubs for the planner and serial output. The program
+
+  - sends the same 20000 move random walk on a random 10x10 mesh through
+    both and prints the largest difference between the segments made
+  - times each one over a longer walk and prints segments per second
+
+Needs a host C++ compiler. Host timings only show the relative gain. The
+AVR has no FPU, so the divides that were removed cost it far more.
+
+Example:
+  ublGradientBench.py
+  ublGradientBench.py --moves 500000 --cxx clang++
+"""
+
+import argparse
+import os
+import subprocess
+import tempfile
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('--marlin', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', '..', 'Marlin'),
+                    help='Marlin source folder (default=the one in this repository)')
+parser.add_argument('--moves', type=int, default=2000000, help='Moves in the timed walk (default=2000000)')
+parser.add_argument('--cxx', default='g++', help='Host C++ compiler (default=g++)')
+args = parser.parse_args()
+
+# Settings and stubs for the extracted code
+PRE = r"""
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+using std::isnan;
+using std::isinf;
+
+#define X_AXIS 0
+#define Y_AXIS 1
+#define Z_AXIS 2
+#define E_CART 3
+#define XYZE 4
+#define GRID_MAX_POINTS_X 10
+#define GRID_MAX_POINTS_Y 10
+#define MESH_MIN_X 1.0f
+#define MESH_MIN_Y 1.0f
+#define MESH_MAX_X 209.0f
+#define MESH_MAX_Y 209.0f
+#define MESH_X_DIST ((MESH_MAX_X - MESH_MIN_X) / (GRID_MAX_POINTS_X - 1))
+#define MESH_Y_DIST ((MESH_MAX_Y - MESH_MIN_Y) / (GRID_MAX_POINTS_Y - 1))
+#define WITHIN(V,L,H) ((V) >= (L) && (V) <= (H))
+#define ABS(a) ((a)<0?-(a):(a))
+#define MIN(a,b) ((a)<(b)?(a):(b))
+#define constrain(v,l,h) ((v)<(l)?(l):(v)>(h)?(h):(v))
+#define FORCE_INLINE inline
+#define ENABLED(X) 0
+#define SERIAL_ECHOPAIR(a,b)
+#define SERIAL_CHAR(a)
+#define SERIAL_EOL()
+#define PSTR(s) s
+#define COPY(a,b) memcpy(a,b,sizeof(a))
+
+static bool g26_debug_flag = false;
+static void debug_current_and_destination(const char*) {}
+static float current_position[4], destination[4];
+static void set_current_from_destination() { COPY(current_position, destination); }
+
+struct Seg { float x, y, z, e; };
+static std::vector<Seg> segs;
+static bool record = true;
+static unsigned long nseg = 0;
+static float sink = 0;
+
+struct P {
+  float fade = 1;
+  float fade_scaling_factor_for_z(const float &) { return fade; }
+  bool buffer_segment(const float &x, const float &y, const float &z, const float &e, const float &, const uint8_t) {
+    nseg++;
+    sink += x + y + z + e;
+    if (record) segs.push_back({ x, y, z, e });
+    return true;
+  }
+} planner;
+
+typedef struct { float z0, dx, dy, dxy; } cell_gradient_t;
+static cell_gradient_t gradients[GRID_MAX_POINTS_X - 1][GRID_MAX_POINTS_Y - 1];
+static bool gradients_valid;
+static float z_values[GRID_MAX_POINTS_X][GRID_MAX_POINTS_Y];
+static float mesh_index_to_xpos(const uint8_t i) { return MESH_MIN_X + i * (MESH_X_DIST); }
+static float mesh_index_to_ypos(const uint8_t i) { return MESH_MIN_Y + i * (MESH_Y_DIST); }
+static int8_t get_cell_index_x(const float &x) { const int8_t cx = (x - (MESH_MIN_X)) * (1.0f / (MESH_X_DIST)); return constrain(cx, 0, (GRID_MAX_POINTS_X) - 1); }
+static int8_t get_cell_index_y(const float &y) { const int8_t cy = (y - (MESH_MIN_Y)) * (1.0f / (MESH_Y_DIST)); return constrain(cy, 0, (GRID_MAX_POINTS_Y) - 1); }
+"""
+
+# The walk, the comparison and the timing
+MAIN = r"""
+static void walk(const bool use_new, const unsigned n, const unsigned seed) {
+  srand(seed);
+  current_position[0] = current_position[1] = 105; current_position[2] = 0.2; current_position[3] = 0;
+  for (unsigned i = 0; i < n; i++) {
+    destination[0] = current_position[0] + (rand() % 2001 - 1000) * 0.05f;
+    destination[1] = current_position[1] + (rand() % 2001 - 1000) * 0.05f;
+    destination[0] = constrain(destination[0], 2.0f, 208.0f); // constrain() is a macro
+    destination[1] = constrain(destination[1], 2.0f, 208.0f);
+    destination[2] = current_position[2];
+    destination[3] = current_position[3] + 1;
+    if (use_new) U::line_new(50, 0); else U::line_old(50, 0);
+  }
+}
+
+int main(int argc, char **argv) {
+  const unsigned moves = argc > 1 ? atoi(argv[1]) : 2000000;
+
+  srand(1);
+  for (int x = 0; x < GRID_MAX_POINTS_X; x++)
+    for (int y = 0; y < GRID_MAX_POINTS_Y; y++)
+      z_values[x][y] = (rand() % 1000 - 500) * 0.001f;
+  U::update_gradients();
+
+  segs.clear(); walk(false, 20000, 7); const std::vector<Seg> a = segs;
+  segs.clear(); walk(true, 20000, 7); const std::vector<Seg> b = segs;
+  printf("original %zu segments, cached gradients %zu segments\n", a.size(), b.size());
+  float maxd = 0, maxz = 0;
+  for (size_t i = 0; i < MIN(a.size(), b.size()); i++) {
+    maxd = fmaxf(maxd, fmaxf(fmaxf(fabsf(a[i].x - b[i].x), fabsf(a[i].y - b[i].y)), fabsf(a[i].e - b[i].e)));
+    maxz = fmaxf(maxz, fabsf(a[i].z - b[i].z));
+  }
+  printf("largest XYE difference %g, largest Z difference %g\n", maxd, maxz);
+
+  record = false;
+  for (int k = 0; k < 2; k++) {
+    nseg = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    walk(k, moves, 3);
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("%s: %lu segments in %.3f s = %.0f segments/s\n", k ? "cached gradients" : "original", nseg, s, nseg / s);
+  }
+  return sink == 12345; // Keep the results alive
+}
+"""
+
+def read(name):
+  with open(os.path.join(args.marlin, name)) as f:
+    return f.read()
+
+def block(s, i):
+  """ The {...} block that starts at the first brace after s[i] """
+  k = s.index('{', i)
+  depth = 0
+  for j in range(k, len(s)):
+    if s[j] == '{': depth += 1
+    elif s[j] == '}':
+      depth -= 1
+      if depth == 0: return s[k:j + 1]
+  raise SystemExit('Unbalanced braces')
+
+motion, ubl_h, ubl_cpp = read('ubl_motion.cpp'), read('ubl.h'), read('ubl.cpp')
+
+sig = 'void unified_bed_leveling::line_to_destination_cartesian(const float &feed_rate, const uint8_t extruder)'
+i_new = motion.index(sig)
+i_old = motion.index(sig, i_new + len(sig))
+
+def helper(name):
+  """ A static copy of an inline member from ubl.h """
+  i = ubl_h.index(name)
+  return 'static ' + name + ubl_h[i + len(name):ubl_h.index('{', i)] + block(ubl_h, i)
+
+helpers = [helper(n) for n in ('float z_correction_for_x_on_horizontal_mesh_line',
+                               'float z_correction_for_y_on_vertical_mesh_line',
+                               'float cell_z_correction')]
+
+source = '\n'.join([PRE, 'struct U {'] + helpers + [
+  'static void update_gradients()' + block(ubl_cpp, ubl_cpp.index('void unified_bed_leveling::update_gradients()')),
+  'static void line_new(const float &feed_rate, const uint8_t extruder)' + block(motion, i_new),
+  'static void line_old(const float &feed_rate, const uint8_t extruder)' + block(motion, i_old),
+  '};', MAIN])
+
+with tempfile.TemporaryDirectory() as tmp:
+  src, exe = os.path.join(tmp, 'bench.cpp'), os.path.join(tmp, 'bench')
+  with open(src, 'w') as f:
+    f.write(source)
+  subprocess.check_call([args.cxx, '-std=c++11', '-O2', '-w', '-o', exe, src])
+  subprocess.check_call([exe, str(args.moves)])